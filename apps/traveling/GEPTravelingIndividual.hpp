@@ -8,10 +8,14 @@
 #ifndef __GEPTravelingIndividual_hpp__
 #define __GEPTravelingIndividual_hpp__
 
+#include <GEPCoreNeighbourhood.hpp>
 #include <GEPCoreRingIndividual.hpp>
 #include <GEPRandom.hpp>
 #include <GEPVec2d.hpp>
 
+#include <QtCore/QtGlobal>
+
+#include <algorithm>
 #include <vector>
 
 namespace GEP {
@@ -35,8 +39,124 @@ namespace GEP {
     };
 
     
+    /*
+     * Precomputed distances between all cities
+     *
+     * The distances are stored either as full matrix with cache line aligned
+     * rows or as lower triangular matrix taking half the memory, each in
+     * single or double precision.
+     */
+    class DistanceMatrix
+    {
+    public:
+      enum Precision_t { FLOAT, DOUBLE };
+      enum Layout_t { FULL, TRIANGULAR };
+
+    public:
+      DistanceMatrix (const std::vector<City>& cities,
+		      Precision_t precision, Layout_t layout);
+      ~DistanceMatrix ();
+
+      inline double get (unsigned int city_1, unsigned int city_2) const;
+
+      static quint64 computeMemory (unsigned int number_of_cities,
+				    Precision_t precision, Layout_t layout);
+
+    private:
+      inline quint64 getIndex (unsigned int city_1,
+			       unsigned int city_2) const;
+
+      DistanceMatrix (const DistanceMatrix& toCopy);
+      const DistanceMatrix& operator= (const DistanceMatrix& toCopy);
+
+    private:
+      Precision_t _precision;
+      Layout_t _layout;
+      unsigned int _row_size;
+
+      void* _data;
+      const float* _floats;
+      const double* _doubles;
+    };
+
+    /*
+     * Uniform grid over the city positions
+     *
+     * The cities are sorted into square cells holding about two cities each,
+     * so nearest neighbour queries only visit the cells around the query
+     * point. The grid is built in O(n) and can be queried by several threads
+     * at once.
+     */
+    class SpatialGrid
+    {
+    public:
+      SpatialGrid (const std::vector<City>& cities);
+      ~SpatialGrid ();
+
+      void findNearest (unsigned int city, unsigned int number_of_neighbours,
+			std::vector<unsigned int>* neighbours) const;
+
+    private:
+      unsigned int getCell (double coordinate, double min,
+			    unsigned int size) const;
+
+      SpatialGrid (const SpatialGrid& toCopy);
+      const SpatialGrid& operator= (const SpatialGrid& toCopy);
+
+    private:
+      const std::vector<City>& _cities;
+
+      double _min_x;
+      double _min_y;
+      double _cell_size;
+      unsigned int _columns;
+      unsigned int _rows;
+
+      std::vector<unsigned int> _cell_begin;
+      std::vector<unsigned int> _cell_cities;
+    };
+
+
+    class World;
+
+    /*
+     * Lists of the nearest neighbours of each city
+     *
+     * The lists are computed in parallel threads via a spatial grid and are
+     * sorted by increasing distance. Moves restricted to these candidate
+     * edges keep operators and local search fast for large worlds.
+     */
+    class CandidateLists : public GEP::Core::Neighbourhood
+    {
+    public:
+      CandidateLists (const World* world, const std::vector<City>& cities,
+		      unsigned int number_of_neighbours);
+      virtual ~CandidateLists ();
+
+      virtual unsigned int getNumberOfGenes () const;
+      virtual unsigned int getNumberOfNeighbours () const;
+      virtual const unsigned int* getNeighbours (unsigned int gene) const;
+
+      virtual double getCost (unsigned int gene_1, unsigned int gene_2) const;
+
+    private:
+      CandidateLists (const CandidateLists& toCopy);
+      const CandidateLists& operator= (const CandidateLists& toCopy);
+
+    private:
+      const World* _world;
+      unsigned int _number_of_cities;
+      unsigned int _number_of_neighbours;
+      std::vector<unsigned int> _neighbours;
+    };
+
+
     /*
      * Class describing the traveling salesmans world
+     *
+     * Distances are taken from a precomputed matrix as long as it fits into
+     * the given memory limit. Otherwise they are computed on the fly, using a
+     * small per thread cache of recently used edges.
      */
     class World
     {
@@ -45,15 +165,36 @@ namespace GEP {
       static const double MAX_COORDINATE;
 
     public:
-      World (unsigned int number_of_cities);
+      World (unsigned int number_of_cities,
+	     DistanceMatrix::Precision_t precision=DistanceMatrix::DOUBLE,
+	     DistanceMatrix::Layout_t layout=DistanceMatrix::FULL,
+	     unsigned int max_matrix_megabytes=512,
+	     unsigned int number_of_neighbours=10);
+      ~World ();
 
       inline unsigned int size () const { return _cities.size (); }
       const City& operator[] (unsigned int index) const;
+
+      inline bool hasDistanceMatrix () const;
+      inline double getDistance (unsigned int city_1,
+				 unsigned int city_2) const;
+
+      inline const CandidateLists* getCandidateLists () const;
       
+    private:
+      double computeDistance (unsigned int city_1, unsigned int city_2) const;
+
+      World (const World& toCopy);
+      const World& operator= (const World& toCopy);
+
     private:
       typedef std::vector<City> Cities;
       Cities _cities;
 
+      DistanceMatrix* _distances;
+      CandidateLists* _candidates;
+      unsigned int _id;
+
       Random _random;
     };
 
@@ -73,11 +214,14 @@ namespace GEP {
       inline const World* getWorld () const;
       inline double getDistance () const;
 
-      double computeDistance ();
+      double computeDistance () const;
       
+    private:
+      double computePathDistance () const;
+      bool computeDistanceChange (double* change) const;
+
     private:
       const World* _world;
-      double _distance;
     };
 
     
@@ -91,6 +235,56 @@ namespace GEP {
       return _point;
     }
 
+    /* Return the storage index of the distance between two cities */
+    inline quint64 DistanceMatrix::getIndex (unsigned int city_1,
+					     unsigned int city_2) const
+    {
+      if (_layout == FULL)
+	return static_cast<quint64> (city_1) * _row_size + city_2;
+
+      if (city_1 < city_2)
+	std::swap (city_1, city_2);
+
+      return static_cast<quint64> (city_1) * (city_1 - 1) / 2 + city_2;
+    }
+
+    /* Return the distance between two cities */
+    inline double DistanceMatrix::get (unsigned int city_1,
+				       unsigned int city_2) const
+    {
+      if (_layout == TRIANGULAR && city_1 == city_2)
+	return 0.0;
+
+      quint64 index = getIndex (city_1, city_2);
+      return _precision == FLOAT ? _floats[index] : _doubles[index];
+    }
+
+    /* Return if the distances are precomputed */
+    inline bool World::hasDistanceMatrix () const
+    {
+      return _distances != 0;
+    }
+
+    /*
+     * Return the distance between two cities
+     *
+     * The city indices are not checked for performance reasons.
+     */
+    inline double World::getDistance (unsigned int city_1,
+				      unsigned int city_2) const
+    {
+      if (_distances != 0)
+	return _distances->get (city_1, city_2);
+
+      return computeDistance (city_1, city_2);
+    }
+
+    /* Return the nearest neighbour lists, 0 if there are none */
+    inline const CandidateLists* World::getCandidateLists () const
+    {
+      return _candidates;
+    }
+
     /* Return the world belonging to this route */
     inline const World* Route::getWorld () const
     {
@@ -100,7 +294,7 @@ namespace GEP {
     /* Return the last computed distance of this route */
     inline double Route::getDistance () const
     {
-      return _distance;
+      return getObjective ();
     }
     
   } // namespace Traveling
@@ -0,0 +1,466 @@
+/*
+ * test_traveling_individual.cpp - Tests for the traveling salesman
+ *                                 individuals
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#define _DEBUG
+
+#include "GEPTravelingIndividual.hpp"
+
+#include <GEPCoreEvaluationCache.hpp>
+#include <GEPCorePopulation.hpp>
+#include <GEPCoreRingIndividual.hpp>
+#include <GEPDebug.hpp>
+#include <GEPException.hpp>
+#include <GEPRandom.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <math.h>
+
+//
+// Number of cities of the test world
+//
+#define NUMBER_OF_CITIES 200
+
+namespace GEP {
+  namespace Traveling {
+
+    //#***********************************************************************
+    // CLASS GEP::Traveling::TestPopulation
+    //#***********************************************************************
+
+    class TestPopulation : public GEP::Core::Population
+    {
+    public:
+      TestPopulation ();
+      virtual ~TestPopulation ();
+
+      virtual void computeFitness () const;
+    };
+
+    TestPopulation::TestPopulation ()
+      : Population ()
+    {
+    }
+
+    TestPopulation::~TestPopulation ()
+    {
+    }
+
+    void TestPopulation::computeFitness () const
+    {
+    }
+
+
+    //#***********************************************************************
+    // Test functions
+    //#***********************************************************************
+
+    /*
+     * Sum up the route distance without using the change log
+     */
+    static double computeFullDistance (const Route& route)
+    {
+      const Route::Chromosome& cities = route.getChromosome ();
+      double distance = 0.0;
+
+      for (unsigned int i=1; i < cities.size (); ++i)
+	distance += route.getWorld ()->getDistance (cities[i - 1], cities[i]);
+
+      return distance;
+    }
+
+    /*
+     * Check the distance and the hash of a route against the full sum and
+     * hash and store the distance as objective, so further edits are
+     * evaluated incrementally again
+     */
+    static void checkDistance (Route* route, const char* edit)
+      throw (InternalException)
+    {
+      if (route->getHash () !=
+	  Core::RingIndividual::computeHash (route->getChromosome (), false))
+	{
+	  DV ("  " << edit << ": hash not updated correctly");
+	  throw InternalException ("Wrong route hash");
+	}
+
+      double distance = route->computeDistance ();
+      double expected = computeFullDistance (*route);
+
+      if (fabs (distance - expected) > 1e-6 * expected)
+	{
+	  DV ("  " << edit << ": distance=" << distance <<
+	      ", expected=" << expected);
+	  throw InternalException ("Wrong route distance");
+	}
+
+      route->setObjective (distance);
+    }
+
+    /*
+     * Create an evaluated route visiting the cities in random order
+     */
+    static Route* createRoute (const World* world, const Random& random)
+    {
+      Route::Chromosome cities (world->size ());
+      for (unsigned int i=0; i < cities.size (); ++i)
+	cities[i] = i;
+
+      for (unsigned int i=cities.size () - 1; i > 0; --i)
+	std::swap (cities[i], cities[random.getInt (0, i)]);
+
+      Route* route = new Route (world);
+      route->setChromosome (cities);
+      route->setObjective (computeFullDistance (*route));
+
+      return route;
+    }
+
+    /*
+     * Test incremental route distances after single edits
+     */
+    static void testEdits () throw (InternalException)
+    {
+      DV ("* Testing incremental distance of edits");
+
+      World world (NUMBER_OF_CITIES);
+      Random random;
+
+      const Core::MutationOperator* operators[] = {
+	new Core::RingInversionMutationOperator (1.0, 20),
+	new Core::RingInversionMutationOperator (1.0),
+	new Core::RingDisplacementMutationOperator (1.0),
+	new Core::RingScrambleMutationOperator (1.0),
+	new Core::RingUniformMutationOperator (2.0 / NUMBER_OF_CITIES)
+      };
+      const unsigned int number_of_operators =
+	sizeof (operators) / sizeof (operators[0]);
+
+      const Core::CrossoverOperator* crossovers[] = {
+	new Core::RingPartiallyMatchedCrossoverOperator (),
+	new Core::RingOrderCrossoverOperator (),
+	new Core::RingCycleCrossoverOperator (),
+	new Core::RingEdgeRecombinationCrossoverOperator ()
+      };
+      const unsigned int number_of_crossovers =
+	sizeof (crossovers) / sizeof (crossovers[0]);
+
+      std::auto_ptr<Route> route (createRoute (&world, random));
+
+      for (unsigned int run=0; run < 2000; ++run)
+	{
+	  //
+	  // Swap of two cities via a new chromosome
+	  //
+	  Route::Chromosome cities = route->getChromosome ();
+	  std::swap (cities[random.getInt (0, NUMBER_OF_CITIES - 1)],
+		     cities[random.getInt (0, NUMBER_OF_CITIES - 1)]);
+	  route->setChromosome (cities);
+	  checkDistance (route.get (), "swap");
+
+	  //
+	  // Mutations, partly applied twice before the evaluation
+	  //
+	  const Core::MutationOperator* mutation_operator =
+	    operators[run % number_of_operators];
+
+	  route.reset (dynamic_cast<Route*> (mutation_operator->mutate
+					     (route.get ())));
+	  if (run % 3 == 0)
+	    route.reset (dynamic_cast<Route*> (mutation_operator->mutate
+					       (route.get ())));
+	  checkDistance (route.get (), "mutation");
+
+	  //
+	  // Crossover with a slightly changed copy
+	  //
+	  std::auto_ptr<Route> other
+	    (dynamic_cast<Route*> (operators[0]->mutate (route.get ())));
+	  checkDistance (other.get (), "mutation");
+
+	  TestPopulation target;
+	  crossovers[run % number_of_crossovers]->crossover
+	    (route.get (), other.get (), &target);
+
+	  for ( Core::Population::IndividualConstIterator i =
+		  target.getIndividualBegin ();
+		i != target.getIndividualEnd (); ++i )
+	    checkDistance (dynamic_cast<Route*> (*i), "crossover");
+	}
+
+      for (unsigned int i=0; i < number_of_operators; ++i)
+	delete operators[i];
+
+      for (unsigned int i=0; i < number_of_crossovers; ++i)
+	delete crossovers[i];
+    }
+
+    /*
+     * Test the edits which cannot be evaluated incrementally
+     */
+    static void testFallbacks () throw (InternalException)
+    {
+      DV ("* Testing full distance fallbacks");
+
+      World world (NUMBER_OF_CITIES);
+      Random random;
+
+      for (unsigned int run=0; run < 200; ++run)
+	{
+	  std::auto_ptr<Route> route (createRoute (&world, random));
+
+	  //
+	  // Overlapping and touching ranges
+	  //
+	  unsigned int position = random.getInt (0, NUMBER_OF_CITIES - 1);
+	  route->invert (position, 10);
+	  route->invert ((position + random.getInt (0, 10)) % NUMBER_OF_CITIES,
+			 10);
+
+	  if (!route->hasChangeLog () || route->getChangeLog ().size () != 2)
+	    throw InternalException ("Overlapping changes not logged");
+
+	  checkDistance (route.get (), "overlapping ranges");
+
+	  //
+	  // More logged ranges than evaluated incrementally
+	  //
+	  Route::Chromosome cities = route->getChromosome ();
+	  for (unsigned int i=0; i < 20; ++i)
+	    std::swap (cities[i * 8], cities[i * 8 + 2]);
+	  route->setChromosome (cities);
+
+	  if (!route->hasChangeLog () || route->getChangeLog ().size () != 40)
+	    throw InternalException ("Swaps not logged");
+
+	  checkDistance (route.get (), "long log");
+
+	  //
+	  // Edit covering more than a quarter of the route
+	  //
+	  route->invert (random.getInt (0, NUMBER_OF_CITIES - 1),
+			 NUMBER_OF_CITIES / 2);
+
+	  if (!route->hasChangeLog ())
+	    throw InternalException ("Large inversion not logged");
+
+	  checkDistance (route.get (), "large edit");
+
+	  //
+	  // Several independent changes without a log
+	  //
+	  cities = route->getChromosome ();
+	  std::reverse (cities.begin (), cities.end ());
+	  route->setChromosome (cities);
+
+	  if (route->hasChangeLog ())
+	    throw InternalException ("Complete change must not be logged");
+
+	  checkDistance (route.get (), "reversed route");
+	}
+    }
+
+    /*
+     * Test that the cached objective of a route is not used for its
+     * rotations, which are different open paths
+     */
+    static void testCachedRotations () throw (InternalException)
+    {
+      DV ("* Testing cached objectives of rotated routes");
+
+      World world (NUMBER_OF_CITIES);
+      Random random;
+      Core::MemoryEvaluationCache cache (1000);
+
+      for (unsigned int run=0; run < 200; ++run)
+	{
+	  std::auto_ptr<Route> route (createRoute (&world, random));
+	  cache.insert (route->getHash (), route->getObjective ());
+
+	  //
+	  // A reversed route is the same path
+	  //
+	  Route::Chromosome cities = route->getChromosome ();
+	  std::reverse (cities.begin (), cities.end ());
+
+	  Route reversed (&world);
+	  reversed.setChromosome (cities);
+
+	  double objective;
+	  if (!cache.lookup (reversed.getHash (), &objective) ||
+	      fabs (objective - computeFullDistance (reversed)) >
+	      1e-6 * objective)
+	    throw InternalException ("Reversed route not found in cache");
+
+	  //
+	  // A rotated route has the same ring edges but another length
+	  //
+	  cities = route->getChromosome ();
+	  std::rotate (cities.begin (),
+		       cities.begin () + random.getInt (1, NUMBER_OF_CITIES - 1),
+		       cities.end ());
+
+	  Route rotated (&world);
+	  rotated.setChromosome (cities);
+
+	  if (Core::RingIndividual::computeHash (cities) !=
+	      Core::RingIndividual::computeHash (route->getChromosome ()))
+	    throw InternalException ("Rotated ring hash differs");
+
+	  if (cache.lookup (rotated.getHash (), &objective))
+	    throw InternalException ("Rotated route shares cached objective");
+	}
+    }
+
+
+    /*
+     * Check the candidate lists of a set of cities against a brute force
+     * search. Equally distant neighbours are ordered by index.
+     */
+    static void checkCandidateLists (const std::vector<City>& cities,
+				     unsigned int number_of_neighbours,
+				     const char* layout)
+      throw (InternalException)
+    {
+      DV ("  " << layout << ", " << cities.size () << " cities");
+
+      CandidateLists lists (0, cities, number_of_neighbours);
+      SpatialGrid grid (cities);
+
+      unsigned int length =
+	std::min (number_of_neighbours,
+		  static_cast<unsigned int> (cities.size ()) - 1);
+
+      if (lists.getNumberOfGenes () != cities.size () ||
+	  lists.getNumberOfNeighbours () != length)
+	throw InternalException ("Wrong candidate list size");
+
+      std::vector<unsigned int> all;
+
+      for (unsigned int i=0; i < cities.size (); ++i)
+	{
+	  const Vec2d& point = cities[i].getPoint ();
+
+	  std::vector< std::pair<double, unsigned int> > expected;
+	  for (unsigned int j=0; j < cities.size (); ++j)
+	    if (j != i)
+	      {
+		double dx = cities[j].getPoint ()._x - point._x;
+		double dy = cities[j].getPoint ()._y - point._y;
+		expected.push_back (std::make_pair (dx * dx + dy * dy, j));
+	      }
+
+	  std::sort (expected.begin (), expected.end ());
+
+	  const unsigned int* neighbours = lists.getNeighbours (i);
+	  for (unsigned int j=0; j < length; ++j)
+	    if (neighbours[j] != expected[j].second)
+	      {
+		DV ("  city " << i << ", neighbour " << j << "=" <<
+		    neighbours[j] << ", expected=" << expected[j].second);
+		throw InternalException ("Wrong candidate list");
+	      }
+
+	  //
+	  // Queries for all other cities must visit the whole grid
+	  //
+	  grid.findNearest (i, cities.size (), &all);
+
+	  if (all.size () != expected.size ())
+	    throw InternalException ("Wrong number of nearest cities");
+
+	  for (unsigned int j=0; j < all.size (); ++j)
+	    if (all[j] != expected[j].second)
+	      throw InternalException ("Wrong order of nearest cities");
+	}
+    }
+
+    /*
+     * Test the candidate lists for several city layouts
+     */
+    static void testCandidateLists () throw (InternalException)
+    {
+      DV ("* Testing candidate lists");
+
+      Random random;
+      std::vector<City> cities;
+
+      //
+      // Uniformly distributed cities of a world
+      //
+      for (unsigned int i=0; i < NUMBER_OF_CITIES; ++i)
+	cities.push_back (City (random.getDouble (World::MIN_COORDINATE,
+						  World::MAX_COORDINATE),
+				random.getDouble (World::MIN_COORDINATE,
+						  World::MAX_COORDINATE)));
+      checkCandidateLists (cities, 10, "uniform");
+
+      //
+      // Dense clusters far apart, so most grid cells are empty
+      //
+      cities.clear ();
+      for (unsigned int i=0; i < NUMBER_OF_CITIES; ++i)
+	{
+	  double center = (i % 4) * World::MAX_COORDINATE / 4.0;
+	  cities.push_back (City (center + random.getGaussian (0.0, 1.0),
+				  center + random.getGaussian (0.0, 1.0)));
+	}
+      checkCandidateLists (cities, 10, "clustered");
+
+      //
+      // Cities sharing their positions, more copies than neighbours
+      //
+      cities.clear ();
+      for (unsigned int i=0; i < NUMBER_OF_CITIES; ++i)
+	cities.push_back (City ((i % 7) * 10.0, (i % 7) * 5.0));
+      checkCandidateLists (cities, 10, "duplicate");
+
+      //
+      // Cities on a line and cities at a single position
+      //
+      cities.clear ();
+      for (unsigned int i=0; i < NUMBER_OF_CITIES; ++i)
+	cities.push_back (City (random.getDouble (0.0, 100.0), 50.0));
+      checkCandidateLists (cities, 10, "line");
+
+      cities.clear ();
+      for (unsigned int i=0; i < 20; ++i)
+	cities.push_back (City (50.0, 50.0));
+      checkCandidateLists (cities, 10, "single position");
+
+      //
+      // Lists longer than the number of other cities
+      //
+      cities.erase (cities.begin () + 5, cities.end ());
+      checkCandidateLists (cities, 10, "few cities");
+    }
+
+  } // namespace Traveling
+} // namespace GEP
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+  bool ok = true;
+
+  try
+  {
+    GEP::Traveling::testEdits ();
+    GEP::Traveling::testFallbacks ();
+    GEP::Traveling::testCachedRotations ();
+    GEP::Traveling::testCandidateLists ();
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -9,9 +9,21 @@
 
 #include <GEPDebug.hpp>
 #include <GEPException.hpp>
+#include <GEPParallel.hpp>
 #include <GEPRandom.hpp>
 
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadStorage>
+
 #include <math.h>
+#include <stdlib.h>
+
+//
+// Maximum number of logged changes evaluated incrementally. The changes are
+// checked pairwise for overlaps, so long logs are summed up completely.
+//
+static const unsigned int MAX_CHANGES = 16;
 
 namespace GEP {
   namespace Traveling {
@@ -42,22 +54,529 @@ namespace GEP {
     }
 
 
+    //#***********************************************************************
+    // CLASS GEP::Traveling::DistanceMatrix
+    //#***********************************************************************
+
+    //
+    // Alignment of the matrix rows in bytes (cache line size)
+    //
+    static const unsigned int MATRIX_ALIGNMENT = 64;
+
+    namespace {
+
+      /*
+       * Task computing a range of matrix rows
+       */
+      template <class T>
+      class DistanceTask : public ParallelTask
+      {
+      public:
+	DistanceTask (const std::vector<City>& cities, T* data,
+		      DistanceMatrix::Layout_t layout, unsigned int row_size)
+	  : _cities (cities), _data (data), _layout (layout),
+	    _row_size (row_size)
+	{
+	}
+
+	virtual void execute (unsigned int /*chunk*/, unsigned int begin,
+			      unsigned int end)
+	{
+	  for (unsigned int i=begin; i < end; ++i)
+	    {
+	      if (_layout == DistanceMatrix::FULL)
+		{
+		  T* row = _data + static_cast<quint64> (i) * _row_size;
+		  for (unsigned int j=0; j < _cities.size (); ++j)
+		    row[j] = static_cast<T> (_cities[i].distance (_cities[j]));
+		}
+	      else
+		{
+		  T* row = _data + static_cast<quint64> (i) * (i - 1) / 2;
+		  for (unsigned int j=0; j < i; ++j)
+		    row[j] = static_cast<T> (_cities[i].distance (_cities[j]));
+		}
+	    }
+	}
+
+      private:
+	const std::vector<City>& _cities;
+	T* _data;
+	DistanceMatrix::Layout_t _layout;
+	unsigned int _row_size;
+      };
+
+      /*
+       * Return the number of elements per full matrix row including the
+       * alignment padding
+       */
+      unsigned int getRowSize (unsigned int number_of_cities,
+			       DistanceMatrix::Precision_t precision)
+      {
+	unsigned int element_size =
+	  precision == DistanceMatrix::FLOAT ? sizeof (float) : sizeof (double);
+	unsigned int elements_per_line = MATRIX_ALIGNMENT / element_size;
+
+	return (number_of_cities + elements_per_line - 1) /
+	  elements_per_line * elements_per_line;
+      }
+
+    }
+
+    /*
+     * Constructor
+     *
+     * The distances are computed in parallel threads.
+     *
+     * \param cities    Cities to compute the distances for
+     * \param precision Floating point type used for storage
+     * \param layout    Storage layout
+     */
+    DistanceMatrix::DistanceMatrix (const std::vector<City>& cities,
+				    Precision_t precision, Layout_t layout)
+      : _precision (precision),
+	_layout    (layout),
+	_row_size  (getRowSize (cities.size (), precision)),
+	_data      (0),
+	_floats    (0),
+	_doubles   (0)
+    {
+      quint64 memory = computeMemory (cities.size (), precision, layout);
+
+      if (posix_memalign (&_data, MATRIX_ALIGNMENT,
+			  std::max (memory, static_cast<quint64> (1))) != 0)
+	throw InternalException ("Cannot allocate distance matrix");
+
+      if (_precision == FLOAT)
+	{
+	  DistanceTask<float> task (cities, static_cast<float*> (_data),
+				    _layout, _row_size);
+	  Parallel::execute (&task, cities.size ());
+	  _floats = static_cast<const float*> (_data);
+	}
+      else
+	{
+	  DistanceTask<double> task (cities, static_cast<double*> (_data),
+				     _layout, _row_size);
+	  Parallel::execute (&task, cities.size ());
+	  _doubles = static_cast<const double*> (_data);
+	}
+    }
+
+    /* Destructor */
+    DistanceMatrix::~DistanceMatrix ()
+    {
+      free (_data);
+    }
+
+    /*
+     * Compute the memory needed by a distance matrix in bytes [STATIC]
+     */
+    quint64 DistanceMatrix::computeMemory (unsigned int number_of_cities,
+					   Precision_t precision,
+					   Layout_t layout)
+    {
+      quint64 element_size =
+	precision == FLOAT ? sizeof (float) : sizeof (double);
+
+      if (layout == FULL)
+	return static_cast<quint64> (number_of_cities) *
+	  getRowSize (number_of_cities, precision) * element_size;
+
+      return static_cast<quint64> (number_of_cities) *
+	(number_of_cities - 1) / 2 * element_size;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Traveling::SpatialGrid
+    //#***********************************************************************
+
+    //
+    // Average number of cities per grid cell
+    //
+    static const double CITIES_PER_CELL = 2.0;
+
+    namespace {
+
+      /*
+       * Neighbour candidate ordered by its squared distance
+       */
+      typedef std::pair<double, unsigned int> Candidate;
+
+    }
+
+    /*
+     * Constructor
+     *
+     * The cities are sorted into the cells by a counting sort.
+     *
+     * \param cities Cities to index. The vector is referenced, not copied.
+     */
+    SpatialGrid::SpatialGrid (const std::vector<City>& cities)
+      : _cities    (cities),
+	_min_x     (0.0),
+	_min_y     (0.0),
+	_cell_size (1.0),
+	_columns   (1),
+	_rows      (1)
+    {
+      if (!_cities.empty ())
+	{
+	  double max_x = _cities[0].getPoint ()._x;
+	  double max_y = _cities[0].getPoint ()._y;
+	  _min_x = max_x;
+	  _min_y = max_y;
+
+	  for (unsigned int i=1; i < _cities.size (); ++i)
+	    {
+	      const Vec2d& point = _cities[i].getPoint ();
+	      _min_x = std::min (_min_x, point._x);
+	      _min_y = std::min (_min_y, point._y);
+	      max_x = std::max (max_x, point._x);
+	      max_y = std::max (max_y, point._y);
+	    }
+
+	  double width = std::max (max_x - _min_x, max_y - _min_y);
+	  double area = (max_x - _min_x) * (max_y - _min_y);
+	  double cells = std::max (_cities.size () / CITIES_PER_CELL, 1.0);
+
+	  //
+	  // The lower bound keeps the number of cells linear in the number of
+	  // cities for flat city distributions
+	  //
+	  if (width > 0.0)
+	    {
+	      _cell_size = std::max (sqrt (area / cells), width / cells);
+	      _columns = static_cast<unsigned int>
+		((max_x - _min_x) / _cell_size) + 1;
+	      _rows = static_cast<unsigned int>
+		((max_y - _min_y) / _cell_size) + 1;
+	    }
+	}
+
+      _cell_begin.resize (_columns * _rows + 1, 0);
+      _cell_cities.resize (_cities.size ());
+
+      std::vector<unsigned int> cells (_cities.size ());
+
+      for (unsigned int i=0; i < _cities.size (); ++i)
+	{
+	  const Vec2d& point = _cities[i].getPoint ();
+	  cells[i] = getCell (point._y, _min_y, _rows) * _columns +
+	    getCell (point._x, _min_x, _columns);
+	  ++_cell_begin[cells[i] + 1];
+	}
+
+      for (unsigned int i=1; i < _cell_begin.size (); ++i)
+	_cell_begin[i] += _cell_begin[i - 1];
+
+      std::vector<unsigned int> fill (_cell_begin.begin (),
+				      _cell_begin.end () - 1);
+
+      for (unsigned int i=0; i < _cities.size (); ++i)
+	_cell_cities[fill[cells[i]]++] = i;
+    }
+
+    /* Destructor */
+    SpatialGrid::~SpatialGrid ()
+    {
+    }
+
+    /*
+     * Find the nearest neighbours of a city
+     *
+     * The cells are visited in square rings around the cell of the city
+     * until no unvisited cell can contain a closer city.
+     *
+     * \param city                 City to find the neighbours of
+     * \param number_of_neighbours Number of neighbours to find
+     * \param neighbours           Found neighbours sorted by increasing
+     *                             distance, the city itself is excluded
+     */
+    void SpatialGrid::findNearest (unsigned int city,
+				   unsigned int number_of_neighbours,
+				   std::vector<unsigned int>* neighbours) const
+    {
+      neighbours->clear ();
+
+      if (number_of_neighbours == 0)
+	return;
+
+      const Vec2d& point = _cities[city].getPoint ();
+      int column = getCell (point._x, _min_x, _columns);
+      int row = getCell (point._y, _min_y, _rows);
+      int max_ring = std::max (_columns, _rows);
+
+      //
+      // Max heap of the best candidates found so far
+      //
+      std::vector<Candidate> heap;
+      heap.reserve (number_of_neighbours + 1);
+
+      for (int ring=0; ring <= max_ring; ++ring)
+	{
+	  for (int y=row - ring; y <= row + ring; ++y)
+	    {
+	      if (y < 0 || y >= static_cast<int> (_rows))
+		continue;
+
+	      //
+	      // Inner rows of the ring consist of the left and right cell only
+	      //
+	      int step =
+		ring == 0 || y == row - ring || y == row + ring ? 1 : 2 * ring;
+
+	      for (int x=column - ring; x <= column + ring; x += step)
+		{
+		  if (x < 0 || x >= static_cast<int> (_columns))
+		    continue;
+
+		  unsigned int cell = y * _columns + x;
+
+		  for (unsigned int i=_cell_begin[cell];
+		       i < _cell_begin[cell + 1]; ++i)
+		    {
+		      unsigned int other = _cell_cities[i];
+		      if (other == city)
+			continue;
+
+		      const Vec2d& other_point = _cities[other].getPoint ();
+		      double dx = other_point._x - point._x;
+		      double dy = other_point._y - point._y;
+		      Candidate candidate (dx * dx + dy * dy, other);
+
+		      if (heap.size () < number_of_neighbours)
+			{
+			  heap.push_back (candidate);
+			  std::push_heap (heap.begin (), heap.end ());
+			}
+		      else if (candidate < heap.front ())
+			{
+			  std::pop_heap (heap.begin (), heap.end ());
+			  heap.back () = candidate;
+			  std::push_heap (heap.begin (), heap.end ());
+			}
+		    }
+		}
+	    }
+
+	  //
+	  // Cells of the next ring are at least 'ring' cells away
+	  //
+	  double bound = ring * _cell_size;
+	  if (heap.size () == number_of_neighbours &&
+	      heap.front ().first <= bound * bound)
+	    break;
+	}
+
+      std::sort_heap (heap.begin (), heap.end ());
+
+      for (unsigned int i=0; i < heap.size (); ++i)
+	neighbours->push_back (heap[i].second);
+    }
+
+    /* Return the cell index of a coordinate along one axis */
+    unsigned int SpatialGrid::getCell (double coordinate, double min,
+				       unsigned int size) const
+    {
+      unsigned int cell =
+	static_cast<unsigned int> ((coordinate - min) / _cell_size);
+
+      return std::min (cell, size - 1);
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Traveling::CandidateLists
+    //#***********************************************************************
+
+    namespace {
+
+      /*
+       * Task computing the candidate lists of a range of cities
+       */
+      class CandidateTask : public ParallelTask
+      {
+      public:
+	CandidateTask (const SpatialGrid& grid, unsigned int* data,
+		       unsigned int number_of_neighbours)
+	  : _grid (grid), _data (data),
+	    _number_of_neighbours (number_of_neighbours)
+	{
+	}
+
+	virtual void execute (unsigned int /*chunk*/, unsigned int begin,
+			      unsigned int end)
+	{
+	  std::vector<unsigned int> neighbours;
+
+	  for (unsigned int i=begin; i < end; ++i)
+	    {
+	      _grid.findNearest (i, _number_of_neighbours, &neighbours);
+	      std::copy (neighbours.begin (), neighbours.end (),
+			 _data + static_cast<quint64> (i) *
+			 _number_of_neighbours);
+	    }
+	}
+
+      private:
+	const SpatialGrid& _grid;
+	unsigned int* _data;
+	unsigned int _number_of_neighbours;
+      };
+
+    }
+
+    /*
+     * Constructor
+     *
+     * \param world                World the cities belong to
+     * \param cities               Cities to compute the lists for
+     * \param number_of_neighbours Length of each list, limited to the number
+     *                             of other cities
+     */
+    CandidateLists::CandidateLists (const World* world,
+				    const std::vector<City>& cities,
+				    unsigned int number_of_neighbours)
+      : Core::Neighbourhood (),
+	_world                (world),
+	_number_of_cities     (cities.size ()),
+	_number_of_neighbours (std::min (number_of_neighbours,
+					 cities.empty () ?
+					 0u : _number_of_cities - 1)),
+	_neighbours           (static_cast<quint64> (_number_of_cities) *
+			       _number_of_neighbours)
+    {
+      if (_neighbours.empty ())
+	return;
+
+      SpatialGrid grid (cities);
+      CandidateTask task (grid, &_neighbours[0], _number_of_neighbours);
+      Parallel::execute (&task, _number_of_cities);
+    }
+
+    /* Destructor */
+    CandidateLists::~CandidateLists ()
+    {
+    }
+
+    /* Return the number of cities */
+    unsigned int CandidateLists::getNumberOfGenes () const
+    {
+      return _number_of_cities;
+    }
+
+    /* Return the length of each list */
+    unsigned int CandidateLists::getNumberOfNeighbours () const
+    {
+      return _number_of_neighbours;
+    }
+
+    /*
+     * Return the neighbours of a city sorted by increasing distance
+     *
+     * The city index is not checked for performance reasons.
+     */
+    const unsigned int* CandidateLists::getNeighbours (unsigned int gene) const
+    {
+      return &_neighbours[static_cast<quint64> (gene) * _number_of_neighbours];
+    }
+
+    /* Return the distance between two cities */
+    double CandidateLists::getCost (unsigned int gene_1,
+				    unsigned int gene_2) const
+    {
+      return _world->getDistance (gene_1, gene_2);
+    }
+
+
     //#***********************************************************************
     // CLASS GEP::Traveling::World
     //#***********************************************************************
 
+    namespace {
+
+      //
+      // Number of entries of the per thread edge cache, a power of 2
+      //
+      const unsigned int EDGE_CACHE_SIZE = 4096;
+
+      /*
+       * Direct mapped cache of recently computed distances
+       *
+       * The cache is shared by all worlds used in a thread, so it is
+       * cleared when another world accesses it.
+       */
+      struct EdgeCache
+      {
+	EdgeCache ()
+	  : world_id (0), keys (EDGE_CACHE_SIZE, 0),
+	    distances (EDGE_CACHE_SIZE, 0.0)
+	{}
+
+	unsigned int world_id;
+	std::vector<quint64> keys;
+	std::vector<double> distances;
+      };
+
+      QThreadStorage<EdgeCache*> edge_caches;
+
+      QMutex world_id_mutex;
+      unsigned int next_world_id = 1;
+
+    }
+
     /* Minimum/maximum coordinates [STATIC] */
     const double World::MIN_COORDINATE = 0.0;
     const double World::MAX_COORDINATE = 1000.0;
 
-    /* Constructor */
-    World::World (unsigned int number_of_cities)
-      : _random ()
+    /*
+     * Constructor
+     *
+     * \param number_of_cities     Number of randomly placed cities
+     * \param precision            Floating point type of the distance matrix
+     * \param layout               Layout of the distance matrix
+     * \param max_matrix_megabytes Maximum memory used by the distance matrix.
+     *                             If exceeded, the distances are computed on
+     *                             the fly. 0 disables the matrix.
+     * \param number_of_neighbours Length of the nearest neighbour lists, 0
+     *                             disables the lists
+     */
+    World::World (unsigned int number_of_cities,
+		  DistanceMatrix::Precision_t precision,
+		  DistanceMatrix::Layout_t layout,
+		  unsigned int max_matrix_megabytes,
+		  unsigned int number_of_neighbours)
+      : _distances  (0),
+	_candidates (0),
+	_id         (0),
+	_random     ()
     {
       for (unsigned int i=0; i < number_of_cities; ++i)
 	_cities.push_back 
 	  (City (_random.getDouble (MIN_COORDINATE, MAX_COORDINATE),
 		 _random.getDouble (MIN_COORDINATE, MAX_COORDINATE)));
+
+      if (DistanceMatrix::computeMemory (number_of_cities, precision, layout)
+	  <= static_cast<quint64> (max_matrix_megabytes) * 1024 * 1024)
+	_distances = new DistanceMatrix (_cities, precision, layout);
+
+      if (number_of_neighbours > 0)
+	_candidates = new CandidateLists (this, _cities, number_of_neighbours);
+
+      QMutexLocker locker (&world_id_mutex);
+      _id = next_world_id++;
+    }
+
+    /* Destructor */
+    World::~World ()
+    {
+      delete _distances;
+      _distances = 0;
+
+      delete _candidates;
+      _candidates = 0;
     }
 
     /* Return a single city */
@@ -69,6 +588,40 @@ namespace GEP {
       return _cities[index];
     }
 
+    /* Compute the distance between two cities via the edge cache */
+    double World::computeDistance (unsigned int city_1,
+				   unsigned int city_2) const
+    {
+      if (!edge_caches.hasLocalData ())
+	edge_caches.setLocalData (new EdgeCache ());
+
+      EdgeCache* cache = edge_caches.localData ();
+
+      if (cache->world_id != _id)
+	{
+	  std::fill (cache->keys.begin (), cache->keys.end (), 0);
+	  cache->world_id = _id;
+	}
+
+      //
+      // The key is 1 based, so 0 marks empty entries
+      //
+      quint64 key = city_1 < city_2 ?
+	(static_cast<quint64> (city_1) << 32 | city_2) + 1 :
+	(static_cast<quint64> (city_2) << 32 | city_1) + 1;
+
+      unsigned int slot =
+	(key * 0x9e3779b97f4a7c15ULL) >> 32 & (EDGE_CACHE_SIZE - 1);
+
+      if (cache->keys[slot] != key)
+	{
+	  cache->keys[slot] = key;
+	  cache->distances[slot] = _cities[city_1].distance (_cities[city_2]);
+	}
+
+      return cache->distances[slot];
+    }
+
 
     //#***********************************************************************
     // CLASS GEP::Traveling::Route
@@ -77,10 +630,11 @@ namespace GEP {
     /*
      * Constructor
      *
-     * Constructs a valid random route
+     * Constructs a valid random route. The route is no round trip, so it
+     * is hashed as an open path.
      */
     Route::Route (const World* world)
-      : Core::RingIndividual (),
+      : Core::RingIndividual (false),
 	_world (world)
     {
     }
@@ -105,17 +659,104 @@ namespace GEP {
       return new Route (*this);
     }
 
-    /* Compute the individuals fitness in form of the overall distance*/
-    double Route::computeDistance ()
+    /*
+     * Compute the individuals fitness in form of the overall distance
+     *
+     * If the route has been derived from an evaluated parent by a few
+     * logged edits, only the edges touching the changed ranges are summed
+     * up and the distance is updated from the parents value.
+     */
+    double Route::computeDistance () const
+    {
+      double change = 0.0;
+
+      if (hasChangeLog () && hasParentObjective () &&
+	  computeDistanceChange (&change))
+	return getParentObjective () + change;
+
+      return computePathDistance ();
+    }
+
+    /* Sum up the distances along the whole route */
+    double Route::computePathDistance () const
     {
-      _distance = 0.0;
+      double distance = 0.0;
 
       const Chromosome& cities = getChromosome ();
 
       for (unsigned int i=1; i < cities.size (); ++i)
-	_distance += (*_world)[cities[i - 1]].distance ((*_world)[cities[i]]);
+	distance += _world->getDistance (cities[i - 1], cities[i]);
+
+      return distance;
+    }
+
+    /*
+     * Compute the distance change caused by the logged edits
+     *
+     * The old edges around a changed range can be restored from the former
+     * genes only if no other change touches the range or its neighbours, so
+     * overlapping changes are rejected. Large edits are rejected, too,
+     * because summing up the whole route is cheaper then.
+     *
+     * \param change Distance difference to the parent route
+     * \return 'true' if the change could be computed incrementally
+     */
+    bool Route::computeDistanceChange (double* change) const
+    {
+      const Chromosome& cities = getChromosome ();
+      const Chromosome& former_genes = getFormerGenes ();
+      const ChangeLog& log = getChangeLog ();
+
+      unsigned int size = cities.size ();
+
+      if (former_genes.size () > size / 4 || log.size () > MAX_CHANGES)
+	return false;
+
+      for (unsigned int i=0; i < log.size (); ++i)
+	for (unsigned int j=i + 1; j < log.size (); ++j)
+	  if ((log[j].position + size - log[i].position) % size <=
+	      log[i].length ||
+	      (log[i].position + size - log[j].position) % size <=
+	      log[j].length)
+	    return false;
+
+      *change = 0.0;
+
+      for (unsigned int i=0; i < log.size (); ++i)
+	{
+	  const Change& range = log[i];
+
+	  for (unsigned int j=range.position + size - 1;
+	       j < range.position + size + range.length; ++j)
+	    {
+	      unsigned int position_1 = j % size;
+	      unsigned int position_2 = (j + 1) % size;
+
+	      //
+	      // The route is no round trip, so there is no edge back from
+	      // the last to the first city
+	      //
+	      if (position_2 == 0)
+		continue;
+
+	      unsigned int offset_1 =
+		(position_1 + size - range.position) % size;
+	      unsigned int offset_2 =
+		(position_2 + size - range.position) % size;
+
+	      unsigned int city_1 = cities[position_1];
+	      unsigned int city_2 = cities[position_2];
+	      unsigned int former_1 = offset_1 < range.length ?
+		former_genes[range.offset + offset_1] : city_1;
+	      unsigned int former_2 = offset_2 < range.length ?
+		former_genes[range.offset + offset_2] : city_2;
+
+	      *change += _world->getDistance (city_1, city_2) -
+		_world->getDistance (former_1, former_2);
+	    }
+	}
 
-      return _distance;
+      return true;
     }
 
   } // namespace Traveling
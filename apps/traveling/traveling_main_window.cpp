@@ -11,7 +11,9 @@
 
 #include <GEPCoreController.hpp>
 #include <GEPCoreCriterion.hpp>
+#include <GEPCoreEvaluationCache.hpp>
 #include <GEPCorePopulation.hpp>
+#include <GEPCoreRestart.hpp>
 #include <GEPCoreRingIndividual.hpp>
 #include <GEPCoreSelection.hpp>
 #include <GEPDebug.hpp>
@@ -139,6 +141,9 @@ namespace GEP {
       _controller->setCrossoverProbability (0.3);
 
 #if 1
+      _controller->addSelectionOperator
+	(new Core::ExponentialRankSelectionOperator (0.98));
+#elif 0
       _controller->addSelectionOperator
 	(new Core::RouletteSelectionOperator ());
 #else
@@ -146,16 +151,40 @@ namespace GEP {
 	(new Core::BestSelectionOperator ());
 #endif
 #if 1
+      _controller->addCrossoverOperator
+	(new Core::RingEdgeRecombinationCrossoverOperator ());
+#elif 0
       _controller->addCrossoverOperator
 	(new Core::RingPartiallyMatchedCrossoverOperator ());
 #else
       _controller->addCrossoverOperator
 	(new Core::RingResortingCrossoverOperator ());
 #endif
+#if 1
+      _controller->addMutationOperator
+	(new Core::RingInversionMutationOperator (0.1));
+      _controller->addMutationOperator
+	(new Core::RingLocalSearchMutationOperator
+	 (_world->getCandidateLists (), 0.2, 1000, false));
+      _controller->setNumberOfMutationThreads (0);
+#elif 0
+      _controller->addMutationOperator
+	(new Core::RingSelfAdaptiveMutationOperator (0.2 / NUMBER_OF_CITIES,
+						     0.01 / NUMBER_OF_CITIES,
+						     5.0 / NUMBER_OF_CITIES));
+#else
       _controller->addMutationOperator
 	(new Core::RingUniformMutationOperator (0.2 / NUMBER_OF_CITIES));
+#endif
       _controller->addTerminationCriterion
 	(new Core::FixedStepTerminationCriterion (500, 50));
+      _controller->setRestartPolicy
+	(new Core::RestartPolicy (20, 2, 1.5, 400));
+      _controller->setDiversityMetrics (new Core::RingDiversityMetrics ());
+      _controller->setEvaluationCache (new Core::MemoryEvaluationCache (100000));
+#if 0
+      _controller->setSurrogateModel (new Core::RingEdgeSurrogateModel ());
+#endif
 
       connect (_controller, SIGNAL (signalStep (const Core::Controller*)),
 	       SLOT (slotUpdate ()));
@@ -60,7 +60,8 @@ namespace GEP {
     {
       //
       // Step 1: Compute route distance plus the minimum and maximum distance
-      //         values 
+      //         values. Routes with a known distance (unchanged or found in
+      //         the evaluation cache) are not evaluated again.
       //
       typedef std::map<Route*, double> DistanceMap;
       DistanceMap distances;
@@ -72,7 +73,8 @@ namespace GEP {
 	    i != getIndividualEnd (); ++i )
       {
 	Route* route = dynamic_cast<Route*> (*i);
-	double distance = route->computeDistance ();
+	double distance = route->hasObjective () ?
+	  route->getObjective () : route->computeDistance ();
 
 	distances.insert (std::make_pair (route, distance));
 
@@ -101,6 +103,7 @@ namespace GEP {
 	fitness = std::min (1.0, fitness);
 	
 	route->setFitness (fitness);
+	route->setObjective (distance);
       }
 
 #ifdef _DEBUG
@@ -8,6 +8,7 @@
 
 #include "GEPDisplayStatusWidget.hpp"
 #include <GEPCoreController.hpp>
+#include <GEPCoreDiversity.hpp>
 #include <GEPCoreIndividual.hpp>
 #include <GEPCorePopulation.hpp>
 
@@ -51,6 +52,11 @@ namespace GEP
       double max_fitness = std::numeric_limits<double>::min ();
       double average_fitness = std::numeric_limits<double>::min ();
 
+      double entropy = 0.0;
+      double distance = 0.0;
+      unsigned int genotypes = 0;
+      unsigned int number_of_metrics = 0;
+
       unsigned int count = 0;
       for ( Core::Controller::PopulationConstIterator i =
               controller->getPopulationBegin ();
@@ -58,6 +64,16 @@ namespace GEP
       {
         const Core::Population* population = *i;
 
+	const Core::DiversityMetrics* metrics =
+	  population->getDiversityMetrics ();
+	if (metrics != 0)
+	  {
+	    entropy += metrics->getEntropy ();
+	    distance += metrics->getAverageDistance ();
+	    genotypes += metrics->getNumberOfGenotypes ();
+	    ++number_of_metrics;
+	  }
+
         for ( Core::Population::IndividualConstIterator j =
                 population->getIndividualBegin ();
               j != population->getIndividualEnd (); ++j, ++count )
@@ -82,6 +98,37 @@ namespace GEP
 	_max_fitness->setText (QString::number (max_fitness, 'f', 4));
       else
 	_max_fitness->setText (QString ("(unknown)"));
+
+      if (number_of_metrics > 0)
+	{
+	  _edge_entropy->setText
+	    (QString::number (entropy / number_of_metrics, 'f', 4));
+	  _edge_distance->setText
+	    (QString::number (distance / number_of_metrics, 'f', 4));
+	  _genotypes->setText (QString::number (genotypes));
+	}
+      else
+	{
+	  _edge_entropy->setText (QString ("(unknown)"));
+	  _edge_distance->setText (QString ("(unknown)"));
+	  _genotypes->setText (QString ("(unknown)"));
+	}
+
+      _evaluations->setText
+	(QString::number (controller->getNumberOfEvaluations ()));
+
+      if (controller->getSurrogateModel () != 0)
+	{
+	  _saved_evaluations->setText
+	    (QString::number (controller->getNumberOfSavedEvaluations ()));
+	  _surrogate_hit_rate->setText
+	    (QString::number (controller->getSurrogateHitRate (), 'f', 4));
+	}
+      else
+	{
+	  _saved_evaluations->setText (QString ("(unknown)"));
+	  _surrogate_hit_rate->setText (QString ("(unknown)"));
+	}
     }
 
 
@@ -18,11 +18,17 @@ namespace GEP
   {
 
     class CrossoverOperator;
+    class DiversityMetrics;
+    class EvaluationCache;
+    class Evaluator;
     class Individual;
     class MutationOperator;
     class Population;
     class PopulationCreator;
+    class PopulationSizeController;
+    class RestartPolicy;
     class SelectionOperator;
+    class SurrogateModel;
     class TerminationCriterion;
 
     /*
@@ -51,6 +57,45 @@ namespace GEP
       inline const PopulationCreator* getPopulationCreator () const;
       void setPopulationCreator (const PopulationCreator* population_creator);
 
+      inline const RestartPolicy* getRestartPolicy () const;
+      void setRestartPolicy (RestartPolicy* restart_policy);
+
+      inline unsigned int getNumberOfRestarts () const;
+
+      inline const DiversityMetrics* getDiversityMetrics () const;
+      void setDiversityMetrics (DiversityMetrics* diversity_metrics);
+
+      inline const EvaluationCache* getEvaluationCache () const;
+      void setEvaluationCache (EvaluationCache* evaluation_cache);
+
+      inline const Evaluator* getEvaluator () const;
+      void setEvaluator (Evaluator* evaluator);
+
+      inline bool getRejectDuplicates () const;
+      void setRejectDuplicates (bool reject_duplicates);
+
+      inline unsigned int getNumberOfDuplicateRetries () const;
+      void setNumberOfDuplicateRetries (unsigned int retries);
+
+      inline unsigned int getNumberOfMutationThreads () const;
+      void setNumberOfMutationThreads (unsigned int number_of_threads);
+
+      inline quint64 getNumberOfEvaluations () const;
+
+      inline const SurrogateModel* getSurrogateModel () const;
+      void setSurrogateModel (SurrogateModel* surrogate_model);
+
+      inline double getSurrogateFraction () const;
+      void setSurrogateFraction (double fraction);
+
+      inline quint64 getNumberOfSavedEvaluations () const;
+      double getSurrogateHitRate () const;
+
+      inline const PopulationSizeController* getPopulationSizeController ()
+	const;
+      void setPopulationSizeController
+      (PopulationSizeController* population_size_controller);
+
       typedef std::vector<const Population*>::const_iterator
       PopulationConstIterator;
       inline PopulationConstIterator getPopulationBegin () const;
@@ -58,7 +103,7 @@ namespace GEP
 
       void addSelectionOperator (const SelectionOperator* func);
       void addCrossoverOperator (const CrossoverOperator* func);
-      void addMutationOperator (const MutationOperator* func);
+      void addMutationOperator (MutationOperator* func);
       void addTerminationCriterion (TerminationCriterion* criterion);
 
       bool initialize ();
@@ -79,28 +124,60 @@ namespace GEP
       void executeNextStep ();
       bool checkTermination () const;
       void computeFitness ();
+      void evaluatePopulation (const Population* population);
+      void createOffspring (const std::vector<const Individual*>& parents,
+			    Population* target);
+      void screenOffspring (Population* candidates, Population* target,
+			    unsigned int size);
+      void updateSurrogateStatistics ();
+      void updateOperators ();
+      void checkRestart ();
+      void restartPopulation (unsigned int index);
+      void clearEliteArchive ();
+      void resizeSelection (std::vector<unsigned int>* selection,
+			    unsigned int size);
+      void attachDiversityMetrics (Population* population) const;
 
     private:
       unsigned int _number_of_populations;
       unsigned int _number_of_individuals;
       double _crossover_probability;
+      bool _reject_duplicates;
+      unsigned int _number_of_duplicate_retries;
+      unsigned int _number_of_mutation_threads;
+      double _surrogate_fraction;
 
       //
       // Registered objects
       //
       const PopulationCreator* _population_creator;
+      RestartPolicy* _restart_policy;
+      PopulationSizeController* _population_size_controller;
+      DiversityMetrics* _diversity_metrics;
+      EvaluationCache* _evaluation_cache;
+      Evaluator* _evaluator;
+      SurrogateModel* _surrogate_model;
 
       std::vector<const SelectionOperator*> _selection_operators;
       std::vector<const CrossoverOperator*> _crossover_operators;
-      std::vector<const MutationOperator*> _mutation_operators;
+      std::vector<MutationOperator*> _mutation_operators;
       std::vector<TerminationCriterion*> _termination_criterions;
 
       //
       // State informations
       //
       std::vector<const Population*> _populations;
+      std::vector<Individual*> _elite_archive;
 
       unsigned int _step;
+      unsigned int _number_of_restarts;
+      quint64 _number_of_evaluations;
+      quint64 _number_of_saved_evaluations;
+      quint64 _number_of_predictions;
+      quint64 _number_of_surrogate_hits;
+
+      typedef std::pair<const Individual*, double> Prediction;
+      std::vector<Prediction> _predictions;
       bool _stopped;
 
       Random _random;
@@ -161,6 +238,85 @@ namespace GEP
       return _population_creator;
     }
 
+    /* Return the current restart policy (may be NULL) */
+    inline const RestartPolicy* Controller::getRestartPolicy () const
+    {
+      return _restart_policy;
+    }
+
+    /* Return the diversity metrics prototype (may be NULL) */
+    inline const DiversityMetrics* Controller::getDiversityMetrics () const
+    {
+      return _diversity_metrics;
+    }
+
+    /* Return the evaluation cache (may be NULL) */
+    inline const EvaluationCache* Controller::getEvaluationCache () const
+    {
+      return _evaluation_cache;
+    }
+
+    /* Return the external objective evaluator (may be NULL) */
+    inline const Evaluator* Controller::getEvaluator () const
+    {
+      return _evaluator;
+    }
+
+    /* Return if mutated individuals with duplicate genotypes are rejected */
+    inline bool Controller::getRejectDuplicates () const
+    {
+      return _reject_duplicates;
+    }
+
+    /* Return the number of mutation retries for rejected duplicates */
+    inline unsigned int Controller::getNumberOfDuplicateRetries () const
+    {
+      return _number_of_duplicate_retries;
+    }
+
+    /* Return the number of threads mutating the offspring */
+    inline unsigned int Controller::getNumberOfMutationThreads () const
+    {
+      return _number_of_mutation_threads;
+    }
+
+    /* Return the number of objective evaluations since initialization */
+    inline quint64 Controller::getNumberOfEvaluations () const
+    {
+      return _number_of_evaluations;
+    }
+
+    /* Return the surrogate model (may be NULL) */
+    inline const SurrogateModel* Controller::getSurrogateModel () const
+    {
+      return _surrogate_model;
+    }
+
+    /* Return the fraction of candidate offspring evaluated exactly */
+    inline double Controller::getSurrogateFraction () const
+    {
+      return _surrogate_fraction;
+    }
+
+    /* Return the number of evaluations saved by surrogate pre-screening */
+    inline quint64 Controller::getNumberOfSavedEvaluations () const
+    {
+      return _number_of_saved_evaluations;
+    }
+
+    /* Return the current population size controller (may be NULL) */
+    inline const PopulationSizeController*
+    Controller::getPopulationSizeController () const
+    {
+      return _population_size_controller;
+    }
+
+    /* Return the number of population restarts since initialization */
+    inline unsigned int Controller::getNumberOfRestarts () const
+    {
+      return _number_of_restarts;
+    }
+
   } // namespace Core
 } // namespace GEP
 
@@ -44,6 +44,24 @@ namespace GEP {
       double _last_average_fitness;
       unsigned int _unchanged_steps;
     };
+
+    /*
+     * Termination after all populations lost their diversity
+     *
+     * Requires diversity metrics attached to the populations (see
+     * Controller::setDiversityMetrics).
+     */
+    class DiversityTerminationCriterion : public TerminationCriterion
+    {
+    public:
+      DiversityTerminationCriterion (double min_distance);
+      virtual ~DiversityTerminationCriterion ();
+
+      virtual bool finished (const Controller* controller);
+
+    private:
+      double _min_distance;
+    };
     
   } // namespace Core
 } // namespace GEP
@@ -0,0 +1,44 @@
+/*
+ * GEPCoreDiversity.hpp - Population diversity metrics
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreDiversity_hpp__
+#define __GEPCoreDiversity_hpp__
+
+namespace GEP {
+  namespace Core {
+
+    class Individual;
+
+    /*
+     * Base class for incrementally maintained population diversity metrics
+     *
+     * A metrics object is attached to a population and updated whenever an
+     * individual is added to or removed from it, so the metrics are always
+     * available without scanning the whole population.
+     */
+    class DiversityMetrics
+    {
+    public:
+      DiversityMetrics ();
+      virtual ~DiversityMetrics ();
+
+      virtual DiversityMetrics* create () const = 0;
+
+      virtual void add (const Individual* individual) = 0;
+      virtual void remove (const Individual* individual) = 0;
+      virtual void clear () = 0;
+
+      virtual unsigned int size () const = 0;
+
+      virtual double getEntropy () const = 0;
+      virtual double getAverageDistance () const = 0;
+      virtual unsigned int getNumberOfGenotypes () const = 0;
+    };
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * GEPCoreEvaluationCache.hpp - Cache for already computed objective values
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreEvaluationCache_hpp__
+#define __GEPCoreEvaluationCache_hpp__
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <string>
+#include <vector>
+
+namespace GEP {
+  namespace Core {
+
+    /*
+     * Base class for caches mapping genotype hashes to objective values
+     *
+     * Implementations must be safe to be used from multiple threads
+     * concurrently.
+     */
+    class EvaluationCache
+    {
+    public:
+      EvaluationCache ();
+      virtual ~EvaluationCache ();
+
+      virtual bool lookup (quint64 hash, double* objective) const = 0;
+      virtual void insert (quint64 hash, double objective) = 0;
+      virtual void clear () = 0;
+
+      virtual unsigned int size () const = 0;
+      virtual quint64 getNumberOfHits () const = 0;
+      virtual quint64 getNumberOfMisses () const = 0;
+    };
+
+    /*
+     * Bounded in memory evaluation cache
+     *
+     * The entries are distributed over a number of independently locked
+     * shards, so concurrent accesses rarely block each other. If a shard is
+     * full, its oldest entry is dropped.
+     */
+    class MemoryEvaluationCache : public EvaluationCache
+    {
+    public:
+      MemoryEvaluationCache (unsigned int max_size,
+			     unsigned int number_of_shards=16);
+      virtual ~MemoryEvaluationCache ();
+
+      virtual bool lookup (quint64 hash, double* objective) const;
+      virtual void insert (quint64 hash, double objective);
+      virtual void clear ();
+
+      virtual unsigned int size () const;
+      virtual quint64 getNumberOfHits () const;
+      virtual quint64 getNumberOfMisses () const;
+
+    private:
+      struct Shard;
+      inline Shard* getShard (quint64 hash) const;
+
+    private:
+      unsigned int _max_shard_size;
+      std::vector<Shard*> _shards;
+    };
+
+    /*
+     * Evaluation cache persisted on disk
+     *
+     * The cache consists of an append-only log of (hash, objective) records
+     * and a memory mapped open addressing hash index over it. Several
+     * processes on the same host may use the same cache concurrently:
+     * writers are serialized via a lock file, while readers access the
+     * shared index without locking. Entries are never dropped, except by
+     * clear (). The index is rebuilt from the log if it is missing or
+     * damaged and grown by replacing it with a larger one.
+     *
+     * Since the genotype hash does not identify the problem instance, the
+     * caller must supply a key derived from the instance and the objective,
+     * like a hash of the city coordinates. The key is stored in the log and
+     * in the index, and a cache created with another key is refused.
+     */
+    class PersistentEvaluationCache : public EvaluationCache
+    {
+    public:
+      PersistentEvaluationCache (const QString& path, quint64 key,
+				 unsigned int initial_capacity=65536);
+      virtual ~PersistentEvaluationCache ();
+
+      virtual bool lookup (quint64 hash, double* objective) const;
+      virtual void insert (quint64 hash, double objective);
+      virtual void clear ();
+
+      virtual unsigned int size () const;
+      virtual quint64 getNumberOfHits () const;
+      virtual quint64 getNumberOfMisses () const;
+
+    private:
+      struct Header;
+      struct Slot;
+
+      bool mapIndex () const;
+      void unmapIndex () const;
+      void checkIndex () const;
+      void rebuildIndex (quint64 capacity);
+      void updateIndex ();
+      bool findSlot (quint64 hash, double* objective) const;
+      bool insertSlot (quint64 hash, double objective);
+
+    private:
+      std::string _path;
+      quint64 _key;
+
+      int _lock_fd;
+      int _log_fd;
+
+      mutable Header* _header;
+      mutable Slot* _slots;
+      mutable quint64 _mapped_size;
+
+      mutable QMutex _mutex;
+      mutable quint64 _hits;
+      mutable quint64 _misses;
+    };
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * GEPCoreEvaluator.hpp - External computation of objective values
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreEvaluator_hpp__
+#define __GEPCoreEvaluator_hpp__
+
+#include <string>
+#include <vector>
+
+namespace GEP {
+  namespace Core {
+
+    class Individual;
+
+    /*
+     * Base class for objective evaluators
+     *
+     * An evaluator computes the raw objective values of individuals outside
+     * of the population, for example in external processes. The population
+     * then only derives the fitness values from the objectives.
+     */
+    class Evaluator
+    {
+    public:
+      Evaluator ();
+      virtual ~Evaluator ();
+
+      virtual void evaluate (const std::vector<Individual*>& individuals) = 0;
+    };
+
+    /*
+     * Base class for converting genomes into a binary representation
+     */
+    class GenomeEncoder
+    {
+    public:
+      GenomeEncoder ();
+      virtual ~GenomeEncoder ();
+
+      virtual void encode (const Individual* individual,
+			   std::string* buffer) const = 0;
+    };
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
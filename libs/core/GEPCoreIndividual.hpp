@@ -8,11 +8,15 @@
 #define __GEPCoreIndividual_hpp__
 
 #include <GEPException.hpp>
+
+#include <QtCore/QtGlobal>
 #include <limits>
+#include <vector>
 
 namespace GEP {
   namespace Core {
 
+    class MutationOperator;
     class Population;
     
     /*!
@@ -26,6 +30,7 @@ namespace GEP {
       virtual ~Individual ();
 
       virtual Individual* clone () const = 0;
+      virtual quint64 getHash () const;
 
       inline bool getSelected () const;
       void setSelected (bool selected);
@@ -33,9 +38,39 @@ namespace GEP {
       inline double getFitness () const;
       void setFitness (double fitness);
 
+      inline bool hasObjective () const;
+      inline double getObjective () const;
+      void setObjective (double objective);
+      void clearObjective ();
+
+      inline unsigned int getNumberOfObjectives () const;
+      inline double getObjective (unsigned int index) const;
+      void setObjectives (const std::vector<double>& objectives);
+
+      inline bool hasParentObjective () const;
+      inline double getParentObjective () const;
+
+      inline double getMutationRate () const;
+      void setMutationRate (double mutation_rate);
+      void recombineMutationRate (const Individual* individual);
+
+      inline const MutationOperator* getMutationOperator () const;
+      void setMutationOperator (const MutationOperator* mutation_operator);
+
     private:
       bool _selected;
       double _fitness;
+
+      bool _has_objective;
+      double _objective;
+      std::vector<double> _objectives;
+
+      bool _has_parent_objective;
+      double _parent_objective;
+
+      double _mutation_rate;
+
+      const MutationOperator* _mutation_operator;
     };
 
     
@@ -77,6 +112,102 @@ namespace GEP {
       return _fitness;
     }
 
+    /*
+     * Return if the raw objective value of this individual is known
+     */
+    inline bool Individual::hasObjective () const
+    {
+      return _has_objective;
+    }
+
+    /*
+     * Get raw objective value
+     *
+     * \return Unnormalized objective value as computed by the population,
+     *         smaller values are better
+     */
+    inline double Individual::getObjective () const
+    {
+      if (!_has_objective)
+	throw InternalException ("Objective not computed yet");
+
+      return _objective;
+    }
+
+    /*
+     * Return the number of known objective values
+     *
+     * \return 0 if no objective is known, 1 for single objective and the
+     *         number of objectives for multi objective individuals
+     */
+    inline unsigned int Individual::getNumberOfObjectives () const
+    {
+      if (!_has_objective)
+	return 0;
+
+      return _objectives.empty () ? 1 : _objectives.size ();
+    }
+
+    /*
+     * Get a single raw objective value of a multi objective individual
+     *
+     * \param index Index of the objective. Index 0 is the primary objective
+     *              also returned by getObjective ().
+     */
+    inline double Individual::getObjective (unsigned int index) const
+    {
+      if (index == 0)
+	return getObjective ();
+
+      if (index >= _objectives.size ())
+	throw InternalException ("Objective index exceeded");
+
+      return _objectives[index];
+    }
+
+    /*
+     * Return if the objective value of the individual this one has been
+     * derived from is known
+     */
+    inline bool Individual::hasParentObjective () const
+    {
+      return _has_parent_objective;
+    }
+
+    /*
+     * Get the objective value of the individual this one has been derived
+     * from. Used to measure the success of variation operators.
+     */
+    inline double Individual::getParentObjective () const
+    {
+      if (!_has_parent_objective)
+	throw InternalException ("Parent objective not known");
+
+      return _parent_objective;
+    }
+
+    /*
+     * Get the individuals own mutation rate
+     *
+     * \return Mutation rate or a negative value if the individual does not
+     *         carry a self adaptive mutation rate
+     */
+    inline double Individual::getMutationRate () const
+    {
+      return _mutation_rate;
+    }
+
+    /*
+     * Get the mutation operator which created the individual
+     *
+     * \return Operator or 0 if the individual is not a changed result of a
+     *         mutation operator marking its offspring
+     */
+    inline const MutationOperator* Individual::getMutationOperator () const
+    {
+      return _mutation_operator;
+    }
+
     /*
      * Comparison operator
      */
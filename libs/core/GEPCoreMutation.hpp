@@ -11,10 +11,13 @@
 
 #include <QtCore/QString>
 
+#include <vector>
+
 namespace GEP {
   namespace Core {
 
     class Individual;
+    class Population;
     
     /*
      * Base class for all mutation operators
@@ -26,6 +29,9 @@ namespace GEP {
       virtual ~MutationOperator ();
 
       virtual Individual* mutate (const Individual* source) const = 0;
+      virtual void update (const std::vector<const Population*>& populations);
+
+      virtual bool isThreadSafe () const;
     };
     
   } // namespace Core
@@ -0,0 +1,39 @@
+/*
+ * GEPCoreNeighbourhood.hpp - Candidate neighbours of genes
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreNeighbourhood_hpp__
+#define __GEPCoreNeighbourhood_hpp__
+
+namespace GEP {
+  namespace Core {
+
+    /*
+     * Base class for candidate lists of ring genes
+     *
+     * For each gene, a short list of promising neighbours is given, sorted
+     * from the best to the worst one, together with the cost of the edge
+     * connecting two genes. Operators and local search restrict their moves
+     * to candidate edges, so their cost does not grow with the chromosome
+     * length.
+     */
+    class Neighbourhood
+    {
+    public:
+      Neighbourhood ();
+      virtual ~Neighbourhood ();
+
+      virtual unsigned int getNumberOfGenes () const = 0;
+      virtual unsigned int getNumberOfNeighbours () const = 0;
+      virtual const unsigned int* getNeighbours (unsigned int gene) const = 0;
+
+      virtual double getCost (unsigned int gene_1,
+			      unsigned int gene_2) const = 0;
+    };
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
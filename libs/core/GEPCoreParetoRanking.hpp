@@ -0,0 +1,125 @@
+/*
+ * GEPCoreParetoRanking.hpp - Non-dominated sorting of multi objective
+ *                            populations
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreParetoRanking_hpp__
+#define __GEPCoreParetoRanking_hpp__
+
+#include <GEPException.hpp>
+#include <vector>
+
+namespace GEP {
+  namespace Core {
+
+    class Individual;
+    class Population;
+
+    /*
+     * Pareto front ranks and crowding distances of a population
+     *
+     * The fronts are computed via efficient non-dominated sorting (ENS)
+     * with binary search over the fronts. The individuals are processed in
+     * lexicographic objective order, so an individual can only be dominated
+     * by already processed ones. For two objectives only the last member of
+     * a front has to be checked, which gives O(N log N) overall.
+     */
+    class ParetoRanking
+    {
+    public:
+      ParetoRanking ();
+      ~ParetoRanking ();
+
+      void compute (const Population* population);
+
+      inline unsigned int size () const;
+      inline unsigned int getNumberOfFronts () const;
+
+      inline unsigned int getRank (unsigned int index) const;
+      inline double getCrowdingDistance (unsigned int index) const;
+      inline bool isBetter (unsigned int index_1, unsigned int index_2) const;
+
+      static bool dominates (const Individual* individual_1,
+			     const Individual* individual_2);
+
+    private:
+      class LexicographicComparator;
+      class ObjectiveComparator;
+
+      bool dominates (unsigned int index_1, unsigned int index_2) const;
+      bool frontDominates (const std::vector<unsigned int>& front,
+			   unsigned int index) const;
+      void computeCrowdingDistances (const std::vector<unsigned int>& front);
+
+    private:
+      unsigned int _number_of_objectives;
+      std::vector<double> _objectives;
+
+      std::vector<unsigned int> _ranks;
+      std::vector<double> _crowding_distances;
+      unsigned int _number_of_fronts;
+    };
+
+
+    //#***********************************************************************
+    // Inline functions
+    //#***********************************************************************
+
+    /* Return the number of ranked individuals */
+    inline unsigned int ParetoRanking::size () const
+    {
+      return _ranks.size ();
+    }
+
+    /* Return the number of Pareto fronts */
+    inline unsigned int ParetoRanking::getNumberOfFronts () const
+    {
+      return _number_of_fronts;
+    }
+
+    /*
+     * Return the front rank of an individual
+     *
+     * \param index Index of the individual in the ranked population
+     * \return Front rank, 0 for the non-dominated individuals
+     */
+    inline unsigned int ParetoRanking::getRank (unsigned int index) const
+    {
+      if (index >= _ranks.size ())
+	throw InternalException ("Ranking index exceeded");
+
+      return _ranks[index];
+    }
+
+    /*
+     * Return the crowding distance of an individual within its front
+     *
+     * \param index Index of the individual in the ranked population
+     * \return Crowding distance, infinite for the boundary individuals
+     */
+    inline double ParetoRanking::getCrowdingDistance (unsigned int index) const
+    {
+      if (index >= _crowding_distances.size ())
+	throw InternalException ("Ranking index exceeded");
+
+      return _crowding_distances[index];
+    }
+
+    /*
+     * Crowded comparison: lower rank first, then larger crowding distance
+     */
+    inline bool ParetoRanking::isBetter (unsigned int index_1,
+					 unsigned int index_2) const
+    {
+      if (getRank (index_1) != getRank (index_2))
+	return getRank (index_1) < getRank (index_2);
+
+      return getCrowdingDistance (index_1) > getCrowdingDistance (index_2);
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
@@ -8,11 +8,16 @@
 #define __GEPCorePopulation_hpp__
 
 #include <GEPException.hpp>
+
+#include <QtCore/QtGlobal>
+
+#include <boost/unordered_map.hpp>
 #include <vector>
 
 namespace GEP {
   namespace Core {
 
+    class DiversityMetrics;
     class Individual;
     
     /*
@@ -35,10 +40,23 @@ namespace GEP {
 
       virtual void computeFitness () const = 0;
 
-      void addIndividual (Individual* individual);
+      bool addIndividual (Individual* individual, bool force=false);
+      Individual* takeIndividual (unsigned int index);
+
+      inline bool getRejectDuplicates () const;
+      void setRejectDuplicates (bool reject_duplicates);
+      bool containsGenotype (const Individual* individual) const;
+
+      inline const DiversityMetrics* getDiversityMetrics () const;
+      void setDiversityMetrics (DiversityMetrics* diversity_metrics);
       
     private:
       Individuals _individuals;
+      DiversityMetrics* _diversity_metrics;
+
+      typedef boost::unordered_map<quint64, unsigned int> HashCounts;
+      HashCounts _hash_counts;
+      bool _reject_duplicates;
     };
 
     /*
@@ -78,6 +96,18 @@ namespace GEP {
       return _individuals.size ();
     }
 
+    /* Return if individuals with already present genotypes are rejected */
+    inline bool Population::getRejectDuplicates () const
+    {
+      return _reject_duplicates;
+    }
+
+    /* Return the diversity metrics of this population (may be NULL) */
+    inline const DiversityMetrics* Population::getDiversityMetrics () const
+    {
+      return _diversity_metrics;
+    }
+
     /* Return individual at a given index position */
     inline const Individual* Population::operator[] (unsigned int index) const
     {
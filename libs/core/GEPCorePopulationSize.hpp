@@ -0,0 +1,80 @@
+/*
+ * GEPCorePopulationSize.hpp - Dynamic population size control
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCorePopulationSize_hpp__
+#define __GEPCorePopulationSize_hpp__
+
+#include <vector>
+
+namespace GEP {
+  namespace Core {
+
+    class Population;
+
+    /*
+     * Controller adapting the population sizes between steps
+     *
+     * A population which collapsed onto a few genotypes is shrunk, because
+     * evaluating many copies of the same solutions wastes evaluations. A
+     * diverse population whose best objective did not improve for some
+     * steps is grown to sample more of the search space. All sizes stay
+     * within the configured bounds.
+     */
+    class PopulationSizeController
+    {
+    public:
+      PopulationSizeController (unsigned int min_size,
+				unsigned int max_size,
+				double min_diversity=0.3,
+				unsigned int max_unchanged_steps=5,
+				double resize_factor=1.25);
+      virtual ~PopulationSizeController ();
+
+      inline unsigned int getMinSize () const;
+      inline unsigned int getMaxSize () const;
+
+      virtual void reset ();
+      virtual unsigned int computeSize (unsigned int index,
+					const Population* population);
+
+      virtual double computeDiversity (const Population* population) const;
+
+    private:
+      bool checkImprovement (unsigned int index,
+			     const Population* population);
+
+    private:
+      unsigned int _min_size;
+      unsigned int _max_size;
+      double _min_diversity;
+      unsigned int _max_unchanged_steps;
+      double _resize_factor;
+
+      std::vector<double> _best_objective;
+      std::vector<unsigned int> _unchanged_steps;
+    };
+
+
+    //#***********************************************************************
+    // Inline functions
+    //#***********************************************************************
+
+    /* Return the minimum population size */
+    inline unsigned int PopulationSizeController::getMinSize () const
+    {
+      return _min_size;
+    }
+
+    /* Return the maximum population size */
+    inline unsigned int PopulationSizeController::getMaxSize () const
+    {
+      return _max_size;
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * GEPCoreProcessEvaluator.hpp - Objective evaluation in worker processes
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreProcessEvaluator_hpp__
+#define __GEPCoreProcessEvaluator_hpp__
+
+#include "GEPCoreEvaluator.hpp"
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace GEP {
+  namespace Core {
+
+    /*
+     * Evaluator sending batches of genomes to a pool of worker processes
+     *
+     * Each worker is started via '/bin/sh -c <command>' and connected by a
+     * Unix socket to its stdin and stdout. All integers are 32 bit and all
+     * values are in native byte order, since the workers run locally.
+     *
+     * Request:  'GEPQ', batch id, count, count * (length, genome bytes)
+     * Response: 'GEPR', batch id, count, count * objective (64 bit double)
+     *
+     * A worker answers the requests in the order received. Up to
+     * 'concurrency' batches are sent to a worker before the first answer is
+     * read. A worker which crashes, violates the protocol or does not answer
+     * a batch within the timeout is killed and restarted, and its pending
+     * batches are sent again.
+     */
+    class ProcessEvaluator : public Evaluator
+    {
+    public:
+      ProcessEvaluator (const QString& command, GenomeEncoder* encoder,
+			unsigned int number_of_workers=1,
+			unsigned int batch_size=64,
+			unsigned int concurrency=2,
+			unsigned int timeout=10000,
+			unsigned int max_retries=3);
+      virtual ~ProcessEvaluator ();
+
+      virtual void evaluate (const std::vector<Individual*>& individuals);
+
+      inline unsigned int getNumberOfRestarts () const;
+
+    private:
+      struct Batch
+      {
+	unsigned int _id;
+	unsigned int _begin;
+	unsigned int _end;
+	unsigned int _retries;
+      };
+
+      struct Worker
+      {
+	int _pid;
+	int _fd;
+	std::string _output;
+	std::string _input;
+	std::deque<Batch> _batches;
+	quint64 _deadline;
+      };
+
+      void startWorker (Worker* worker);
+      void stopWorker (Worker* worker);
+      void restartWorker (Worker* worker, std::deque<Batch>* pending);
+
+      void send (Worker* worker, const Batch& batch,
+		 const std::vector<Individual*>& individuals);
+      bool flush (Worker* worker);
+      bool receive (Worker* worker,
+		    const std::vector<Individual*>& individuals,
+		    unsigned int* remaining);
+
+      static quint64 getTime ();
+
+    private:
+      std::string _command;
+      GenomeEncoder* _encoder;
+
+      unsigned int _batch_size;
+      unsigned int _concurrency;
+      unsigned int _timeout;
+      unsigned int _max_retries;
+
+      std::vector<Worker> _workers;
+      unsigned int _next_batch_id;
+      unsigned int _number_of_restarts;
+    };
+
+
+    //#***********************************************************************
+    // Inline functions
+    //#***********************************************************************
+
+    /* Return the number of worker restarts after failures */
+    inline unsigned int ProcessEvaluator::getNumberOfRestarts () const
+    {
+      return _number_of_restarts;
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * GEPCoreRestart.hpp - Restart policy for stagnated populations
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreRestart_hpp__
+#define __GEPCoreRestart_hpp__
+
+#include <vector>
+
+namespace GEP {
+  namespace Core {
+
+    class Population;
+
+    /*
+     * Policy deciding when and how a stagnated population is restarted
+     *
+     * A population counts as stagnated if its best objective value did not
+     * improve for a given number of steps. For individuals without raw
+     * objective, the average fitness must remain unchanged instead.
+     *
+     * The controller then keeps the best individuals in an elite archive,
+     * reinitializes the rest of the population and optionally grows the
+     * population size (IPOP style).
+     */
+    class RestartPolicy
+    {
+    public:
+      RestartPolicy (unsigned int max_unchanged_steps,
+		     unsigned int number_of_elites,
+		     double population_growth=1.0,
+		     unsigned int max_population_size=0);
+      virtual ~RestartPolicy ();
+
+      inline unsigned int getMaxUnchangedSteps () const;
+      inline unsigned int getNumberOfElites () const;
+      inline double getPopulationGrowth () const;
+      inline unsigned int getMaxPopulationSize () const;
+
+      virtual void reset ();
+      virtual bool stagnated (unsigned int index,
+			      const Population* population);
+
+      unsigned int computePopulationSize (unsigned int size) const;
+
+    private:
+      unsigned int _max_unchanged_steps;
+      unsigned int _number_of_elites;
+      double _population_growth;
+      unsigned int _max_population_size;
+
+      std::vector<double> _last_value;
+      std::vector<unsigned int> _unchanged_steps;
+    };
+
+
+    //#***********************************************************************
+    // Inline functions
+    //#***********************************************************************
+
+    /* Return the number of unchanged steps until a restart is triggered */
+    inline unsigned int RestartPolicy::getMaxUnchangedSteps () const
+    {
+      return _max_unchanged_steps;
+    }
+
+    /* Return the number of individuals kept in the elite archive */
+    inline unsigned int RestartPolicy::getNumberOfElites () const
+    {
+      return _number_of_elites;
+    }
+
+    /* Return the population growth factor applied on each restart */
+    inline double RestartPolicy::getPopulationGrowth () const
+    {
+      return _population_growth;
+    }
+
+    /* Return the maximum population size (0 means unlimited) */
+    inline unsigned int RestartPolicy::getMaxPopulationSize () const
+    {
+      return _max_population_size;
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
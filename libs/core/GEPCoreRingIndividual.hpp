@@ -8,35 +8,181 @@
 #define __GEPCoreRingIndividual_hpp__
 
 #include "GEPCoreCrossover.hpp"
+#include "GEPCoreDiversity.hpp"
+#include "GEPCoreEvaluator.hpp"
 #include "GEPCoreIndividual.hpp"
 #include "GEPCoreMutation.hpp"
+#include "GEPCoreSurrogate.hpp"
 
 #include <GEPRandom.hpp>
+
+#include <QtCore/QtGlobal>
+
+#include <boost/unordered_map.hpp>
 #include <vector>
 
 namespace GEP {
   namespace Core {
 
+    class Neighbourhood;
+
     /*!
      * Individual represented by a ring sequence
      */
     class RingIndividual : public GEP::Core::Individual
     {
     public:
-      RingIndividual ();
+      RingIndividual (bool round_trip=true);
       RingIndividual (const RingIndividual& toCopy);
       virtual ~RingIndividual ();
 
       virtual Individual* clone () const = 0;
+      virtual quint64 getHash () const;
 
       typedef unsigned int Gene;
       typedef std::vector<Gene> Chromosome;
 
+      inline bool isRoundTrip () const;
+
       inline const Chromosome& getChromosome () const;
       void setChromosome (const Chromosome& chromosome);
-      
+
+      void invert (unsigned int position, unsigned int length);
+      void displace (unsigned int position, unsigned int length,
+		     unsigned int distance);
+      void scramble (unsigned int position, unsigned int length,
+		     const Random& random);
+
+      /*
+       * Range of changed chromosome positions
+       *
+       * The range may wrap around the chromosome end. The genes found in
+       * the range before the change are stored in the former genes vector
+       * starting at 'offset'.
+       */
+      struct Change
+      {
+	unsigned int position;
+	unsigned int length;
+	unsigned int offset;
+      };
+
+      typedef std::vector<Change> ChangeLog;
+
+      inline bool hasChangeLog () const;
+      inline const ChangeLog& getChangeLog () const;
+      inline const Chromosome& getFormerGenes () const;
+
+      static quint64 computeHash (const Chromosome& chromosome,
+				  bool round_trip=true);
+
     private:
+      void beginChange (unsigned int position, unsigned int length);
+      void endChange (unsigned int position, unsigned int length);
+
+      void reverse (unsigned int position, unsigned int length);
+      quint64 computeRangeHash (unsigned int position,
+				unsigned int length) const;
+
+    private:
+      bool _round_trip;
       Chromosome _chromosome;
+      quint64 _hash;
+
+      bool _has_change_log;
+      ChangeLog _change_log;
+      Chromosome _former_genes;
+    };
+
+    /*
+     * Edge based diversity metrics for ring based individuals
+     *
+     * The metrics are derived from the undirected edges (neighbouring gene
+     * pairs) of all individuals, which is what matters for ring genomes.
+     * Adding or removing an individual costs O(L) for chromosome length L.
+     */
+    class RingDiversityMetrics : public DiversityMetrics
+    {
+    public:
+      RingDiversityMetrics ();
+      virtual ~RingDiversityMetrics ();
+
+      virtual DiversityMetrics* create () const;
+
+      virtual void add (const Individual* individual);
+      virtual void remove (const Individual* individual);
+      virtual void clear ();
+
+      virtual unsigned int size () const;
+
+      virtual double getEntropy () const;
+      virtual double getAverageDistance () const;
+      virtual unsigned int getNumberOfGenotypes () const;
+
+    private:
+      void update (const RingIndividual* ring, bool add);
+
+    private:
+      typedef boost::unordered_map<quint64, unsigned int> CountMap;
+
+      CountMap _edge_counts;
+      CountMap _genotype_counts;
+
+      unsigned int _size;
+      unsigned int _chromosome_size;
+
+      double _edge_count_entropy_sum;
+      double _shared_edge_pairs;
+    };
+
+    /*
+     * Linear surrogate model over the edges of ring based individuals
+     *
+     * The predicted objective is a bias plus the sum of weights of the
+     * undirected edges contained in the ring, which fits additive
+     * objectives like route lengths well. The weights are stored in a hashed
+     * table of fixed size and trained via normalized least mean squares.
+     */
+    class RingEdgeSurrogateModel : public SurrogateModel
+    {
+    public:
+      RingEdgeSurrogateModel (unsigned int min_samples=1000,
+			      double learning_rate=0.5,
+			      unsigned int number_of_weights=65536);
+      virtual ~RingEdgeSurrogateModel ();
+
+      virtual bool isTrained () const;
+      virtual double predict (const Individual* individual) const;
+      virtual void train (const Individual* individual, double objective);
+      virtual void clear ();
+
+    private:
+      inline unsigned int getWeightIndex (RingIndividual::Gene gene_1,
+					  RingIndividual::Gene gene_2) const;
+
+    private:
+      unsigned int _min_samples;
+      double _learning_rate;
+
+      std::vector<double> _weights;
+      double _bias;
+      unsigned int _number_of_samples;
+    };
+
+    /*
+     * Binary genome encoding for ring based individuals
+     *
+     * The chromosome is written as its length followed by the genes, all as
+     * 32 bit integers in native byte order.
+     */
+    class RingGenomeEncoder : public GenomeEncoder
+    {
+    public:
+      RingGenomeEncoder ();
+      virtual ~RingGenomeEncoder ();
+
+      virtual void encode (const Individual* individual,
+			   std::string* buffer) const;
     };
 
     /*
@@ -54,7 +200,7 @@ namespace GEP {
 
     private:
       void adaptChromosome (unsigned int index_1, unsigned int index_2,
-			    const std::vector<RingIndividual::Gene>& cut,
+			    const RingIndividual::Chromosome& donor,
 			    RingIndividual::Chromosome& chromosome) const;
 
     private:
@@ -75,13 +221,173 @@ namespace GEP {
 			      Population* target) const;
 
     private:
-      void insertSequence (const std::vector<RingIndividual::Gene>& sequence,
+      void insertSequence (const RingIndividual::Chromosome& donor,
+			   unsigned int index_1, unsigned int index_2,
 			   RingIndividual::Chromosome& chromosome) const;
 
     private:
       Random _random;
     };
 
+    /*
+     * Order crossover operator (OX1) for ring based individuals
+     *
+     * Each child keeps a sequence of one parent and receives the remaining
+     * genes in the order of the other parent.
+     */
+    class RingOrderCrossoverOperator : public CrossoverOperator
+    {
+    public:
+      RingOrderCrossoverOperator ();
+      virtual ~RingOrderCrossoverOperator ();
+
+      virtual void crossover (const Individual* individual1,
+			      const Individual* individual2,
+			      Population* target) const;
+
+    private:
+      void fillChromosome (const RingIndividual::Chromosome& parent_1,
+			   const RingIndividual::Chromosome& parent_2,
+			   unsigned int index_1, unsigned int index_2,
+			   RingIndividual::Chromosome& chromosome) const;
+
+    private:
+      Random _random;
+    };
+
+    /*
+     * Order based crossover operator (OX2) for ring based individuals
+     *
+     * The genes at randomly selected positions of one parent are reordered
+     * in the other parent to match their order there.
+     */
+    class RingOrderBasedCrossoverOperator : public CrossoverOperator
+    {
+    public:
+      RingOrderBasedCrossoverOperator (double selection_probability=0.5);
+      virtual ~RingOrderBasedCrossoverOperator ();
+
+      virtual void crossover (const Individual* individual1,
+			      const Individual* individual2,
+			      Population* target) const;
+
+    private:
+      void reorderChromosome (const RingIndividual::Chromosome& parent_1,
+			      const RingIndividual::Chromosome& parent_2,
+			      const std::vector<unsigned int>& positions,
+			      RingIndividual::Chromosome& chromosome) const;
+
+    private:
+      double _selection_probability;
+      Random _random;
+    };
+
+    /*
+     * Cycle crossover operator for ring based individuals
+     */
+    class RingCycleCrossoverOperator : public CrossoverOperator
+    {
+    public:
+      RingCycleCrossoverOperator ();
+      virtual ~RingCycleCrossoverOperator ();
+
+      virtual void crossover (const Individual* individual1,
+			      const Individual* individual2,
+			      Population* target) const;
+    };
+
+    /*
+     * Edge recombination crossover operator for ring based individuals
+     *
+     * The children are built mostly from edges present in one of the parents,
+     * which preserves the adjacency information relevant for tour lengths.
+     */
+    class RingEdgeRecombinationCrossoverOperator : public CrossoverOperator
+    {
+    public:
+      RingEdgeRecombinationCrossoverOperator ();
+      virtual ~RingEdgeRecombinationCrossoverOperator ();
+
+      virtual void crossover (const Individual* individual1,
+			      const Individual* individual2,
+			      Population* target) const;
+
+    private:
+      void buildChromosome (const RingIndividual::Chromosome& parent_1,
+			    const RingIndividual::Chromosome& parent_2,
+			    RingIndividual::Gene start,
+			    RingIndividual::Chromosome& chromosome) const;
+
+    private:
+      Random _random;
+    };
+
+    /*
+     * Inversion mutation operator for ring based individuals
+     *
+     * With the given probability, reverses a random chromosome sequence,
+     * which is a 2-opt move on the tour. Since reversing a sequence or its
+     * complement yields the same ring, the shorter one is reversed.
+     */
+    class RingInversionMutationOperator : public MutationOperator
+    {
+    public:
+      RingInversionMutationOperator (double mutation_probability,
+				     unsigned int max_length=0);
+      virtual ~RingInversionMutationOperator ();
+
+      virtual Individual* mutate (const Individual* source) const;
+
+    private:
+      double _mutation_probability;
+      unsigned int _max_length;
+      Random _random;
+    };
+
+    /*
+     * Displacement mutation operator for ring based individuals
+     *
+     * With the given probability, moves a short random chromosome sequence
+     * to another position, which is an or-opt move on the tour.
+     */
+    class RingDisplacementMutationOperator : public MutationOperator
+    {
+    public:
+      RingDisplacementMutationOperator (double mutation_probability,
+					unsigned int max_length=3,
+					unsigned int max_distance=0);
+      virtual ~RingDisplacementMutationOperator ();
+
+      virtual Individual* mutate (const Individual* source) const;
+
+    private:
+      double _mutation_probability;
+      unsigned int _max_length;
+      unsigned int _max_distance;
+      Random _random;
+    };
+
+    /*
+     * Scramble mutation operator for ring based individuals
+     *
+     * With the given probability, randomly permutes the genes of a random
+     * chromosome sequence.
+     */
+    class RingScrambleMutationOperator : public MutationOperator
+    {
+    public:
+      RingScrambleMutationOperator (double mutation_probability,
+				    unsigned int max_length=8);
+      virtual ~RingScrambleMutationOperator ();
+
+      virtual Individual* mutate (const Individual* source) const;
+
+    private:
+      double _mutation_probability;
+      unsigned int _max_length;
+      Random _random;
+    };
+
     /*
      * Mutation operator for ring based individuals
      */
@@ -96,17 +402,106 @@ namespace GEP {
       
       virtual Individual* mutate (const Individual* source) const;
 
+    protected:
+      RingUniformMutationOperator (const QString& description,
+				   double mutation_probability);
+
     private:
       double _mutation_probability;
       Random _random;
     };
-    
+
+    /*
+     * Uniform mutation operator adapting its mutation probability via the
+     * 1/5th success rule
+     */
+    class RingSuccessRuleMutationOperator : public RingUniformMutationOperator
+    {
+    public:
+      RingSuccessRuleMutationOperator (double mutation_probability,
+				       double min_probability,
+				       double max_probability,
+				       double adaptation_factor=0.85);
+      virtual ~RingSuccessRuleMutationOperator ();
+
+      virtual Individual* mutate (const Individual* source) const;
+      virtual void update (const std::vector<const Population*>& populations);
+
+    private:
+      double _min_probability;
+      double _max_probability;
+      double _adaptation_factor;
+    };
+
+    /*
+     * Mutation operator with self adaptive per individual mutation rates
+     */
+    class RingSelfAdaptiveMutationOperator : public MutationOperator
+    {
+    public:
+      RingSelfAdaptiveMutationOperator (double initial_rate,
+					double min_rate,
+					double max_rate,
+					double learning_rate=0.3);
+      virtual ~RingSelfAdaptiveMutationOperator ();
+
+      virtual Individual* mutate (const Individual* source) const;
+
+    private:
+      double _initial_rate;
+      double _min_rate;
+      double _max_rate;
+      double _learning_rate;
+
+      Random _random;
+    };
+
+    /*
+     * Local search mutation operator for ring based individuals
+     *
+     * With the given probability, improves the chromosome by 2-opt and
+     * or-opt moves until no improving move is left or the move budget is
+     * used up. Only edges to candidate neighbours are tried and genes whose
+     * surrounding did not change are skipped ("don't look bits"), so a
+     * search costs about O(L) for chromosome length L. The operator is
+     * thread safe.
+     */
+    class RingLocalSearchMutationOperator : public MutationOperator
+    {
+    public:
+      RingLocalSearchMutationOperator (const Neighbourhood* neighbourhood,
+				       double mutation_probability,
+				       unsigned int max_moves=1000,
+				       bool round_trip=true);
+      virtual ~RingLocalSearchMutationOperator ();
+
+      virtual Individual* mutate (const Individual* source) const;
+      virtual bool isThreadSafe () const;
+
+    private:
+      const Neighbourhood* _neighbourhood;
+      double _mutation_probability;
+      unsigned int _max_moves;
+      bool _round_trip;
+    };
+
 
     
     //#***********************************************************************
     // Inline functions
     //#***********************************************************************
 
+    /*
+     * Check if the chromosome is a closed ring
+     *
+     * \return 'false' if the chromosome is an open path, so the edge from
+     *         the last gene to the first one is no part of the genotype
+     */
+    inline bool RingIndividual::isRoundTrip () const
+    {
+      return _round_trip;
+    }
+
     /* Return the individuals genes */
     inline const RingIndividual::Chromosome& RingIndividual::getChromosome ()
       const
@@ -114,6 +509,31 @@ namespace GEP {
       return _chromosome;
     }
 
+    /*
+     * Return if the change log is complete
+     *
+     * \return true, if all chromosome changes since the parent objective
+     *         was known are recorded in the change log
+     */
+    inline bool RingIndividual::hasChangeLog () const
+    {
+      return _has_change_log;
+    }
+
+    /* Return the chromosome changes since the parent objective was known */
+    inline const RingIndividual::ChangeLog& RingIndividual::getChangeLog ()
+      const
+    {
+      return _change_log;
+    }
+
+    /* Return the genes replaced by the logged changes */
+    inline const RingIndividual::Chromosome& RingIndividual::getFormerGenes ()
+      const
+    {
+      return _former_genes;
+    }
+
     /* Return the mutation probability */
     inline double RingUniformMutationOperator::getMutationProbability () const
     {
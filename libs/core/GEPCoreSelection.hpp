@@ -10,6 +10,12 @@
 #include "GEPCoreOperator.hpp"
 #include <GEPRandom.hpp>
 
+#include <QtCore/QMutex>
+
+#include <map>
+#include <utility>
+#include <vector>
+
 namespace GEP {
   namespace Core {
 
@@ -17,6 +23,11 @@ namespace GEP {
 
     /*
      * Base class for all individual selection operators
+     *
+     * Operators do not copy the selected individuals but append their
+     * indices in the source population to the selection, one per
+     * individual of the source population. Copies are made only where
+     * modified offspring are created from them.
      */
     class SelectionOperator : public Operator
     {
@@ -25,7 +36,7 @@ namespace GEP {
       virtual ~SelectionOperator ();
 
       virtual void select (const Population* source,
-			   Population* target) const = 0;
+			   std::vector<unsigned int>* selection) const = 0;
     };
     
     /*
@@ -38,14 +49,71 @@ namespace GEP {
       virtual ~BestSelectionOperator ();
 
       virtual void select (const Population* source,
-			   Population* target) const;
+			   std::vector<unsigned int>* selection) const;
 
     private:
       Random _random;
     };
     
+    /*
+     * Truncation selection operator
+     *
+     * Selects uniformly among the best 'ratio' share of the individuals.
+     * The best individuals are determined via partial sorting in O(N).
+     */
+    class TruncationSelectionOperator : public SelectionOperator
+    {
+    public:
+      TruncationSelectionOperator (double ratio=0.5);
+      virtual ~TruncationSelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+
+    protected:
+      TruncationSelectionOperator (const QString& description, double ratio);
+
+      unsigned int getNumberOfSelectable (unsigned int size) const;
+
+      typedef std::pair<double, unsigned int> Candidate;
+      static void selectBest (std::vector<Candidate>* candidates,
+			      unsigned int number);
+
+      void addSelected (const Population* source,
+			const std::vector<Candidate>& best,
+			std::vector<unsigned int>* selection) const;
+
+    private:
+      double _ratio;
+      Random _random;
+    };
+
+    /*
+     * Truncation selection operator for large populations
+     *
+     * The population is split into chunks whose best individuals are
+     * determined in parallel threads and merged afterwards.
+     */
+    class ParallelTruncationSelectionOperator
+      : public TruncationSelectionOperator
+    {
+    public:
+      ParallelTruncationSelectionOperator (double ratio=0.5,
+					   unsigned int number_of_threads=0);
+      virtual ~ParallelTruncationSelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+
+    private:
+      unsigned int _number_of_threads;
+    };
+
     /*
      * Roulette based selection operator
+     *
+     * Fitness proportionate selection using an alias table, so each
+     * selection takes O(1) after O(N) preparation.
      */
     class RouletteSelectionOperator : public SelectionOperator
     {
@@ -54,9 +122,197 @@ namespace GEP {
       virtual ~RouletteSelectionOperator ();
 
       virtual void select (const Population* source,
-			   Population* target) const;
+			   std::vector<unsigned int>* selection) const;
+
+    private:
+      Random _random;
+    };
+
+    /*
+     * Stochastic universal sampling operator
+     *
+     * Fitness proportionate selection with a single random offset and
+     * equally spaced pointers. Each individual is selected either
+     * floor (N * p) or ceil (N * p) times for its selection probability p,
+     * which is the minimum possible variance.
+     */
+    class StochasticUniversalSamplingOperator : public SelectionOperator
+    {
+    public:
+      StochasticUniversalSamplingOperator ();
+      virtual ~StochasticUniversalSamplingOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+
+    private:
+      Random _random;
+    };
+
+    /*
+     * Base class for rank based selection operators
+     *
+     * The selection probability depends only on the fitness rank of an
+     * individual, not on the fitness value itself. The cumulative
+     * probability tables depend only on the population size, so they are
+     * computed once per size and shared by all subsequent selections.
+     */
+    class RankSelectionOperator : public SelectionOperator
+    {
+    public:
+      RankSelectionOperator (const QString& description);
+      virtual ~RankSelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+
+    protected:
+      virtual double computeWeight (unsigned int rank,
+				    unsigned int size) const = 0;
+
+    private:
+      const std::vector<double>& getTable (unsigned int size) const;
+
+    private:
+      mutable QMutex _mutex;
+      mutable std::map<unsigned int, std::vector<double> > _tables;
+
+      Random _random;
+    };
+
+    /*
+     * Linear rank based selection operator
+     *
+     * The best individual is selected with 'pressure' times the average
+     * probability, the worst with '2 - pressure' times of it.
+     */
+    class LinearRankSelectionOperator : public RankSelectionOperator
+    {
+    public:
+      LinearRankSelectionOperator (double pressure=1.5);
+      virtual ~LinearRankSelectionOperator ();
+
+    protected:
+      virtual double computeWeight (unsigned int rank,
+				    unsigned int size) const;
+
+    private:
+      double _pressure;
+    };
+
+    /*
+     * Exponential rank based selection operator
+     *
+     * Each individual is 'base' times as likely to be selected as the next
+     * better one.
+     */
+    class ExponentialRankSelectionOperator : public RankSelectionOperator
+    {
+    public:
+      ExponentialRankSelectionOperator (double base=0.99);
+      virtual ~ExponentialRankSelectionOperator ();
+
+    protected:
+      virtual double computeWeight (unsigned int rank,
+				    unsigned int size) const;
+
+    private:
+      double _base;
+    };
+
+    /*
+     * Tournament selection operator
+     *
+     * Each selected individual is the winner of a tournament among
+     * 'tournament_size' randomly drawn individuals. With a winner
+     * probability p < 1, the best candidate wins with probability p, the
+     * second best with p * (1 - p) and so on. Only the fitness values of
+     * the candidates are compared, so no global ordering is needed.
+     */
+    class TournamentSelectionOperator : public SelectionOperator
+    {
+    public:
+      TournamentSelectionOperator (unsigned int tournament_size=2,
+				   double winner_probability=1.0);
+      virtual ~TournamentSelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+
+    private:
+      unsigned int _tournament_size;
+      double _winner_probability;
+      Random _random;
+    };
+
+    /*
+     * Lexicase selection operator
+     *
+     * Works on individuals with one objective value (error) per test case,
+     * where lower is better. Each selection event considers the cases in a
+     * random order and keeps only the candidates with the best error on
+     * each case until a single candidate remains. The selection events are
+     * independent and executed in parallel threads.
+     */
+    class LexicaseSelectionOperator : public SelectionOperator
+    {
+    public:
+      LexicaseSelectionOperator (unsigned int number_of_threads=0);
+      virtual ~LexicaseSelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+
+    protected:
+      LexicaseSelectionOperator (const QString& description,
+				 unsigned int number_of_threads);
+
+      virtual void computeEpsilons (const std::vector<double>& errors,
+				    unsigned int number_of_individuals,
+				    std::vector<double>* epsilons) const;
+
+    private:
+      unsigned int _number_of_threads;
+      Random _random;
+    };
+
+    /*
+     * Epsilon lexicase selection operator
+     *
+     * Variant of lexicase selection for continuous errors: on each case, all
+     * candidates within the median absolute deviation of the case errors
+     * from the best candidate error survive.
+     */
+    class EpsilonLexicaseSelectionOperator : public LexicaseSelectionOperator
+    {
+    public:
+      EpsilonLexicaseSelectionOperator (unsigned int number_of_threads=0);
+      virtual ~EpsilonLexicaseSelectionOperator ();
+
+    protected:
+      virtual void computeEpsilons (const std::vector<double>& errors,
+				    unsigned int number_of_individuals,
+				    std::vector<double>* epsilons) const;
+    };
+
+    /*
+     * NSGA-II style selection operator for multi objective individuals
+     *
+     * Individuals are selected via tournaments using the crowded comparison:
+     * the lower Pareto front rank wins, within the same front the larger
+     * crowding distance.
+     */
+    class NonDominatedSortingSelectionOperator : public SelectionOperator
+    {
+    public:
+      NonDominatedSortingSelectionOperator (unsigned int tournament_size=2);
+      virtual ~NonDominatedSortingSelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
 
     private:
+      unsigned int _tournament_size;
       Random _random;
     };
     
@@ -0,0 +1,37 @@
+/*
+ * GEPCoreSurrogate.hpp - Surrogate models approximating the objective
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCoreSurrogate_hpp__
+#define __GEPCoreSurrogate_hpp__
+
+namespace GEP {
+  namespace Core {
+
+    class Individual;
+
+    /*
+     * Base class for cheap learned approximations of the objective
+     *
+     * The controller uses the model to rank candidate offspring, so only the
+     * most promising ones are evaluated exactly. The model is trained online
+     * from the exact evaluations.
+     */
+    class SurrogateModel
+    {
+    public:
+      SurrogateModel ();
+      virtual ~SurrogateModel ();
+
+      virtual bool isTrained () const = 0;
+      virtual double predict (const Individual* individual) const = 0;
+      virtual void train (const Individual* individual, double objective) = 0;
+      virtual void clear () = 0;
+    };
+
+  } // namespace Core
+} // namespace GEP
+
+#endif
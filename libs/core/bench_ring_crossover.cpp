@@ -0,0 +1,274 @@
+/*
+ * bench_ring_crossover.cpp - Benchmark for the resorting crossover
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCorePopulation.hpp"
+#include "GEPCoreRingIndividual.hpp"
+
+#include <GEPException.hpp>
+#include <GEPRandom.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sys/time.h>
+
+//
+// Number of genes processed per measurement
+//
+static const unsigned int GENES_PER_MEASUREMENT = 20000000;
+
+//
+// Maximum time spent per measurement in seconds
+//
+static const double MAX_TIME = 5.0;
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::BenchIndividual
+    //#***********************************************************************
+
+    class BenchIndividual : public RingIndividual
+    {
+    public:
+      BenchIndividual () : RingIndividual () {}
+      BenchIndividual (const BenchIndividual& toCopy)
+	: RingIndividual (toCopy) {}
+      virtual ~BenchIndividual () {}
+
+      virtual Individual* clone () const
+      {
+	return new BenchIndividual (*this);
+      }
+    };
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::BenchPopulation
+    //#***********************************************************************
+
+    class BenchPopulation : public Population
+    {
+    public:
+      BenchPopulation () : Population () {}
+      virtual ~BenchPopulation () {}
+
+      virtual void computeFitness () const {}
+    };
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::SetResortingCrossoverOperator
+    //#***********************************************************************
+
+    /*
+     * Former std::set based resorting crossover, kept as reference
+     */
+    class SetResortingCrossoverOperator : public CrossoverOperator
+    {
+    public:
+      SetResortingCrossoverOperator ()
+	: CrossoverOperator ("Resorting crossover (std::set)") {}
+      virtual ~SetResortingCrossoverOperator () {}
+
+      virtual void crossover (const Individual* individual_1,
+			      const Individual* individual_2,
+			      Population* target) const;
+
+    private:
+      void insertSequence (const std::vector<RingIndividual::Gene>& sequence,
+			   RingIndividual::Chromosome& chromosome) const;
+
+    private:
+      Random _random;
+    };
+
+    /* Execute crossover operation */
+    void SetResortingCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      const RingIndividual* ring_1 =
+        dynamic_cast<const RingIndividual*> (individual_1);
+      const RingIndividual* ring_2 =
+        dynamic_cast<const RingIndividual*> (individual_2);
+
+      RingIndividual::Chromosome chromosome_1 = ring_1->getChromosome ();
+      RingIndividual::Chromosome chromosome_2 = ring_2->getChromosome ();
+
+      unsigned int size = chromosome_1.size ();
+      unsigned int index_1 = _random.getInt (0, size - 1);
+      unsigned int index_2 = index_1 + _random.getInt (1, size - 2);
+
+      std::vector<RingIndividual::Gene> cut_1 (index_2 - index_1 + 1);
+      std::vector<RingIndividual::Gene> cut_2 (index_2 - index_1 + 1);
+
+      for (unsigned int i=index_1; i <= index_2; ++i)
+        {
+          cut_1[(i - index_1) % size] = chromosome_1[i % size];
+          cut_2[(i - index_1) % size] = chromosome_2[i % size];
+        }
+
+      insertSequence (cut_1, chromosome_2);
+      insertSequence (cut_2, chromosome_1);
+
+      RingIndividual* target_1 =
+	dynamic_cast<RingIndividual*> (ring_1->clone ());
+      target_1->setChromosome (chromosome_1);
+      target->addIndividual (target_1);
+
+      RingIndividual* target_2 =
+	dynamic_cast<RingIndividual*> (ring_2->clone ());
+      target_2->setChromosome (chromosome_2);
+      target->addIndividual (target_2);
+    }
+
+    /* Insert cut sequence into chromosome */
+    void SetResortingCrossoverOperator::insertSequence
+    (const std::vector<RingIndividual::Gene>& sequence,
+     RingIndividual::Chromosome& chromosome) const
+    {
+      typedef RingIndividual::Gene Gene;
+
+      std::set<Gene> inserted_genes (sequence.begin (), sequence.end ());
+
+      RingIndividual::Chromosome target;
+
+      unsigned int index = std::numeric_limits<unsigned int>::max ();
+      for (unsigned int i=0; i < chromosome.size (); ++i)
+      {
+        const Gene& gene = chromosome[i];
+
+        if (inserted_genes.find (gene) == inserted_genes.end ())
+          target.push_back (gene);
+        else if (gene == sequence[0])
+          index = target.size ();
+      }
+
+      std::vector<Gene>::iterator insertion_pos = target.begin ();
+      insertion_pos += index;
+
+      target.insert (insertion_pos, sequence.begin (), sequence.end ());
+
+      chromosome = target;
+    }
+
+
+    //#***********************************************************************
+    // Benchmark functions
+    //#***********************************************************************
+
+    /*
+     * Return the current time in seconds
+     */
+    static double getTime ()
+    {
+      struct timeval tv;
+      gettimeofday (&tv, 0);
+
+      return tv.tv_sec + tv.tv_usec / 1000000.0;
+    }
+
+    /*
+     * Set a random permutation as chromosome
+     */
+    static void setRandomChromosome (RingIndividual* individual,
+				     unsigned int size, const Random& random)
+    {
+      RingIndividual::Chromosome chromosome (size);
+      for (unsigned int i=0; i < size; ++i)
+	chromosome[i] = i;
+
+      for (unsigned int i=size - 1; i > 0; --i)
+	std::swap (chromosome[i], chromosome[random.getInt (0, i)]);
+
+      individual->setChromosome (chromosome);
+    }
+
+    /*
+     * Measure the time per crossover in microseconds
+     */
+    static double measure (const CrossoverOperator& crossover_operator,
+			   unsigned int size)
+    {
+      Random random;
+
+      BenchIndividual ring_1;
+      BenchIndividual ring_2;
+
+      setRandomChromosome (&ring_1, size, random);
+      setRandomChromosome (&ring_2, size, random);
+
+      unsigned int runs = std::max (GENES_PER_MEASUREMENT / size, 10u);
+      unsigned int executed = 0;
+
+      double start = getTime ();
+
+      while (executed < runs && getTime () - start < MAX_TIME)
+	{
+	  BenchPopulation target;
+	  crossover_operator.crossover (&ring_1, &ring_2, &target);
+	  ++executed;
+	}
+
+      return (getTime () - start) * 1000000.0 / executed;
+    }
+
+    /*
+     * Compare the resorting crossover implementations
+     */
+    static void benchResortingCrossover ()
+    {
+      std::cout << "*** Resorting crossover, time per crossover in us"
+		<< std::endl;
+      std::cout << std::endl;
+      std::cout << std::setw (10) << "L"
+		<< std::setw (14) << "std::set"
+		<< std::setw (14) << "linear"
+		<< std::setw (10) << "speedup" << std::endl;
+
+      SetResortingCrossoverOperator set_operator;
+      RingResortingCrossoverOperator linear_operator;
+
+      for (unsigned int size=100; size <= 100000; size *= 10)
+	{
+	  double set_time = measure (set_operator, size);
+	  double linear_time = measure (linear_operator, size);
+
+	  std::cout << std::setw (10) << size
+		    << std::setw (14) << std::fixed << std::setprecision (2)
+		    << set_time
+		    << std::setw (14) << linear_time
+		    << std::setw (10) << std::setprecision (1)
+		    << set_time / linear_time << std::endl;
+	}
+
+      std::cout << std::endl;
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+  try
+  {
+    GEP::Core::benchResortingCrossover ();
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -9,22 +9,63 @@
 #include "GEPCoreController.hpp"
 #include "GEPCoreCriterion.hpp"
 #include "GEPCoreCrossover.hpp"
+#include "GEPCoreDiversity.hpp"
+#include "GEPCoreEvaluationCache.hpp"
+#include "GEPCoreEvaluator.hpp"
 #include "GEPCoreIndividual.hpp"
 #include "GEPCoreMutation.hpp"
 #include "GEPCorePopulation.hpp"
+#include "GEPCorePopulationSize.hpp"
+#include "GEPCoreRestart.hpp"
 #include "GEPCoreSelection.hpp"
+#include "GEPCoreSurrogate.hpp"
 
 #include <GEPDebug.hpp>
 #include <GEPException.hpp>
+#include <GEPParallel.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <set>
+#include <math.h>
 
 
 namespace GEP
 {
   namespace Core
   {
+    namespace {
+
+      /*
+       * Task mutating a range of offspring with thread safe operators
+       */
+      class MutationTask : public ParallelTask
+      {
+      public:
+	MutationTask (const std::vector<const Individual*>& sources,
+		      const std::vector<const MutationOperator*>& operators,
+		      std::vector<Individual*>* mutated)
+	  : _sources (sources), _operators (operators), _mutated (mutated)
+	{
+	}
+
+	virtual void execute (unsigned int /*chunk*/, unsigned int begin,
+			      unsigned int end)
+	{
+	  for (unsigned int i=begin; i < end; ++i)
+	    if (_operators[i]->isThreadSafe ())
+	      (*_mutated)[i] = _operators[i]->mutate (_sources[i]);
+	}
+
+      private:
+	const std::vector<const Individual*>& _sources;
+	const std::vector<const MutationOperator*>& _operators;
+	std::vector<Individual*>* _mutated;
+      };
+
+    }
+
     //#***********************************************************************
     // CLASS GEP::Core::Controller
     //#***********************************************************************
@@ -34,8 +75,23 @@ namespace GEP
       : _number_of_populations (0),
 	_number_of_individuals (0),
 	_crossover_probability (0.5),
+	_reject_duplicates     (false),
+	_number_of_duplicate_retries (3),
+	_number_of_mutation_threads (1),
+	_surrogate_fraction    (0.5),
 	_population_creator    (0),
+	_restart_policy        (0),
+	_population_size_controller (0),
+	_diversity_metrics     (0),
+	_evaluation_cache      (0),
+	_evaluator             (0),
+	_surrogate_model       (0),
 	_step                  (0),
+	_number_of_restarts    (0),
+	_number_of_evaluations (0),
+	_number_of_saved_evaluations (0),
+	_number_of_predictions (0),
+	_number_of_surrogate_hits (0),
 	_stopped               (false)
     {
     }
@@ -52,6 +108,8 @@ namespace GEP
       _populations.clear ();
       emit signalPopulationsChanged (this);
 
+      clearEliteArchive ();
+
       //
       // Delete registered operators and criterions
       //
@@ -76,6 +134,24 @@ namespace GEP
       //
       delete _population_creator;
       _population_creator = 0;
+
+      delete _restart_policy;
+      _restart_policy = 0;
+
+      delete _population_size_controller;
+      _population_size_controller = 0;
+
+      delete _diversity_metrics;
+      _diversity_metrics = 0;
+
+      delete _evaluation_cache;
+      _evaluation_cache = 0;
+
+      delete _evaluator;
+      _evaluator = 0;
+
+      delete _surrogate_model;
+      _surrogate_model = 0;
     }
 
     /* Set the number of parallel existing populations per step */
@@ -120,6 +196,170 @@ namespace GEP
       _population_creator = population_creator;
     }
 
+    /*
+     * Set the restart policy for stagnated populations
+     *
+     * \param restart_policy Policy to use or NULL to disable restarts. The
+     *                       controller owns the policy object and will
+     *                       destroy it upon deletion.
+     */
+    void Controller::setRestartPolicy (RestartPolicy* restart_policy)
+    {
+      if (_restart_policy != 0 && _restart_policy != restart_policy)
+        delete _restart_policy;
+
+      _restart_policy = restart_policy;
+    }
+
+    /*
+     * Set the diversity metrics maintained for each population
+     *
+     * \param diversity_metrics Prototype of the metrics to attach to each
+     *                          population or NULL to disable diversity
+     *                          tracking. The controller owns the object and
+     *                          will destroy it upon deletion.
+     */
+    void Controller::setDiversityMetrics (DiversityMetrics* diversity_metrics)
+    {
+      if (_diversity_metrics != 0 && _diversity_metrics != diversity_metrics)
+        delete _diversity_metrics;
+
+      _diversity_metrics = diversity_metrics;
+    }
+
+    /*
+     * Set the cache for already computed objective values
+     *
+     * Individuals whose genotype hash is found in the cache are not
+     * evaluated again. The cache is kept across initializations.
+     *
+     * \param evaluation_cache Cache to use or NULL to disable caching. The
+     *                         controller owns the cache and will destroy it
+     *                         upon deletion.
+     */
+    void Controller::setEvaluationCache (EvaluationCache* evaluation_cache)
+    {
+      if (_evaluation_cache != 0 && _evaluation_cache != evaluation_cache)
+        delete _evaluation_cache;
+
+      _evaluation_cache = evaluation_cache;
+    }
+
+    /*
+     * Set the evaluator computing the objectives outside of the populations
+     *
+     * All individuals of a population not evaluated yet are passed to the
+     * evaluator at once before the population computes the fitness values.
+     *
+     * \param evaluator Evaluator to use or NULL to let the populations
+     *                  compute the objectives. The controller owns the
+     *                  evaluator and will destroy it upon deletion.
+     */
+    void Controller::setEvaluator (Evaluator* evaluator)
+    {
+      if (_evaluator != 0 && _evaluator != evaluator)
+        delete _evaluator;
+
+      _evaluator = evaluator;
+    }
+
+    /*
+     * Set the surrogate model used to pre-screen offspring
+     *
+     * Once the model is trained, each step creates more offspring than
+     * needed and keeps only the ones with the best predicted objective (see
+     * setSurrogateFraction ()). The model is trained from all exact
+     * evaluations and kept across initializations.
+     *
+     * \param surrogate_model Model to use or NULL to disable pre-screening.
+     *                        The controller owns the model and will destroy
+     *                        it upon deletion.
+     */
+    void Controller::setSurrogateModel (SurrogateModel* surrogate_model)
+    {
+      if (_surrogate_model != 0 && _surrogate_model != surrogate_model)
+        delete _surrogate_model;
+
+      _surrogate_model = surrogate_model;
+    }
+
+    /*
+     * Set the fraction of candidate offspring which is evaluated exactly
+     *
+     * \param fraction Fraction in (0, 1]. With a fraction of 0.25, four
+     *                 times the needed number of offspring are created.
+     */
+    void Controller::setSurrogateFraction (double fraction)
+    {
+      if (fraction <= 0.0 || fraction > 1.0)
+        throw InternalException ("Illegal surrogate fraction value");
+
+      _surrogate_fraction = fraction;
+    }
+
+    /*
+     * Return the share of surrogate predictions which correctly told
+     * whether an offspring improves on its parent
+     */
+    double Controller::getSurrogateHitRate () const
+    {
+      if (_number_of_predictions == 0)
+        return 0.0;
+
+      return static_cast<double> (_number_of_surrogate_hits) /
+        _number_of_predictions;
+    }
+
+    /*
+     * Enable/disable rejection of duplicate genotypes
+     *
+     * If enabled, a mutated individual whose genotype is already present in
+     * the new population is mutated again. If all retries fail, the
+     * duplicate is kept, so the population size does not change.
+     */
+    void Controller::setRejectDuplicates (bool reject_duplicates)
+    {
+      _reject_duplicates = reject_duplicates;
+    }
+
+    /* Set the number of mutation retries for rejected duplicates */
+    void Controller::setNumberOfDuplicateRetries (unsigned int retries)
+    {
+      _number_of_duplicate_retries = retries;
+    }
+
+    /*
+     * Set the number of threads mutating the offspring
+     *
+     * Only operators declaring themselves thread safe are run in parallel,
+     * which pays off for expensive ones like local search.
+     *
+     * \param number_of_threads Number of threads, 1 for sequential mutation
+     *                          or 0 to use all hardware threads
+     */
+    void Controller::setNumberOfMutationThreads (unsigned int number_of_threads)
+    {
+      _number_of_mutation_threads = number_of_threads;
+    }
+
+    /*
+     * Set the controller adapting the population sizes between steps
+     *
+     * \param population_size_controller Size controller or NULL to keep the
+     *                                   population sizes fixed. The
+     *                                   controller owns the object and will
+     *                                   destroy it upon deletion.
+     */
+    void Controller::setPopulationSizeController
+    (PopulationSizeController* population_size_controller)
+    {
+      if (_population_size_controller != 0 &&
+	  _population_size_controller != population_size_controller)
+        delete _population_size_controller;
+
+      _population_size_controller = population_size_controller;
+    }
+
     /*
      * Register selection operator
      *
@@ -160,7 +400,7 @@ namespace GEP
      * \param func Operator to add. The controller owns the operator object
      *             afterwards and will destroy it upon deletion.
      */
-    void Controller::addMutationOperator (const MutationOperator* func)
+    void Controller::addMutationOperator (MutationOperator* func)
     {
       DV ("* Adding mutation operator, name=" << func->getDescription ());
 
@@ -195,6 +435,12 @@ namespace GEP
     bool Controller::initialize ()
     {
       _step = 0;
+      _number_of_restarts = 0;
+      _number_of_evaluations = 0;
+      _number_of_saved_evaluations = 0;
+      _number_of_predictions = 0;
+      _number_of_surrogate_hits = 0;
+      _predictions.clear ();
       _stopped = false;
 
       //
@@ -229,12 +475,23 @@ namespace GEP
 
       _populations.clear ();
 
+      clearEliteArchive ();
+      if (_restart_policy != 0)
+        _restart_policy->reset ();
+
+      if (_population_size_controller != 0)
+        _population_size_controller->reset ();
+
       //
       // Initialize all populations
       //
       for (unsigned int i=0; i < _number_of_populations; ++i)
-        _populations.push_back (_population_creator->create
-                                (_number_of_individuals));
+	{
+	  Population* population =
+	    _population_creator->create (_number_of_individuals);
+	  attachDiversityMetrics (population);
+	  _populations.push_back (population);
+	}
 
       computeFitness ();
       emit signalPopulationsChanged (this);
@@ -303,80 +560,263 @@ namespace GEP
 	  const Population* source_population = _populations[i];
 
 	  //
-	  // Step 1: Select individuals from the last step
+	  // Step 1: Select individuals from the last step. The parents are
+	  //         borrowed from the source population, which is kept until
+	  //         all offspring have been created.
 	  //
-	  std::auto_ptr<Population> selected_population
-	    (_population_creator->create (0));
+	  std::vector<unsigned int> selection;
 
 	  const SelectionOperator* selection_operator =
 	    _random.selectElement (_selection_operators);
-	  selection_operator->select (source_population,
-				      selected_population.get ());
+	  selection_operator->select (source_population, &selection);
 
-	  DV ("  Selection, selected population size=" <<
-	      selected_population->size ());
+	  if (_population_size_controller != 0)
+	    resizeSelection (&selection,
+			     _population_size_controller->computeSize
+			     (i, source_population));
 
-	  //
-	  // Step 2: Crossover
-	  //
-	  std::auto_ptr<Population> crossover_population
-	    (_population_creator->create (0));
+	  std::vector<const Individual*> parents;
+	  parents.reserve (selection.size ());
 
-	  for (unsigned int j=0; j < selected_population->size () / 2; ++j)
-	    {
-	      const Individual* individual_1 = (*selected_population)[j * 2];
-	      const Individual* individual_2 = 
-		(*selected_population)[j * 2 + 1];
-
-	      if (_random.getDouble (0.0, 1.0) < _crossover_probability)
-		{
-		  const CrossoverOperator* crossover_operator =
-		    _random.selectElement (_crossover_operators);
-		  crossover_operator->crossover (individual_1, individual_2,
-						 crossover_population.get ());
-		}
-	      else
-		{
-		  crossover_population->addIndividual (individual_1->clone ());
-		  crossover_population->addIndividual (individual_2->clone ());
-		}
-	    }
+	  for (unsigned int j=0; j < selection.size (); ++j)
+	    parents.push_back ((*source_population)[selection[j]]);
 
-	  DV ("  Crossover, crossover population size=" <<
-	      crossover_population->size ());
+	  DV ("  Selection, number of parents=" << parents.size ());
 
 	  //
-	  // Step 3: Mutation
+	  // Step 2: Crossover and mutation. With a trained surrogate model
+	  //         more offspring than needed are created and only the most
+	  //         promising ones are kept for exact evaluation.
 	  //
 	  std::auto_ptr<Population> target_population
 	    (_population_creator->create (0));
+	  attachDiversityMetrics (target_population.get ());
+	  target_population->setRejectDuplicates (_reject_duplicates);
 
-	  for ( Population::IndividualConstIterator j =
-		  crossover_population->getIndividualBegin ();
-		j != crossover_population->getIndividualEnd (); ++j )
+	  if (_surrogate_model != 0 && _surrogate_model->isTrained ())
 	    {
-	      const Individual* source = *j;
-	      const MutationOperator* mutation_operator =
-		_random.selectElement (_mutation_operators);
+	      std::auto_ptr<Population> candidate_population
+		(_population_creator->create (0));
+	      candidate_population->setRejectDuplicates (_reject_duplicates);
 
-	      target_population->addIndividual
-		(mutation_operator->mutate (source));
+	      unsigned int passes =
+		static_cast<unsigned int> (ceil (1.0 / _surrogate_fraction));
+	      for (unsigned int j=0; j < passes; ++j)
+		createOffspring (parents, candidate_population.get ());
+
+	      screenOffspring (candidate_population.get (),
+			       target_population.get (), parents.size ());
 	    }
+	  else
+	    createOffspring (parents, target_population.get ());
 
-	  DV ("  Mutation, target population size=" <<
+	  DV ("  Offspring, target population size=" <<
 	      target_population->size ());
 
 	  //
-	  // Step 4: Replace the old population by the new one
+	  // Step 3: Replace the old population by the new one
 	  //
 	  _populations[i] = target_population.release ();
 	  delete source_population;
 	}
 
       computeFitness ();
+      updateSurrogateStatistics ();
+      updateOperators ();
+      checkRestart ();
       emit signalPopulationsChanged (this);
     }
 
+    /*
+     * Create offspring via crossover and mutation
+     *
+     * Parents not taking part in a crossover are passed to the mutation
+     * directly, which creates the only copy of them.
+     *
+     * \param parents Selected parent individuals
+     * \param target  Population receiving one offspring per parent
+     */
+    void Controller::createOffspring
+    (const std::vector<const Individual*>& parents, Population* target)
+    {
+      //
+      // Step 1: Crossover. The children are owned by the crossover
+      //         population, uncrossed parents are used as they are.
+      //
+      std::auto_ptr<Population> crossover_population
+	(_population_creator->create (0));
+
+      std::vector<const Individual*> sources;
+      sources.reserve (parents.size ());
+
+      for (unsigned int i=0; i < parents.size () / 2; ++i)
+	{
+	  const Individual* individual_1 = parents[i * 2];
+	  const Individual* individual_2 = parents[i * 2 + 1];
+
+	  if (_random.getDouble (0.0, 1.0) < _crossover_probability)
+	    {
+	      unsigned int first = crossover_population->size ();
+
+	      const CrossoverOperator* crossover_operator =
+		_random.selectElement (_crossover_operators);
+	      crossover_operator->crossover (individual_1, individual_2,
+					     crossover_population.get ());
+
+	      for (unsigned int j=first; j < crossover_population->size (); ++j)
+		sources.push_back ((*crossover_population)[j]);
+	    }
+	  else
+	    {
+	      sources.push_back (individual_1);
+	      sources.push_back (individual_2);
+	    }
+	}
+
+      //
+      // The last individual of an odd sized population has no partner and
+      // is passed on unchanged
+      //
+      if (parents.size () % 2 == 1)
+	sources.push_back (parents.back ());
+
+      DV ("  Crossover, number of children=" <<
+	  crossover_population->size ());
+
+      //
+      // Step 2: Mutation. Thread safe operators are applied in parallel
+      //         first, duplicates are handled sequentially afterwards.
+      //
+      std::vector<const MutationOperator*> operators (sources.size ());
+      for (unsigned int i=0; i < sources.size (); ++i)
+	operators[i] = _random.selectElement (_mutation_operators);
+
+      std::vector<Individual*> mutated (sources.size (), 0);
+
+      if (_number_of_mutation_threads != 1)
+	{
+	  MutationTask task (sources, operators, &mutated);
+
+	  try
+	    {
+	      Parallel::execute (&task, sources.size (),
+				 _number_of_mutation_threads);
+	    }
+	  catch (...)
+	    {
+	      for (unsigned int i=0; i < mutated.size (); ++i)
+		delete mutated[i];
+	      throw;
+	    }
+	}
+
+      for (unsigned int i=0; i < sources.size (); ++i)
+	{
+	  const MutationOperator* mutation_operator = operators[i];
+
+	  Individual* individual = mutated[i] != 0 ?
+	    mutated[i] : mutation_operator->mutate (sources[i]);
+
+	  for ( unsigned int j=0; j < _number_of_duplicate_retries &&
+		  target->containsGenotype (individual); ++j )
+	    {
+	      std::auto_ptr<Individual> duplicate (individual);
+	      individual = mutation_operator->mutate (duplicate.get ());
+	    }
+
+	  target->addIndividual (individual, true);
+	}
+    }
+
+    /*
+     * Keep the most promising candidate offspring
+     *
+     * The candidates consist of several passes of offspring created from
+     * the same parents, so the candidates at the same position of each pass
+     * compete for one place in the target population. All candidates are
+     * rated by the surrogate model, so known and predicted objectives are
+     * not mixed.
+     *
+     * \param candidates Candidate offspring. The kept ones are moved into
+     *                   the target population.
+     * \param target     Population receiving the kept candidates
+     * \param size       Number of candidates per pass
+     */
+    void Controller::screenOffspring (Population* candidates,
+				      Population* target, unsigned int size)
+    {
+      std::vector<double> predictions (candidates->size (), 0.0);
+      for (unsigned int i=0; i < candidates->size (); ++i)
+	predictions[i] = _surrogate_model->predict ((*candidates)[i]);
+
+      std::vector<unsigned int> kept;
+
+      for (unsigned int i=0; i < size && i < candidates->size (); ++i)
+	{
+	  unsigned int best = i;
+
+	  for (unsigned int j=i + size; j < candidates->size (); j += size)
+	    if (predictions[j] < predictions[best])
+	      best = j;
+
+	  kept.push_back (best);
+	}
+
+      for (unsigned int i=0; i < candidates->size (); ++i)
+	if (!(*candidates)[i]->hasObjective ())
+	  ++_number_of_saved_evaluations;
+
+      //
+      // Take the kept candidates in descending index order, so removing
+      // one does not move another kept one
+      //
+      std::sort (kept.begin (), kept.end (), std::greater<unsigned int> ());
+
+      for (unsigned int i=0; i < kept.size (); ++i)
+	{
+	  Individual* individual = candidates->takeIndividual (kept[i]);
+
+	  if (individual->hasObjective ())
+	    {
+	      target->addIndividual (individual, true);
+	      continue;
+	    }
+
+	  --_number_of_saved_evaluations;
+	  _predictions.push_back (Prediction (individual,
+					      predictions[kept[i]]));
+	  target->addIndividual (individual, true);
+	}
+    }
+
+    /*
+     * Compare the surrogate predictions of the last step with the exact
+     * objectives
+     *
+     * A prediction is a hit if it correctly tells whether the offspring
+     * improves on its parent.
+     */
+    void Controller::updateSurrogateStatistics ()
+    {
+      for (unsigned int i=0; i < _predictions.size (); ++i)
+	{
+	  const Individual* individual = _predictions[i].first;
+	  double prediction = _predictions[i].second;
+
+	  if (!individual->hasObjective () ||
+	      !individual->hasParentObjective ())
+	    continue;
+
+	  double parent = individual->getParentObjective ();
+
+	  ++_number_of_predictions;
+	  if ((prediction < parent) == (individual->getObjective () < parent))
+	    ++_number_of_surrogate_hits;
+	}
+
+      _predictions.clear ();
+    }
+
     /*
      * Compute state information
      */
@@ -386,10 +826,217 @@ namespace GEP
       // Compute the population fitness for all existing populations
       //
       for (unsigned int i=0; i < _populations.size (); ++i)
+	evaluatePopulation (_populations[i]);
+    }
+
+    /*
+     * Compute the fitness of a single population
+     *
+     * Objective values of individuals not evaluated yet are taken from the
+     * evaluation cache if possible. The remaining ones are passed to the
+     * evaluator, if any. The population is expected to compute the
+     * objective only for individuals which do not have one already.
+     * Only single objective values are cached.
+     */
+    void Controller::evaluatePopulation (const Population* population)
+    {
+      std::vector<Individual*> unevaluated;
+
+      for ( Population::IndividualConstIterator i =
+	      population->getIndividualBegin ();
+	    i != population->getIndividualEnd (); ++i )
+	{
+	  Individual* individual = *i;
+	  if (individual->hasObjective ())
+	    continue;
+
+	  double objective = 0.0;
+	  quint64 hash = individual->getHash ();
+
+	  if (_evaluation_cache != 0 && hash != 0 &&
+	      _evaluation_cache->lookup (hash, &objective))
+	    individual->setObjective (objective);
+	  else
+	    unevaluated.push_back (individual);
+	}
+
+      if (_evaluator != 0 && !unevaluated.empty ())
+	_evaluator->evaluate (unevaluated);
+
+      population->computeFitness ();
+      _number_of_evaluations += unevaluated.size ();
+
+      if (_surrogate_model != 0)
+	for (unsigned int i=0; i < unevaluated.size (); ++i)
+	  {
+	    const Individual* individual = unevaluated[i];
+
+	    if (individual->getNumberOfObjectives () == 1)
+	      _surrogate_model->train (individual, individual->getObjective ());
+	  }
+
+      if (_evaluation_cache != 0)
+	for (unsigned int i=0; i < unevaluated.size (); ++i)
+	  {
+	    const Individual* individual = unevaluated[i];
+	    quint64 hash = individual->getHash ();
+
+	    if (hash != 0 && individual->getNumberOfObjectives () == 1)
+	      _evaluation_cache->insert (hash, individual->getObjective ());
+	  }
+    }
+
+    /*
+     * Let adaptive operators observe the newly computed populations
+     */
+    void Controller::updateOperators ()
+    {
+      for (unsigned int i=0; i < _mutation_operators.size (); ++i)
+	_mutation_operators[i]->update (_populations);
+    }
+
+    /*
+     * Restart all populations the restart policy considers stagnated
+     */
+    void Controller::checkRestart ()
+    {
+      if (_restart_policy == 0)
+        return;
+
+      for (unsigned int i=0; i < _populations.size (); ++i)
+        if (_restart_policy->stagnated (i, _populations[i]))
+          restartPopulation (i);
+    }
+
+    /*
+     * Restart a single population
+     *
+     * The best individuals of the population are merged into the elite
+     * archive. The population is then replaced by a freshly created one of
+     * the (possibly grown) size, seeded with the archived elites.
+     *
+     * \param index Index of the population to restart
+     */
+    void Controller::restartPopulation (unsigned int index)
+    {
+      const Population* population = _populations[index];
+      unsigned int number_of_elites = _restart_policy->getNumberOfElites ();
+
+      //
+      // Step 1: Update the elite archive. Fitness values are normalized per
+      //         population, so the archived individuals and the populations
+      //         best individuals are rated together in a common population.
+      //         Copies of already archived genotypes are dropped.
+      //
+      if (number_of_elites > 0)
 	{
-	  const Population* population = _populations[i];
-	  population->computeFitness ();
+	  std::vector<const Individual*> individuals
+	    (population->getIndividualBegin (), population->getIndividualEnd ());
+
+	  unsigned int count = std::min (number_of_elites,
+					 static_cast<unsigned int>
+					 (individuals.size ()));
+
+	  std::partial_sort (individuals.begin (), individuals.begin () + count,
+			     individuals.end (), IndividualFitnessComparator ());
+
+	  std::auto_ptr<Population> candidates (_population_creator->create (0));
+	  candidates->setRejectDuplicates (true);
+
+	  for (unsigned int i=0; i < _elite_archive.size (); ++i)
+	    candidates->addIndividual (_elite_archive[i]);
+	  _elite_archive.clear ();
+
+	  for (unsigned int i=0; i < count; ++i)
+	    candidates->addIndividual (individuals[i]->clone ());
+
+	  evaluatePopulation (candidates.get ());
+
+	  std::vector<const Individual*> ranked
+	    (candidates->getIndividualBegin (), candidates->getIndividualEnd ());
+	  std::sort (ranked.begin (), ranked.end (),
+		     IndividualFitnessComparator ());
+
+	  for (unsigned int i=0; i < ranked.size () && i < number_of_elites; ++i)
+	    _elite_archive.push_back (ranked[i]->clone ());
 	}
+
+      //
+      // Step 2: Replace the population by a new one seeded with the elites
+      //
+      unsigned int size =
+	_restart_policy->computePopulationSize (population->size ());
+      unsigned int number_of_seeds = std::min
+	(size, static_cast<unsigned int> (_elite_archive.size ()));
+
+      Population* restarted =
+	_population_creator->create (size - number_of_seeds);
+      attachDiversityMetrics (restarted);
+
+      for (unsigned int i=0; i < number_of_seeds; ++i)
+	restarted->addIndividual (_elite_archive[i]->clone ());
+
+      evaluatePopulation (restarted);
+
+      _populations[index] = restarted;
+      delete population;
+
+      ++_number_of_restarts;
+
+      DV ("* Restarted population " << index << ", size=" << size <<
+	  ", elites=" << number_of_seeds);
+    }
+
+    /*
+     * Resize the selection of parent individuals
+     *
+     * Surplus entries are removed randomly. Missing entries are filled up
+     * with randomly chosen ones, so the selection pressure already applied
+     * is kept.
+     *
+     * \param selection Indices of the selected individuals
+     * \param size      New number of selected individuals
+     */
+    void Controller::resizeSelection (std::vector<unsigned int>* selection,
+				      unsigned int size)
+    {
+      if (selection->empty ())
+	return;
+
+      //
+      // The order of the selection is random anyway, so removed entries
+      // are replaced by the last one
+      //
+      while (selection->size () > size)
+	{
+	  unsigned int index = _random.getInt (0, selection->size () - 1);
+	  (*selection)[index] = selection->back ();
+	  selection->pop_back ();
+	}
+
+      unsigned int selected = selection->size ();
+      while (selection->size () < size)
+	selection->push_back ((*selection)[_random.getInt (0, selected - 1)]);
+    }
+
+    /*
+     * Attach a new instance of the diversity metrics to a population
+     */
+    void Controller::attachDiversityMetrics (Population* population) const
+    {
+      if (_diversity_metrics != 0)
+	population->setDiversityMetrics (_diversity_metrics->create ());
+    }
+
+    /*
+     * Delete all individuals in the elite archive
+     */
+    void Controller::clearEliteArchive ()
+    {
+      for (unsigned int i=0; i < _elite_archive.size (); ++i)
+        delete _elite_archive[i];
+
+      _elite_archive.clear ();
     }
 
     /*
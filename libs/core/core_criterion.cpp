@@ -6,9 +6,12 @@
 
 #include "GEPCoreCriterion.hpp"
 #include "GEPCoreController.hpp"
+#include "GEPCoreDiversity.hpp"
 #include "GEPCoreIndividual.hpp"
 #include "GEPCorePopulation.hpp"
 
+#include <GEPException.hpp>
+
 #include <limits>
 #include <math.h>
 
@@ -108,6 +111,48 @@ namespace GEP {
 
       return finished;
     }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::DiversityTerminationCriterion
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param min_distance Average pairwise distance in [0, 1] below which a
+     *                     population counts as converged
+     */
+    DiversityTerminationCriterion::DiversityTerminationCriterion
+    (double min_distance)
+      : _min_distance (min_distance)
+    {
+    }
+
+    /* Destructor */
+    DiversityTerminationCriterion::~DiversityTerminationCriterion ()
+    {
+    }
+
+    /* Test if the algorithm should terminate */
+    bool DiversityTerminationCriterion::finished (const Controller* controller)
+    {
+      bool finished = controller->getPopulationBegin () !=
+	controller->getPopulationEnd ();
+
+      for ( Controller::PopulationConstIterator i =
+	      controller->getPopulationBegin ();
+	    i != controller->getPopulationEnd () && finished; ++i )
+      {
+	const DiversityMetrics* metrics = (*i)->getDiversityMetrics ();
+	if (metrics == 0)
+	  throw InternalException ("No diversity metrics attached");
+
+	finished = metrics->getAverageDistance () < _min_distance;
+      }
+
+      return finished;
+    }
     
   } // namespace Core
 } // namespace GEP
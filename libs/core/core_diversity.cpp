@@ -0,0 +1,27 @@
+/*
+ * core_diversity.cpp - Population diversity metrics
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCoreDiversity.hpp"
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::DiversityMetrics
+    //#***********************************************************************
+
+    /* Constructor */
+    DiversityMetrics::DiversityMetrics ()
+    {
+    }
+
+    /* Destructor */
+    DiversityMetrics::~DiversityMetrics ()
+    {
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -0,0 +1,771 @@
+/*
+ * core_evaluation_cache.cpp - Cache for already computed objective values
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCoreEvaluationCache.hpp"
+
+#include <GEPException.hpp>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+#include <boost/unordered_map.hpp>
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace GEP {
+  namespace Core {
+
+    namespace {
+
+      const char INDEX_MAGIC[8] = { 'G', 'E', 'P', 'I', 'D', 'X', '0', '2' };
+      const quint64 RECORD_MAGIC = 0x9e3779b97f4a7c15ULL;
+
+      /*
+       * Log record with a checksum detecting partially written records
+       */
+      struct Record
+      {
+	quint64 _hash;
+	double _objective;
+	quint64 _checksum;
+      };
+
+      /* Compute the checksum of a log record */
+      inline quint64 computeChecksum (const Record& record)
+      {
+	quint64 bits;
+	memcpy (&bits, &record._objective, sizeof (bits));
+
+	return record._hash ^ (bits * RECORD_MAGIC) ^ RECORD_MAGIC;
+      }
+
+      /*
+       * Create the first log record, which holds the cache key. Its hash
+       * is 0, which is never used for an entry.
+       */
+      inline Record createKeyRecord (quint64 key)
+      {
+	Record record;
+	record._hash = 0;
+	memcpy (&record._objective, &key, sizeof (key));
+	record._checksum = computeChecksum (record);
+
+	return record;
+      }
+
+      /* Throw an exception for a failed system call */
+      void throwSystemError (const QString& message, const std::string& path)
+      {
+	throw InternalException (QString ("%1 '%2': %3")
+				 .arg (message)
+				 .arg (QString (path.c_str ()))
+				 .arg (strerror (errno)));
+      }
+
+      /*
+       * Exclusive lock on a file, held until destruction
+       */
+      class FileLock
+      {
+      public:
+	FileLock (int fd) : _fd (fd)
+	{
+	  while (flock (_fd, LOCK_EX) < 0 && errno == EINTR)
+	    ;
+	}
+
+	~FileLock ()
+	{
+	  flock (_fd, LOCK_UN);
+	}
+
+      private:
+	int _fd;
+      };
+
+    }
+
+    //#***********************************************************************
+    // CLASS GEP::Core::EvaluationCache
+    //#***********************************************************************
+
+    /* Constructor */
+    EvaluationCache::EvaluationCache ()
+    {
+    }
+
+    /* Destructor */
+    EvaluationCache::~EvaluationCache ()
+    {
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::MemoryEvaluationCache
+    //#***********************************************************************
+
+    /*
+     * Single independently locked part of the cache
+     */
+    struct MemoryEvaluationCache::Shard
+    {
+      Shard () : _hits (0), _misses (0) {}
+
+      QMutex _mutex;
+
+      typedef boost::unordered_map<quint64, double> Entries;
+      Entries _entries;
+      std::deque<quint64> _order;
+
+      quint64 _hits;
+      quint64 _misses;
+    };
+
+    /*
+     * Constructor
+     *
+     * \param max_size         Maximum number of cached objective values
+     * \param number_of_shards Number of independently locked cache parts
+     */
+    MemoryEvaluationCache::MemoryEvaluationCache (unsigned int max_size,
+						  unsigned int number_of_shards)
+      : EvaluationCache ()
+    {
+      if (number_of_shards == 0)
+	throw InternalException ("Number of cache shards must not be 0");
+
+      if (max_size < number_of_shards)
+	throw InternalException ("Cache size smaller than number of shards");
+
+      _max_shard_size = max_size / number_of_shards;
+
+      for (unsigned int i=0; i < number_of_shards; ++i)
+	_shards.push_back (new Shard ());
+    }
+
+    /* Destructor */
+    MemoryEvaluationCache::~MemoryEvaluationCache ()
+    {
+      for (unsigned int i=0; i < _shards.size (); ++i)
+	delete _shards[i];
+
+      _shards.clear ();
+    }
+
+    /* Return the shard responsible for a hash value */
+    inline MemoryEvaluationCache::Shard* MemoryEvaluationCache::getShard
+    (quint64 hash) const
+    {
+      return _shards[(hash ^ (hash >> 32)) % _shards.size ()];
+    }
+
+    /*
+     * Look up the objective value of a genotype
+     *
+     * \param hash      Genotype hash
+     * \param objective Set to the cached objective value if found
+     * \return 'true', if the objective value has been found
+     */
+    bool MemoryEvaluationCache::lookup (quint64 hash, double* objective) const
+    {
+      Shard* shard = getShard (hash);
+      QMutexLocker lock (&shard->_mutex);
+
+      Shard::Entries::const_iterator pos = shard->_entries.find (hash);
+      if (pos == shard->_entries.end ())
+	{
+	  ++shard->_misses;
+	  return false;
+	}
+
+      ++shard->_hits;
+      *objective = pos->second;
+
+      return true;
+    }
+
+    /*
+     * Store the objective value of a genotype
+     *
+     * \param hash      Genotype hash
+     * \param objective Computed objective value
+     */
+    void MemoryEvaluationCache::insert (quint64 hash, double objective)
+    {
+      Shard* shard = getShard (hash);
+      QMutexLocker lock (&shard->_mutex);
+
+      std::pair<Shard::Entries::iterator, bool> result =
+	shard->_entries.insert (std::make_pair (hash, objective));
+
+      if (!result.second)
+	return;
+
+      shard->_order.push_back (hash);
+
+      while (shard->_order.size () > _max_shard_size)
+	{
+	  shard->_entries.erase (shard->_order.front ());
+	  shard->_order.pop_front ();
+	}
+    }
+
+    /* Remove all entries */
+    void MemoryEvaluationCache::clear ()
+    {
+      for (unsigned int i=0; i < _shards.size (); ++i)
+	{
+	  Shard* shard = _shards[i];
+	  QMutexLocker lock (&shard->_mutex);
+
+	  shard->_entries.clear ();
+	  shard->_order.clear ();
+	  shard->_hits = 0;
+	  shard->_misses = 0;
+	}
+    }
+
+    /* Return the number of cached objective values */
+    unsigned int MemoryEvaluationCache::size () const
+    {
+      unsigned int size = 0;
+
+      for (unsigned int i=0; i < _shards.size (); ++i)
+	{
+	  QMutexLocker lock (&_shards[i]->_mutex);
+	  size += _shards[i]->_entries.size ();
+	}
+
+      return size;
+    }
+
+    /* Return the number of successful lookups */
+    quint64 MemoryEvaluationCache::getNumberOfHits () const
+    {
+      quint64 hits = 0;
+
+      for (unsigned int i=0; i < _shards.size (); ++i)
+	{
+	  QMutexLocker lock (&_shards[i]->_mutex);
+	  hits += _shards[i]->_hits;
+	}
+
+      return hits;
+    }
+
+    /* Return the number of failed lookups */
+    quint64 MemoryEvaluationCache::getNumberOfMisses () const
+    {
+      quint64 misses = 0;
+
+      for (unsigned int i=0; i < _shards.size (); ++i)
+	{
+	  QMutexLocker lock (&_shards[i]->_mutex);
+	  misses += _shards[i]->_misses;
+	}
+
+      return misses;
+    }
+
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::PersistentEvaluationCache
+    //#***********************************************************************
+
+    /*
+     * Header of the index file
+     *
+     * 'replaced' is set when another process replaced the index file by a
+     * larger one, which must be mapped then instead.
+     */
+    struct PersistentEvaluationCache::Header
+    {
+      char _magic[8];
+      quint64 _capacity;
+      quint64 _size;
+      quint64 _log_size;
+      quint64 _key;
+      volatile quint32 _replaced;
+      quint32 _reserved[5];
+    };
+
+    /*
+     * Index slot. A hash of 0 marks an empty slot.
+     */
+    struct PersistentEvaluationCache::Slot
+    {
+      volatile quint64 _hash;
+      double _objective;
+    };
+
+    /*
+     * Constructor
+     *
+     * Opens or creates the cache files '<path>.log', '<path>.idx' and
+     * '<path>.lock'. A partially written last log record, as left by a
+     * crashed process, is discarded. An index created with another key is
+     * rebuilt from the log.
+     *
+     * \param path             Base path of the cache files
+     * \param key              Key identifying the problem instance and the
+     *                         objective. The cache files must have been
+     *                         created with the same key.
+     * \param initial_capacity Number of index slots if a new index is
+     *                         created
+     */
+    PersistentEvaluationCache::PersistentEvaluationCache
+    (const QString& path, quint64 key, unsigned int initial_capacity)
+      : EvaluationCache (),
+	_path        (qPrintable (path)),
+	_key         (key),
+	_lock_fd     (-1),
+	_log_fd      (-1),
+	_header      (0),
+	_slots       (0),
+	_mapped_size (0),
+	_hits        (0),
+	_misses      (0)
+    {
+      _lock_fd = open ((_path + ".lock").c_str (),
+		       O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+      if (_lock_fd < 0)
+	throwSystemError ("Cannot open cache lock file", _path + ".lock");
+
+      _log_fd = open ((_path + ".log").c_str (),
+		      O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (_log_fd < 0)
+	{
+	  close (_lock_fd);
+	  throwSystemError ("Cannot open cache log file", _path + ".log");
+	}
+
+      try
+	{
+	  FileLock lock (_lock_fd);
+
+	  struct stat info;
+	  if (fstat (_log_fd, &info) < 0)
+	    throwSystemError ("Cannot access cache log file", _path + ".log");
+
+	  quint64 log_size = info.st_size - info.st_size % sizeof (Record);
+
+	  if (log_size != static_cast<quint64> (info.st_size) &&
+	      ftruncate (_log_fd, log_size) < 0)
+	    throwSystemError ("Cannot repair cache log file", _path + ".log");
+
+	  //
+	  // A new log starts with the key, an existing one must have been
+	  // created with the same key
+	  //
+	  Record key_record = createKeyRecord (_key);
+	  Record record;
+
+	  if (log_size == 0)
+	    {
+	      if (write (_log_fd, &key_record, sizeof (key_record)) !=
+		  static_cast<ssize_t> (sizeof (key_record)))
+		throwSystemError ("Cannot write cache log file", _path + ".log");
+	    }
+	  else if (pread (_log_fd, &record, sizeof (record), 0) !=
+		   static_cast<ssize_t> (sizeof (record)) ||
+		   memcmp (&record, &key_record, sizeof (Record)) != 0)
+	    throw InternalException (QString ("Cache '%1' has been created for "
+					      "another problem or objective")
+				     .arg (path));
+
+	  quint64 capacity = 16;
+	  while (capacity < initial_capacity)
+	    capacity *= 2;
+
+	  if (!mapIndex ())
+	    rebuildIndex (capacity);
+
+	  updateIndex ();
+	}
+      catch (...)
+	{
+	  unmapIndex ();
+	  close (_log_fd);
+	  close (_lock_fd);
+	  throw;
+	}
+    }
+
+    /* Destructor */
+    PersistentEvaluationCache::~PersistentEvaluationCache ()
+    {
+      unmapIndex ();
+
+      close (_log_fd);
+      close (_lock_fd);
+    }
+
+    /*
+     * Map the current index file
+     *
+     * \return 'false' if the index file does not exist, is damaged or has
+     *         been created with another key
+     */
+    bool PersistentEvaluationCache::mapIndex () const
+    {
+      unmapIndex ();
+
+      int fd = open ((_path + ".idx").c_str (), O_RDWR | O_CLOEXEC);
+      if (fd < 0)
+	return false;
+
+      struct stat info;
+      Header header;
+
+      bool ok = fstat (fd, &info) == 0 &&
+	static_cast<quint64> (info.st_size) >= sizeof (Header) &&
+	pread (fd, &header, sizeof (header), 0) ==
+	static_cast<ssize_t> (sizeof (header)) &&
+	memcmp (header._magic, INDEX_MAGIC, sizeof (INDEX_MAGIC)) == 0 &&
+	header._key == _key &&
+	header._capacity > 0 &&
+	(header._capacity & (header._capacity - 1)) == 0 &&
+	static_cast<quint64> (info.st_size) ==
+	sizeof (Header) + header._capacity * sizeof (Slot);
+
+      if (ok)
+	{
+	  void* data = mmap (0, info.st_size, PROT_READ | PROT_WRITE,
+			     MAP_SHARED, fd, 0);
+	  if (data != MAP_FAILED)
+	    {
+	      _header = static_cast<Header*> (data);
+	      _slots = reinterpret_cast<Slot*> (_header + 1);
+	      _mapped_size = info.st_size;
+	    }
+	  else
+	    ok = false;
+	}
+
+      close (fd);
+
+      return ok;
+    }
+
+    /* Unmap the index file */
+    void PersistentEvaluationCache::unmapIndex () const
+    {
+      if (_header != 0)
+	munmap (_header, _mapped_size);
+
+      _header = 0;
+      _slots = 0;
+      _mapped_size = 0;
+    }
+
+    /* Switch to the current index file if it has been replaced */
+    void PersistentEvaluationCache::checkIndex () const
+    {
+      if (_header->_replaced == 0)
+	return;
+
+      if (!mapIndex ())
+	throw InternalException (QString ("Cache index '%1' lost")
+				 .arg (QString (_path.c_str ())));
+    }
+
+    /*
+     * Create a new index from the complete log and replace the current one
+     *
+     * The index is written to a temporary file first and atomically renamed,
+     * so other processes never see an incomplete index. Must be called
+     * with the lock file being locked.
+     */
+    void PersistentEvaluationCache::rebuildIndex (quint64 capacity)
+    {
+      struct stat info;
+      if (fstat (_log_fd, &info) < 0)
+	throwSystemError ("Cannot access cache log file", _path + ".log");
+
+      //
+      // Choose the capacity large enough for the whole log, so the index
+      // does not need to grow again while being built
+      //
+      quint64 number_of_records = info.st_size / sizeof (Record);
+      while ((number_of_records + 1) * 10 > capacity * 7)
+	capacity *= 2;
+
+      std::string temporary_path = _path + ".idx.tmp";
+      quint64 size = sizeof (Header) + capacity * sizeof (Slot);
+
+      int fd = open (temporary_path.c_str (),
+		     O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0)
+	throwSystemError ("Cannot create cache index", temporary_path);
+
+      void* data = MAP_FAILED;
+      if (ftruncate (fd, size) == 0)
+	data = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close (fd);
+
+      if (data == MAP_FAILED)
+	throwSystemError ("Cannot create cache index", temporary_path);
+
+      Header* old_header = _header;
+      quint64 old_mapped_size = _mapped_size;
+
+      _header = static_cast<Header*> (data);
+      _slots = reinterpret_cast<Slot*> (_header + 1);
+      _mapped_size = size;
+
+      memcpy (_header->_magic, INDEX_MAGIC, sizeof (INDEX_MAGIC));
+      _header->_capacity = capacity;
+      _header->_key = _key;
+
+      updateIndex ();
+
+      if (rename (temporary_path.c_str (), (_path + ".idx").c_str ()) < 0)
+	throwSystemError ("Cannot replace cache index", _path + ".idx");
+
+      if (old_header != 0)
+	{
+	  __sync_synchronize ();
+	  old_header->_replaced = 1;
+	  munmap (old_header, old_mapped_size);
+	}
+    }
+
+    /*
+     * Add log records not contained in the index yet
+     *
+     * Normally there are none, since each writer updates the index after
+     * appending to the log. Must be called with the lock file being locked.
+     */
+    void PersistentEvaluationCache::updateIndex ()
+    {
+      struct stat info;
+      if (fstat (_log_fd, &info) < 0)
+	throwSystemError ("Cannot access cache log file", _path + ".log");
+
+      quint64 end = info.st_size - info.st_size % sizeof (Record);
+      std::vector<Record> records (1024);
+
+      while (_header->_log_size < end)
+	{
+	  unsigned int count = std::min
+	    (static_cast<quint64> (records.size ()),
+	     (end - _header->_log_size) / sizeof (Record));
+
+	  ssize_t n = pread (_log_fd, &records[0], count * sizeof (Record),
+			     _header->_log_size);
+	  if (n <= 0)
+	    throwSystemError ("Cannot read cache log file", _path + ".log");
+
+	  count = n / sizeof (Record);
+	  for (unsigned int i=0; i < count; ++i)
+	    {
+	      const Record& record = records[i];
+
+	      if (record._checksum == computeChecksum (record) &&
+		  !insertSlot (record._hash, record._objective))
+		return;
+
+	      _header->_log_size += sizeof (Record);
+	    }
+	}
+    }
+
+    /*
+     * Search the index for a hash value without locking
+     *
+     * Slots are only ever filled, and the objective is written before the
+     * hash, so a slot with a matching hash is always complete.
+     */
+    bool PersistentEvaluationCache::findSlot (quint64 hash,
+					      double* objective) const
+    {
+      quint64 mask = _header->_capacity - 1;
+
+      for (quint64 i = (hash ^ (hash >> 32)) & mask; ; i = (i + 1) & mask)
+	{
+	  const Slot& slot = _slots[i];
+	  quint64 slot_hash = slot._hash;
+
+	  if (slot_hash == 0)
+	    return false;
+
+	  if (slot_hash == hash)
+	    {
+	      __sync_synchronize ();
+	      *objective = slot._objective;
+	      return true;
+	    }
+	}
+    }
+
+    /*
+     * Add an entry to the index
+     *
+     * If the index gets too full, it is replaced by one with twice the
+     * capacity built from the log. Must be called with the lock file being
+     * locked.
+     *
+     * \return 'false' if the index has been rebuilt, so all log records are
+     *         contained in it already
+     */
+    bool PersistentEvaluationCache::insertSlot (quint64 hash, double objective)
+    {
+      if (hash == 0)
+	return true;
+
+      if ((_header->_size + 1) * 10 > _header->_capacity * 7)
+	{
+	  rebuildIndex (_header->_capacity * 2);
+	  return false;
+	}
+
+      quint64 mask = _header->_capacity - 1;
+
+      for (quint64 i = (hash ^ (hash >> 32)) & mask; ; i = (i + 1) & mask)
+	{
+	  Slot& slot = _slots[i];
+
+	  if (slot._hash == hash)
+	    return true;
+
+	  if (slot._hash == 0)
+	    {
+	      slot._objective = objective;
+	      __sync_synchronize ();
+	      slot._hash = hash;
+
+	      ++_header->_size;
+	      return true;
+	    }
+	}
+    }
+
+    /*
+     * Look up the objective value of a genotype
+     *
+     * \param hash      Genotype hash
+     * \param objective Set to the cached objective value if found
+     * \return 'true', if the objective value has been found
+     */
+    bool PersistentEvaluationCache::lookup (quint64 hash,
+					    double* objective) const
+    {
+      QMutexLocker lock (&_mutex);
+
+      checkIndex ();
+
+      if (hash != 0 && findSlot (hash, objective))
+	{
+	  ++_hits;
+	  return true;
+	}
+
+      ++_misses;
+      return false;
+    }
+
+    /*
+     * Store the objective value of a genotype
+     *
+     * The record is appended to the log before the index is updated, so
+     * it is recovered from the log if the process dies in between.
+     *
+     * \param hash      Genotype hash
+     * \param objective Computed objective value
+     */
+    void PersistentEvaluationCache::insert (quint64 hash, double objective)
+    {
+      QMutexLocker lock (&_mutex);
+
+      double known;
+      if (hash == 0)
+	return;
+
+      checkIndex ();
+      if (findSlot (hash, &known))
+	return;
+
+      FileLock file_lock (_lock_fd);
+
+      checkIndex ();
+      updateIndex ();
+
+      if (findSlot (hash, &known))
+	return;
+
+      Record record;
+      record._hash = hash;
+      record._objective = objective;
+      record._checksum = computeChecksum (record);
+
+      if (write (_log_fd, &record, sizeof (record)) !=
+	  static_cast<ssize_t> (sizeof (record)))
+	throwSystemError ("Cannot write cache log file", _path + ".log");
+
+      if (insertSlot (hash, objective))
+	_header->_log_size += sizeof (Record);
+    }
+
+    /*
+     * Remove all entries, also for other processes using the cache. The key
+     * is kept.
+     */
+    void PersistentEvaluationCache::clear ()
+    {
+      QMutexLocker lock (&_mutex);
+      FileLock file_lock (_lock_fd);
+
+      checkIndex ();
+
+      Record key_record = createKeyRecord (_key);
+
+      if (ftruncate (_log_fd, 0) < 0 ||
+	  write (_log_fd, &key_record, sizeof (key_record)) !=
+	  static_cast<ssize_t> (sizeof (key_record)))
+	throwSystemError ("Cannot clear cache log file", _path + ".log");
+
+      memset (_slots, 0, _header->_capacity * sizeof (Slot));
+      _header->_size = 0;
+      _header->_log_size = sizeof (Record);
+
+      _hits = 0;
+      _misses = 0;
+    }
+
+    /* Return the number of cached objective values */
+    unsigned int PersistentEvaluationCache::size () const
+    {
+      QMutexLocker lock (&_mutex);
+
+      checkIndex ();
+      return _header->_size;
+    }
+
+    /* Return the number of successful lookups of this cache instance */
+    quint64 PersistentEvaluationCache::getNumberOfHits () const
+    {
+      QMutexLocker lock (&_mutex);
+      return _hits;
+    }
+
+    /* Return the number of failed lookups of this cache instance */
+    quint64 PersistentEvaluationCache::getNumberOfMisses () const
+    {
+      QMutexLocker lock (&_mutex);
+      return _misses;
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -0,0 +1,42 @@
+/*
+ * core_evaluator.cpp - External computation of objective values
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCoreEvaluator.hpp"
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::Evaluator
+    //#***********************************************************************
+
+    /* Constructor */
+    Evaluator::Evaluator ()
+    {
+    }
+
+    /* Destructor */
+    Evaluator::~Evaluator ()
+    {
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::GenomeEncoder
+    //#***********************************************************************
+
+    /* Constructor */
+    GenomeEncoder::GenomeEncoder ()
+    {
+    }
+
+    /* Destructor */
+    GenomeEncoder::~GenomeEncoder ()
+    {
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -6,6 +6,8 @@
 
 #include "GEPCoreIndividual.hpp"
 
+#include <math.h>
+
 namespace GEP {
   namespace Core {
 
@@ -16,14 +18,35 @@ namespace GEP {
     /* Constructor */
     Individual::Individual ()
       : _selected (false),
-	_fitness (std::numeric_limits<double>::min ())
+	_fitness (std::numeric_limits<double>::min ()),
+	_has_objective (false),
+	_objective (0.0),
+	_has_parent_objective (false),
+	_parent_objective (0.0),
+	_mutation_rate (-1.0),
+	_mutation_operator (0)
     {
     }
     
-    /* Copy constructor */
+    /*
+     * Copy constructor
+     *
+     * The copied individual becomes the parent of the new one, so its
+     * objective value is kept as parent objective. The mutation operator
+     * which created the copied individual is not inherited.
+     */
     Individual::Individual (const Individual& toCopy)
       : _selected (toCopy._selected),
-	_fitness (toCopy._fitness)
+	_fitness (toCopy._fitness),
+	_has_objective (toCopy._has_objective),
+	_objective (toCopy._objective),
+	_objectives (toCopy._objectives),
+	_has_parent_objective (toCopy._has_objective ||
+			       toCopy._has_parent_objective),
+	_parent_objective (toCopy._has_objective ?
+			   toCopy._objective : toCopy._parent_objective),
+	_mutation_rate (toCopy._mutation_rate),
+	_mutation_operator (0)
     {
     }
 
@@ -32,6 +55,21 @@ namespace GEP {
     {
     }
 
+    /*
+     * Return hash value of the individuals genotype
+     *
+     * Individuals with equal genotypes must have equal hash values. The
+     * hash is used to look up already computed objective values and to
+     * detect duplicates.
+     *
+     * \return Hash value or 0 if the individual type does not support
+     *         hashing (default)
+     */
+    quint64 Individual::getHash () const
+    {
+      return 0;
+    }
+
     /*
      * Select/deselect individual
      */
@@ -56,6 +94,97 @@ namespace GEP {
       
       _fitness = fitness;
     }
+
+    /*
+     * Set raw objective value
+     *
+     * The objective is the unnormalized quality measure the population
+     * derives the fitness from (for example a route length). Smaller values
+     * are better.
+     */
+    void Individual::setObjective (double objective)
+    {
+      _objective = objective;
+      _objectives.clear ();
+      _has_objective = true;
+    }
+
+    /*
+     * Set raw objective values of a multi objective individual
+     *
+     * All objectives are minimized. The first objective is the primary one
+     * used by single objective components like the restart policy.
+     *
+     * \param objectives Objective values, at least one
+     */
+    void Individual::setObjectives (const std::vector<double>& objectives)
+    {
+      if (objectives.empty ())
+	throw InternalException ("No objective values given");
+
+      _objective = objectives[0];
+      _has_objective = true;
+
+      if (objectives.size () > 1)
+	_objectives = objectives;
+      else
+	_objectives.clear ();
+    }
+
+    /*
+     * Mark the raw objective value as unknown
+     */
+    void Individual::clearObjective ()
+    {
+      if (_has_objective)
+	{
+	  _parent_objective = _objective;
+	  _has_parent_objective = true;
+	}
+
+      _has_objective = false;
+      _objectives.clear ();
+    }
+
+    /*
+     * Set the individuals own mutation rate
+     *
+     * \param mutation_rate Per gene mutation probability in [0.0, 1.0]
+     */
+    void Individual::setMutationRate (double mutation_rate)
+    {
+      if (mutation_rate < 0.0 || mutation_rate > 1.0)
+	throw InternalException ("Mutation rate out of valid range");
+
+      _mutation_rate = mutation_rate;
+    }
+
+    /*
+     * Recombine the mutation rate with the one of another parent
+     *
+     * Used by crossover operators so that offspring inherit the rates of
+     * both parents. The geometric mean is used because the rates are
+     * perturbed log-normally.
+     */
+    void Individual::recombineMutationRate (const Individual* individual)
+    {
+      if (_mutation_rate >= 0.0 && individual->_mutation_rate >= 0.0)
+	_mutation_rate = sqrt (_mutation_rate * individual->_mutation_rate);
+      else if (individual->_mutation_rate >= 0.0)
+	_mutation_rate = individual->_mutation_rate;
+    }
+
+    /*
+     * Mark the individual as offspring of a mutation operator
+     *
+     * Adaptive operators use the mark to tell their own offspring from the
+     * ones of other operators.
+     */
+    void Individual::setMutationOperator
+    (const MutationOperator* mutation_operator)
+    {
+      _mutation_operator = mutation_operator;
+    }
     
   } // namespace Core
 } // namespace GEP
@@ -24,5 +24,29 @@ namespace GEP {
     {
     }
 
+    /*
+     * Update operator state
+     *
+     * Called by the controller once per step, after the fitness of all
+     * newly generated populations has been computed. Adaptive operators can
+     * use this to adjust their parameters from the observed results.
+     */
+    void MutationOperator::update
+    (const std::vector<const Population*>& /*populations*/)
+    {
+    }
+
+    /*
+     * Return if the operator can mutate several individuals in parallel
+     *
+     * The controller calls mutate () from several threads at once only for
+     * operators returning 'true' here. Operators keeping a shared random
+     * number generator are not thread safe.
+     */
+    bool MutationOperator::isThreadSafe () const
+    {
+      return false;
+    }
+
   } // namespace Core
 } // namespace GEP
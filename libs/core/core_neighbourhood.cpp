@@ -0,0 +1,27 @@
+/*
+ * core_neighbourhood.cpp - Candidate neighbours of genes
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCoreNeighbourhood.hpp"
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::Neighbourhood
+    //#***********************************************************************
+
+    /* Constructor */
+    Neighbourhood::Neighbourhood ()
+    {
+    }
+
+    /* Destructor */
+    Neighbourhood::~Neighbourhood ()
+    {
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -0,0 +1,315 @@
+/*
+ * core_pareto_ranking.cpp - Non-dominated sorting of multi objective
+ *                           populations
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+//#define _DEBUG
+
+#include "GEPCoreParetoRanking.hpp"
+#include "GEPCoreIndividual.hpp"
+#include "GEPCorePopulation.hpp"
+
+#include <GEPDebug.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::ParetoRanking::LexicographicComparator
+    //#***********************************************************************
+
+    /*
+     * Comparator for lexicographic ordering of objective vectors
+     */
+    class ParetoRanking::LexicographicComparator
+    {
+    public:
+      inline LexicographicComparator (const std::vector<double>& objectives,
+				      unsigned int number_of_objectives)
+	: _objectives (objectives),
+	  _number_of_objectives (number_of_objectives) {}
+
+      inline bool operator () (unsigned int index_1,
+			       unsigned int index_2) const
+      {
+	const double* objectives_1 =
+	  &_objectives[index_1 * _number_of_objectives];
+	const double* objectives_2 =
+	  &_objectives[index_2 * _number_of_objectives];
+
+	for (unsigned int i=0; i < _number_of_objectives; ++i)
+	  if (objectives_1[i] != objectives_2[i])
+	    return objectives_1[i] < objectives_2[i];
+
+	return false;
+      }
+
+    private:
+      const std::vector<double>& _objectives;
+      unsigned int _number_of_objectives;
+    };
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::ParetoRanking::ObjectiveComparator
+    //#***********************************************************************
+
+    /*
+     * Comparator for ordering individuals by a single objective
+     */
+    class ParetoRanking::ObjectiveComparator
+    {
+    public:
+      inline ObjectiveComparator (const std::vector<double>& objectives,
+				  unsigned int number_of_objectives,
+				  unsigned int objective)
+	: _objectives (objectives),
+	  _number_of_objectives (number_of_objectives),
+	  _objective (objective) {}
+
+      inline bool operator () (unsigned int index_1,
+			       unsigned int index_2) const
+      {
+	return _objectives[index_1 * _number_of_objectives + _objective] <
+	  _objectives[index_2 * _number_of_objectives + _objective];
+      }
+
+    private:
+      const std::vector<double>& _objectives;
+      unsigned int _number_of_objectives;
+      unsigned int _objective;
+    };
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::ParetoRanking
+    //#***********************************************************************
+
+    /* Constructor */
+    ParetoRanking::ParetoRanking ()
+      : _number_of_objectives (0),
+	_number_of_fronts (0)
+    {
+    }
+
+    /* Destructor */
+    ParetoRanking::~ParetoRanking ()
+    {
+    }
+
+    /*
+     * Compute front ranks and crowding distances of a population
+     *
+     * All individuals must have the same number of objectives. All
+     * objectives are minimized.
+     *
+     * \param population Evaluated population
+     */
+    void ParetoRanking::compute (const Population* population)
+    {
+      unsigned int size = population->size ();
+
+      _number_of_objectives = size > 0 ?
+	(*population)[0]->getNumberOfObjectives () : 0;
+      _objectives.resize (size * _number_of_objectives);
+      _ranks.assign (size, 0);
+      _crowding_distances.assign (size, 0.0);
+      _number_of_fronts = 0;
+
+      if (size == 0)
+	return;
+
+      if (_number_of_objectives == 0)
+	throw InternalException ("Objectives not computed yet");
+
+      //
+      // Step 1: Copy the objectives into a dense table
+      //
+      for (unsigned int i=0; i < size; ++i)
+	{
+	  const Individual* individual = (*population)[i];
+	  if (individual->getNumberOfObjectives () != _number_of_objectives)
+	    throw InternalException ("Different numbers of objectives");
+
+	  for (unsigned int j=0; j < _number_of_objectives; ++j)
+	    _objectives[i * _number_of_objectives + j] =
+	      individual->getObjective (j);
+	}
+
+      //
+      // Step 2: Process the individuals in lexicographic order. Each one is
+      //         put into the first front which does not dominate it. If a
+      //         front does not dominate an individual, no later front does,
+      //         so the front can be found via binary search.
+      //
+      std::vector<unsigned int> order (size);
+      for (unsigned int i=0; i < size; ++i)
+	order[i] = i;
+
+      std::sort (order.begin (), order.end (),
+		 LexicographicComparator (_objectives, _number_of_objectives));
+
+      std::vector< std::vector<unsigned int> > fronts;
+
+      for (unsigned int i=0; i < size; ++i)
+	{
+	  unsigned int index = order[i];
+
+	  unsigned int low = 0;
+	  unsigned int high = fronts.size ();
+
+	  while (low < high)
+	    {
+	      unsigned int middle = (low + high) / 2;
+
+	      if (frontDominates (fronts[middle], index))
+		low = middle + 1;
+	      else
+		high = middle;
+	    }
+
+	  if (low == fronts.size ())
+	    fronts.push_back (std::vector<unsigned int> ());
+
+	  fronts[low].push_back (index);
+	  _ranks[index] = low;
+	}
+
+      _number_of_fronts = fronts.size ();
+
+      //
+      // Step 3: Crowding distances within each front
+      //
+      for (unsigned int i=0; i < fronts.size (); ++i)
+	computeCrowdingDistances (fronts[i]);
+
+      DV ("* Ranked " << size << " individuals, fronts=" << _number_of_fronts);
+    }
+
+    /*
+     * Check if an individual Pareto dominates another one
+     *
+     * Both individuals must have the same number of objectives. [STATIC]
+     */
+    bool ParetoRanking::dominates (const Individual* individual_1,
+				   const Individual* individual_2)
+    {
+      unsigned int number_of_objectives =
+	individual_1->getNumberOfObjectives ();
+      if (number_of_objectives != individual_2->getNumberOfObjectives ())
+	throw InternalException ("Different numbers of objectives");
+
+      bool better = false;
+
+      for (unsigned int i=0; i < number_of_objectives; ++i)
+	{
+	  double objective_1 = individual_1->getObjective (i);
+	  double objective_2 = individual_2->getObjective (i);
+
+	  if (objective_1 > objective_2)
+	    return false;
+
+	  better = better || objective_1 < objective_2;
+	}
+
+      return better;
+    }
+
+    /*
+     * Check if an individual of the table Pareto dominates another one
+     */
+    bool ParetoRanking::dominates (unsigned int index_1,
+				   unsigned int index_2) const
+    {
+      const double* objectives_1 =
+	&_objectives[index_1 * _number_of_objectives];
+      const double* objectives_2 =
+	&_objectives[index_2 * _number_of_objectives];
+
+      bool better = false;
+
+      for (unsigned int i=0; i < _number_of_objectives; ++i)
+	{
+	  if (objectives_1[i] > objectives_2[i])
+	    return false;
+
+	  better = better || objectives_1[i] < objectives_2[i];
+	}
+
+      return better;
+    }
+
+    /*
+     * Check if any member of a front dominates an individual
+     *
+     * All front members precede the individual in lexicographic order.
+     * Later added members are the most likely to dominate it, so the front
+     * is scanned backwards. For two objectives the second objective
+     * strictly decreases along a front (up to equal objective vectors), so
+     * the last member is the only candidate.
+     */
+    bool ParetoRanking::frontDominates (const std::vector<unsigned int>& front,
+					unsigned int index) const
+    {
+      if (_number_of_objectives == 2)
+	return dominates (front.back (), index);
+
+      for (unsigned int i=front.size (); i > 0; --i)
+	if (dominates (front[i - 1], index))
+	  return true;
+
+      return false;
+    }
+
+    /*
+     * Compute the crowding distances of the members of a single front
+     *
+     * The crowding distance is the sum over all objectives of the
+     * normalized distance between the two neighbours of an individual.
+     * Boundary individuals get an infinite distance.
+     */
+    void ParetoRanking::computeCrowdingDistances
+    (const std::vector<unsigned int>& front)
+    {
+      if (front.size () <= 2)
+	{
+	  for (unsigned int i=0; i < front.size (); ++i)
+	    _crowding_distances[front[i]] =
+	      std::numeric_limits<double>::infinity ();
+	  return;
+	}
+
+      std::vector<unsigned int> sorted (front);
+
+      for (unsigned int i=0; i < _number_of_objectives; ++i)
+	{
+	  std::sort (sorted.begin (), sorted.end (),
+		     ObjectiveComparator (_objectives, _number_of_objectives,
+					  i));
+
+	  double min = _objectives[sorted.front () * _number_of_objectives + i];
+	  double max = _objectives[sorted.back () * _number_of_objectives + i];
+
+	  _crowding_distances[sorted.front ()] =
+	    std::numeric_limits<double>::infinity ();
+	  _crowding_distances[sorted.back ()] =
+	    std::numeric_limits<double>::infinity ();
+
+	  if (max == min)
+	    continue;
+
+	  for (unsigned int j=1; j + 1 < sorted.size (); ++j)
+	    _crowding_distances[sorted[j]] +=
+	      (_objectives[sorted[j + 1] * _number_of_objectives + i] -
+	       _objectives[sorted[j - 1] * _number_of_objectives + i]) /
+	      (max - min);
+	}
+    }
+
+  } // namespace Core
+} // namespace GEP
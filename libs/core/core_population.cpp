@@ -5,6 +5,7 @@
  */
 
 #include "GEPCorePopulation.hpp"
+#include "GEPCoreDiversity.hpp"
 #include "GEPCoreIndividual.hpp"
 
 namespace GEP {
@@ -16,6 +17,8 @@ namespace GEP {
     
     /* Constructor */
     Population::Population ()
+      : _diversity_metrics (0),
+	_reject_duplicates (false)
     {
     }
 
@@ -26,6 +29,9 @@ namespace GEP {
 	delete _individuals[i];
 
       _individuals.clear ();
+
+      delete _diversity_metrics;
+      _diversity_metrics = 0;
     }
 
     /*
@@ -34,14 +40,135 @@ namespace GEP {
      * \param individual Individual to add. The individual must be unique and
      *                   is then owned by the population. It will be destroyed
      *                   upon the populations deletion.
+     * \param force      Add the individual even if duplicates are rejected
+     * \return 'false', if the individual has been rejected because its
+     *         genotype is already present (see setRejectDuplicates ()). The
+     *         rejected individual is destroyed immediately.
      */
-    void Population::addIndividual (Individual* individual)
+    bool Population::addIndividual (Individual* individual, bool force)
     {
       for (unsigned int i=0; i < _individuals.size (); ++i)
 	if (_individuals[i] == individual)
 	  throw InternalException ("Duplicate individual added");
 
+      if (_reject_duplicates)
+	{
+	  quint64 hash = individual->getHash ();
+
+	  if (hash != 0)
+	    {
+	      unsigned int& count = _hash_counts[hash];
+	      if (count > 0 && !force)
+		{
+		  delete individual;
+		  return false;
+		}
+
+	      ++count;
+	    }
+	}
+
       _individuals.push_back (individual);
+
+      if (_diversity_metrics != 0)
+	_diversity_metrics->add (individual);
+
+      return true;
+    }
+
+    /*
+     * Remove single individual from this population
+     *
+     * The last individual of the population takes the place of the removed
+     * one, so the order of the individuals is not preserved.
+     *
+     * \param index Index of the individual to remove
+     * \return Removed individual. The caller owns the individual afterwards.
+     */
+    Individual* Population::takeIndividual (unsigned int index)
+    {
+      if (index >= _individuals.size ())
+	throw InternalException ("Population index exceeded");
+
+      Individual* individual = _individuals[index];
+
+      _individuals[index] = _individuals.back ();
+      _individuals.pop_back ();
+
+      if (_diversity_metrics != 0)
+	_diversity_metrics->remove (individual);
+
+      if (_reject_duplicates)
+	{
+	  HashCounts::iterator pos = _hash_counts.find (individual->getHash ());
+	  if (pos != _hash_counts.end () && --pos->second == 0)
+	    _hash_counts.erase (pos);
+	}
+
+      return individual;
+    }
+
+    /*
+     * Check if the genotype of an individual is already present
+     *
+     * Only supported if duplicates are rejected, otherwise 'false' is
+     * returned.
+     */
+    bool Population::containsGenotype (const Individual* individual) const
+    {
+      if (!_reject_duplicates)
+	return false;
+
+      quint64 hash = individual->getHash ();
+      return hash != 0 && _hash_counts.find (hash) != _hash_counts.end ();
+    }
+
+    /*
+     * Enable/disable duplicate suppression
+     *
+     * If enabled, individuals whose genotype hash is already present in the
+     * population are rejected by addIndividual (). Individuals already in
+     * the population are kept even if they are duplicates. Individual types
+     * without genotype hash are never rejected.
+     */
+    void Population::setRejectDuplicates (bool reject_duplicates)
+    {
+      _reject_duplicates = reject_duplicates;
+      _hash_counts.clear ();
+
+      if (_reject_duplicates)
+	for (unsigned int i=0; i < _individuals.size (); ++i)
+	  {
+	    quint64 hash = _individuals[i]->getHash ();
+	    if (hash != 0)
+	      ++_hash_counts[hash];
+	  }
+    }
+
+    /*
+     * Attach diversity metrics to this population
+     *
+     * The metrics are updated incrementally whenever individuals are added
+     * or removed afterwards.
+     *
+     * \param diversity_metrics Metrics object or NULL to detach the current
+     *                          one. The population owns the metrics object
+     *                          and will destroy it upon deletion.
+     */
+    void Population::setDiversityMetrics (DiversityMetrics* diversity_metrics)
+    {
+      if (_diversity_metrics != diversity_metrics)
+	delete _diversity_metrics;
+
+      _diversity_metrics = diversity_metrics;
+
+      if (_diversity_metrics != 0)
+	{
+	  _diversity_metrics->clear ();
+
+	  for (unsigned int i=0; i < _individuals.size (); ++i)
+	    _diversity_metrics->add (_individuals[i]);
+	}
     }
     
 
@@ -0,0 +1,180 @@
+/*
+ * core_population_size.cpp - Dynamic population size control
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+//#define _DEBUG
+
+#include "GEPCorePopulationSize.hpp"
+#include "GEPCoreDiversity.hpp"
+#include "GEPCoreIndividual.hpp"
+#include "GEPCorePopulation.hpp"
+
+#include <GEPDebug.hpp>
+#include <GEPException.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::PopulationSizeController
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param min_size            Minimum population size
+     * \param max_size            Maximum population size
+     * \param min_diversity       Diversity in [0, 1] below which a population
+     *                            is considered collapsed and shrunk
+     * \param max_unchanged_steps Number of steps without improvement after
+     *                            which a diverse population is grown
+     * \param resize_factor       Factor the size is multiplied or divided by
+     */
+    PopulationSizeController::PopulationSizeController
+    (unsigned int min_size, unsigned int max_size, double min_diversity,
+     unsigned int max_unchanged_steps, double resize_factor)
+      : _min_size            (min_size),
+	_max_size            (max_size),
+	_min_diversity       (min_diversity),
+	_max_unchanged_steps (max_unchanged_steps),
+	_resize_factor       (resize_factor)
+    {
+      if (_min_size < 2 || _min_size > _max_size)
+	throw InternalException ("Illegal population size bounds");
+
+      if (_min_diversity < 0.0 || _min_diversity > 1.0)
+	throw InternalException ("Minimum diversity out of valid range");
+
+      if (_resize_factor <= 1.0)
+	throw InternalException ("Resize factor must be larger than 1.0");
+    }
+
+    /* Destructor */
+    PopulationSizeController::~PopulationSizeController ()
+    {
+    }
+
+    /* Reset improvement tracking */
+    void PopulationSizeController::reset ()
+    {
+      _best_objective.clear ();
+      _unchanged_steps.clear ();
+    }
+
+    /*
+     * Compute the size of the next generation of a population
+     *
+     * Must be called once per step and population.
+     *
+     * \param index      Index of the population in the controller
+     * \param population Current, already evaluated population
+     * \return Number of individuals the next generation should have
+     */
+    unsigned int PopulationSizeController::computeSize
+    (unsigned int index, const Population* population)
+    {
+      unsigned int size = population->size ();
+
+      bool improved = checkImprovement (index, population);
+      double diversity = computeDiversity (population);
+
+      if (diversity < _min_diversity)
+	size = static_cast<unsigned int> (floor (size / _resize_factor));
+      else if (!improved && _unchanged_steps[index] > _max_unchanged_steps)
+	{
+	  size = static_cast<unsigned int> (ceil (size * _resize_factor));
+	  _unchanged_steps[index] = 0;
+	}
+
+      size = std::max (size, _min_size);
+      size = std::min (size, _max_size);
+
+      DV ("* Population " << index << ", diversity=" << diversity <<
+	  ", improved=" << improved << ", size=" << size);
+
+      return size;
+    }
+
+    /*
+     * Compute the diversity of a population
+     *
+     * The default implementation uses the share of distinct genotypes if
+     * diversity metrics are attached to the population. Otherwise the share
+     * of distinct objective values (or fitness values, if no objective is
+     * known) serves as a proxy.
+     *
+     * \return Diversity in [0, 1]
+     */
+    double PopulationSizeController::computeDiversity
+    (const Population* population) const
+    {
+      if (population->size () == 0)
+	return 0.0;
+
+      const DiversityMetrics* metrics = population->getDiversityMetrics ();
+      if (metrics != 0)
+	return static_cast<double> (metrics->getNumberOfGenotypes ()) /
+	  population->size ();
+
+      std::vector<double> values;
+      values.reserve (population->size ());
+
+      for ( Population::IndividualConstIterator i =
+	      population->getIndividualBegin ();
+	    i != population->getIndividualEnd (); ++i )
+	{
+	  const Individual* individual = *i;
+	  values.push_back (individual->hasObjective () ?
+			    individual->getObjective () :
+			    individual->getFitness ());
+	}
+
+      std::sort (values.begin (), values.end ());
+      unsigned int distinct =
+	std::unique (values.begin (), values.end ()) - values.begin ();
+
+      return static_cast<double> (distinct) / population->size ();
+    }
+
+    /*
+     * Check if the best objective of a population improved since the
+     * last step
+     */
+    bool PopulationSizeController::checkImprovement
+    (unsigned int index, const Population* population)
+    {
+      if (index >= _best_objective.size ())
+	{
+	  _best_objective.resize (index + 1,
+				  std::numeric_limits<double>::max ());
+	  _unchanged_steps.resize (index + 1, 0);
+	}
+
+      double best = std::numeric_limits<double>::max ();
+      for ( Population::IndividualConstIterator i =
+	      population->getIndividualBegin ();
+	    i != population->getIndividualEnd (); ++i )
+	if ((*i)->hasObjective ())
+	  best = std::min (best, (*i)->getObjective ());
+
+      bool improved = best < _best_objective[index];
+
+      if (improved)
+	{
+	  _best_objective[index] = best;
+	  _unchanged_steps[index] = 0;
+	}
+      else
+	++_unchanged_steps[index];
+
+      return improved;
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -0,0 +1,480 @@
+/*
+ * core_process_evaluator.cpp - Objective evaluation in worker processes
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+//#define _DEBUG
+
+#include "GEPCoreProcessEvaluator.hpp"
+#include "GEPCoreIndividual.hpp"
+
+#include <GEPDebug.hpp>
+#include <GEPException.hpp>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+namespace GEP {
+  namespace Core {
+
+    namespace {
+
+      const char REQUEST_MAGIC[]  = { 'G', 'E', 'P', 'Q' };
+      const char RESPONSE_MAGIC[] = { 'G', 'E', 'P', 'R' };
+
+      const unsigned int HEADER_SIZE = 4 + 2 * sizeof (quint32);
+
+      /* Append a 32 bit integer to a buffer */
+      inline void appendInteger (std::string* buffer, quint32 value)
+      {
+	buffer->append (reinterpret_cast<const char*> (&value), sizeof (value));
+      }
+
+      /* Read a 32 bit integer from a buffer */
+      inline quint32 readInteger (const std::string& buffer, unsigned int pos)
+      {
+	quint32 value;
+	memcpy (&value, buffer.data () + pos, sizeof (value));
+	return value;
+      }
+
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::ProcessEvaluator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * The worker processes are started on the first evaluation.
+     *
+     * \param command           Shell command starting a single worker
+     * \param encoder           Encoder for the genomes (will be deleted by
+     *                          the evaluator)
+     * \param number_of_workers Number of parallel worker processes
+     * \param batch_size        Maximum number of genomes per request
+     * \param concurrency       Maximum number of unanswered requests per
+     *                          worker
+     * \param timeout           Time in ms a worker may take for a batch
+     * \param max_retries       Number of times a batch is sent again after
+     *                          worker failures before giving up
+     */
+    ProcessEvaluator::ProcessEvaluator (const QString& command,
+					GenomeEncoder* encoder,
+					unsigned int number_of_workers,
+					unsigned int batch_size,
+					unsigned int concurrency,
+					unsigned int timeout,
+					unsigned int max_retries)
+      : Evaluator (),
+	_command            (qPrintable (command)),
+	_encoder            (encoder),
+	_batch_size         (batch_size),
+	_concurrency        (concurrency),
+	_timeout            (timeout),
+	_max_retries        (max_retries),
+	_workers            (number_of_workers),
+	_next_batch_id      (0),
+	_number_of_restarts (0)
+    {
+      if (_encoder == 0)
+	throw InternalException ("No genome encoder given");
+
+      if (number_of_workers == 0 || _batch_size == 0 || _concurrency == 0)
+	throw InternalException ("Illegal worker pool configuration");
+
+      for (unsigned int i=0; i < _workers.size (); ++i)
+	{
+	  _workers[i]._pid = -1;
+	  _workers[i]._fd = -1;
+	  _workers[i]._deadline = 0;
+	}
+    }
+
+    /*
+     * Destructor
+     *
+     * Closing the socket signals end of input to the workers, which are
+     * terminated in addition in case they do not exit by themselves.
+     */
+    ProcessEvaluator::~ProcessEvaluator ()
+    {
+      for (unsigned int i=0; i < _workers.size (); ++i)
+	{
+	  Worker* worker = &_workers[i];
+
+	  if (worker->_fd >= 0)
+	    close (worker->_fd);
+
+	  if (worker->_pid > 0)
+	    {
+	      kill (worker->_pid, SIGTERM);
+	      waitpid (worker->_pid, 0, 0);
+	    }
+	}
+
+      delete _encoder;
+    }
+
+    /*
+     * Compute the objectives of a set of individuals
+     *
+     * The individuals are split into batches which are distributed over
+     * the workers. Returns when all objectives are set.
+     */
+    void ProcessEvaluator::evaluate (const std::vector<Individual*>& individuals)
+    {
+      std::deque<Batch> pending;
+
+      for (unsigned int i=0; i < individuals.size (); i += _batch_size)
+	{
+	  Batch batch;
+	  batch._id = _next_batch_id++;
+	  batch._begin = i;
+	  batch._end = std::min (i + _batch_size,
+				 static_cast<unsigned int> (individuals.size ()));
+	  batch._retries = 0;
+
+	  pending.push_back (batch);
+	}
+
+      unsigned int remaining = individuals.size ();
+      std::vector<pollfd> fds (_workers.size ());
+
+      while (remaining > 0)
+	{
+	  //
+	  // Step 1: Fill the request queues of the workers
+	  //
+	  for (unsigned int i=0; i < _workers.size (); ++i)
+	    {
+	      Worker* worker = &_workers[i];
+
+	      while (!pending.empty () &&
+		     worker->_batches.size () < _concurrency)
+		{
+		  if (worker->_pid <= 0)
+		    startWorker (worker);
+
+		  send (worker, pending.front (), individuals);
+		  pending.pop_front ();
+		}
+	    }
+
+	  //
+	  // Step 2: Wait for workers being ready or timed out
+	  //
+	  quint64 now = getTime ();
+	  quint64 deadline = now + _timeout;
+
+	  for (unsigned int i=0; i < _workers.size (); ++i)
+	    {
+	      const Worker& worker = _workers[i];
+
+	      fds[i].fd = -1;
+	      fds[i].events = 0;
+	      fds[i].revents = 0;
+
+	      if (!worker._batches.empty ())
+		{
+		  fds[i].fd = worker._fd;
+		  fds[i].events = POLLIN | (worker._output.empty () ? 0 : POLLOUT);
+		  deadline = std::min (deadline, worker._deadline);
+		}
+	    }
+
+	  int result = poll (&fds[0], fds.size (),
+			     deadline > now ? static_cast<int> (deadline - now) : 0);
+
+	  if (result < 0 && errno != EINTR)
+	    throw InternalException (QString ("Polling workers failed: %1")
+				     .arg (strerror (errno)));
+
+	  //
+	  // Step 3: Exchange data and restart failed workers
+	  //
+	  now = getTime ();
+
+	  for (unsigned int i=0; i < _workers.size (); ++i)
+	    {
+	      Worker* worker = &_workers[i];
+	      if (worker->_batches.empty ())
+		continue;
+
+	      bool ok = true;
+
+	      if (result > 0 && (fds[i].revents & POLLOUT))
+		ok = flush (worker);
+
+	      if (ok && result > 0 &&
+		  (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+		ok = receive (worker, individuals, &remaining);
+
+	      if (ok && !worker->_batches.empty () && now >= worker->_deadline)
+		{
+		  DV ("* Worker " << worker->_pid << " timed out");
+		  ok = false;
+		}
+
+	      if (!ok)
+		restartWorker (worker, &pending);
+	    }
+	}
+    }
+
+    /* Start a worker process connected via a Unix socket */
+    void ProcessEvaluator::startWorker (Worker* worker)
+    {
+      int fds[2];
+      if (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+	throw InternalException (QString ("Cannot create worker socket: %1")
+				 .arg (strerror (errno)));
+
+      pid_t pid = fork ();
+      if (pid < 0)
+	{
+	  close (fds[0]);
+	  close (fds[1]);
+	  throw InternalException (QString ("Cannot start worker: %1")
+				   .arg (strerror (errno)));
+	}
+
+      if (pid == 0)
+	{
+	  dup2 (fds[1], STDIN_FILENO);
+	  dup2 (fds[1], STDOUT_FILENO);
+	  close (fds[0]);
+	  if (fds[1] > STDOUT_FILENO)
+	    close (fds[1]);
+
+	  execl ("/bin/sh", "sh", "-c", _command.c_str (), (char*)0);
+	  _exit (127);
+	}
+
+      close (fds[1]);
+      fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+      fcntl (fds[0], F_SETFL, fcntl (fds[0], F_GETFL) | O_NONBLOCK);
+
+      worker->_pid = pid;
+      worker->_fd = fds[0];
+      worker->_output.clear ();
+      worker->_input.clear ();
+
+      DV ("* Started worker " << pid);
+    }
+
+    /* Kill a worker process and close its connection */
+    void ProcessEvaluator::stopWorker (Worker* worker)
+    {
+      if (worker->_fd >= 0)
+	close (worker->_fd);
+
+      if (worker->_pid > 0)
+	{
+	  kill (worker->_pid, SIGKILL);
+	  waitpid (worker->_pid, 0, 0);
+	}
+
+      worker->_pid = -1;
+      worker->_fd = -1;
+      worker->_output.clear ();
+      worker->_input.clear ();
+    }
+
+    /*
+     * Restart a failed worker
+     *
+     * The unanswered batches are queued again. Since the batches are
+     * processed in order, only the first one is blamed for the failure.
+     * If it failed too often, all workers with pending work are stopped to
+     * discard stale answers and the evaluation is aborted.
+     */
+    void ProcessEvaluator::restartWorker (Worker* worker,
+					  std::deque<Batch>* pending)
+    {
+      stopWorker (worker);
+      ++_number_of_restarts;
+
+      if (!worker->_batches.empty ())
+	++worker->_batches.front ()._retries;
+
+      pending->insert (pending->begin (),
+		       worker->_batches.begin (), worker->_batches.end ());
+      worker->_batches.clear ();
+
+      if (!pending->empty () && pending->front ()._retries > _max_retries)
+	{
+	  for (unsigned int i=0; i < _workers.size (); ++i)
+	    if (!_workers[i]._batches.empty ())
+	      {
+		stopWorker (&_workers[i]);
+		_workers[i]._batches.clear ();
+	      }
+
+	  throw InternalException ("Worker failed too often");
+	}
+    }
+
+    /* Queue the request for a batch and send as much as possible */
+    void ProcessEvaluator::send (Worker* worker, const Batch& batch,
+				 const std::vector<Individual*>& individuals)
+    {
+      std::string& output = worker->_output;
+
+      output.append (REQUEST_MAGIC, sizeof (REQUEST_MAGIC));
+      appendInteger (&output, batch._id);
+      appendInteger (&output, batch._end - batch._begin);
+
+      std::string genome;
+      for (unsigned int i=batch._begin; i < batch._end; ++i)
+	{
+	  genome.clear ();
+	  _encoder->encode (individuals[i], &genome);
+
+	  appendInteger (&output, genome.size ());
+	  output.append (genome);
+	}
+
+      if (worker->_batches.empty ())
+	worker->_deadline = getTime () + _timeout;
+
+      worker->_batches.push_back (batch);
+
+      flush (worker);
+    }
+
+    /*
+     * Write pending output to a worker without blocking
+     *
+     * \return false if the connection failed
+     */
+    bool ProcessEvaluator::flush (Worker* worker)
+    {
+      std::string& output = worker->_output;
+      unsigned int pos = 0;
+
+      while (pos < output.size ())
+	{
+	  ssize_t n = ::send (worker->_fd, output.data () + pos,
+			      output.size () - pos, MSG_NOSIGNAL);
+	  if (n < 0)
+	    {
+	      if (errno == EINTR)
+		continue;
+	      if (errno == EAGAIN || errno == EWOULDBLOCK)
+		break;
+	      output.erase (0, pos);
+	      return false;
+	    }
+
+	  pos += n;
+	}
+
+      output.erase (0, pos);
+      return true;
+    }
+
+    /*
+     * Read and process available responses of a worker without blocking
+     *
+     * \return false if the connection failed or the protocol was violated
+     */
+    bool ProcessEvaluator::receive (Worker* worker,
+				    const std::vector<Individual*>& individuals,
+				    unsigned int* remaining)
+    {
+      std::string& input = worker->_input;
+      bool closed = false;
+
+      for (;;)
+	{
+	  char buffer[4096];
+	  ssize_t n = recv (worker->_fd, buffer, sizeof (buffer), 0);
+
+	  if (n > 0)
+	    input.append (buffer, n);
+	  else if (n == 0)
+	    {
+	      closed = true;
+	      break;
+	    }
+	  else if (errno == EINTR)
+	    continue;
+	  else if (errno == EAGAIN || errno == EWOULDBLOCK)
+	    break;
+	  else
+	    return false;
+	}
+
+      unsigned int pos = 0;
+
+      while (input.size () - pos >= HEADER_SIZE)
+	{
+	  if (worker->_batches.empty () ||
+	      memcmp (input.data () + pos, RESPONSE_MAGIC,
+		      sizeof (RESPONSE_MAGIC)) != 0)
+	    return false;
+
+	  const Batch& batch = worker->_batches.front ();
+	  quint32 id = readInteger (input, pos + 4);
+	  quint32 count = readInteger (input, pos + 8);
+
+	  if (id != batch._id || count != batch._end - batch._begin)
+	    return false;
+
+	  if (input.size () - pos < HEADER_SIZE + count * sizeof (double))
+	    break;
+
+	  const char* values = input.data () + pos + HEADER_SIZE;
+	  for (unsigned int i=0; i < count; ++i)
+	    {
+	      double objective;
+	      memcpy (&objective, values + i * sizeof (double), sizeof (double));
+	      individuals[batch._begin + i]->setObjective (objective);
+	    }
+
+	  pos += HEADER_SIZE + count * sizeof (double);
+	  *remaining -= count;
+
+	  worker->_batches.pop_front ();
+	  worker->_deadline = getTime () + _timeout;
+	}
+
+      input.erase (0, pos);
+
+      if (closed)
+	{
+	  DV ("* Worker " << worker->_pid << " closed connection");
+
+	  if (!worker->_batches.empty () || !input.empty ())
+	    return false;
+
+	  stopWorker (worker);
+	}
+
+      return true;
+    }
+
+    /* [STATIC] Return a monotonic time stamp in ms */
+    quint64 ProcessEvaluator::getTime ()
+    {
+      timespec now;
+      clock_gettime (CLOCK_MONOTONIC, &now);
+
+      return static_cast<quint64> (now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -0,0 +1,160 @@
+/*
+ * core_restart.cpp - Restart policy for stagnated populations
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCoreRestart.hpp"
+#include "GEPCoreIndividual.hpp"
+#include "GEPCorePopulation.hpp"
+
+#include <GEPException.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RestartPolicy
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param max_unchanged_steps Number of steps without improvement after
+     *                            which a population restarts
+     * \param number_of_elites    Number of individuals kept in the elite
+     *                            archive and reinserted on restart
+     * \param population_growth   Factor the population size is multiplied
+     *                            with on each restart
+     * \param max_population_size Upper population size limit (0: unlimited)
+     */
+    RestartPolicy::RestartPolicy (unsigned int max_unchanged_steps,
+				  unsigned int number_of_elites,
+				  double population_growth,
+				  unsigned int max_population_size)
+      : _max_unchanged_steps (max_unchanged_steps),
+	_number_of_elites    (number_of_elites),
+	_population_growth   (population_growth),
+	_max_population_size (max_population_size)
+    {
+      if (_max_unchanged_steps == 0)
+	throw InternalException ("Number of unchanged steps must be positive");
+
+      if (_population_growth < 1.0)
+	throw InternalException ("Population growth factor must be >= 1.0");
+    }
+
+    /* Destructor */
+    RestartPolicy::~RestartPolicy ()
+    {
+    }
+
+    /* Reset stagnation state */
+    void RestartPolicy::reset ()
+    {
+      _last_value.clear ();
+      _unchanged_steps.clear ();
+    }
+
+    /*
+     * Check if a population stagnated
+     *
+     * Must be called once per step and population. The stagnation state of
+     * the population is cleared if 'true' is returned, because the
+     * population is restarted afterwards.
+     *
+     * \param index      Index of the population in the controller
+     * \param population Population to check
+     * \return 'true', if the population should be restarted
+     */
+    bool RestartPolicy::stagnated (unsigned int index,
+				   const Population* population)
+    {
+      if (index >= _last_value.size ())
+	{
+	  _last_value.resize (index + 1, std::numeric_limits<double>::max ());
+	  _unchanged_steps.resize (index + 1, 0);
+	}
+
+      //
+      // Stagnation is measured via the best raw objective value if the
+      // population computes one...
+      //
+      bool has_objective = population->size () > 0;
+      double best_objective = std::numeric_limits<double>::max ();
+      double average_fitness = 0.0;
+
+      for ( Population::IndividualConstIterator i =
+	      population->getIndividualBegin ();
+	    i != population->getIndividualEnd (); ++i )
+	{
+	  const Individual* individual = *i;
+
+	  if (individual->hasObjective ())
+	    best_objective = std::min (best_objective,
+				       individual->getObjective ());
+	  else
+	    has_objective = false;
+
+	  average_fitness += individual->getFitness ();
+	}
+
+      bool unchanged = false;
+
+      if (has_objective)
+	{
+	  unchanged = best_objective >= _last_value[index];
+	  _last_value[index] = std::min (_last_value[index], best_objective);
+	}
+
+      //
+      // ...or via the average fitness otherwise
+      //
+      else
+	{
+	  if (population->size () > 0)
+	    average_fitness /= population->size ();
+
+	  unchanged = fabs (_last_value[index] - average_fitness) <
+	    std::numeric_limits<double>::epsilon ();
+	  _last_value[index] = average_fitness;
+	}
+
+      if (unchanged)
+	++_unchanged_steps[index];
+      else
+	_unchanged_steps[index] = 0;
+
+      bool restart = _unchanged_steps[index] > _max_unchanged_steps;
+
+      if (restart)
+	{
+	  _last_value[index] = std::numeric_limits<double>::max ();
+	  _unchanged_steps[index] = 0;
+	}
+
+      return restart;
+    }
+
+    /*
+     * Compute the size of a restarted population
+     *
+     * \param size Size of the stagnated population
+     */
+    unsigned int RestartPolicy::computePopulationSize (unsigned int size) const
+    {
+      unsigned int new_size =
+	static_cast<unsigned int> (ceil (size * _population_growth));
+
+      if (_max_population_size > 0 && new_size > _max_population_size)
+	new_size = std::max (size, _max_population_size);
+
+      return new_size;
+    }
+
+  } // namespace Core
+} // namespace GEP
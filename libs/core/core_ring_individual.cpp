@@ -6,13 +6,22 @@
 
 //#define _DEBUG
 
+#include "GEPCoreNeighbourhood.hpp"
 #include "GEPCorePopulation.hpp"
 #include "GEPCoreRingIndividual.hpp"
 
+#include <GEPCircularSpan.hpp>
 #include <GEPDebug.hpp>
 #include <GEPException.hpp>
 
-#include <set>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadStorage>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <math.h>
 
 namespace GEP
 {
@@ -34,316 +43,1834 @@ namespace GEP
       *object_2 = temp;
     }
 
+    /*
+     * Set of genes with their chromosome positions
+     *
+     * The genes are used as array indices, so membership tests are O(1).
+     * Instead of clearing the arrays, each use gets a new stamp value. One
+     * instance is kept per thread, so no allocation is necessary once the
+     * arrays have grown to the chromosome size.
+     */
+    class GeneIndex
+    {
+    public:
+      GeneIndex ()
+	: _stamp (0)
+      {}
 
-    //#***********************************************************************
-    // CLASS GEP::Core::RingIndividual
-    //#***********************************************************************
+      static GeneIndex* getInstance (const RingIndividual::Chromosome& genes);
 
-    /* Constructor */
-    RingIndividual::RingIndividual ()
-      : Individual ()
-    {}
-    
-    /* Copy constructor */
-    RingIndividual::RingIndividual (const RingIndividual& toCopy)
-      : Individual (toCopy),
-        _chromosome (toCopy._chromosome)
-    {}
-    
-    /* Destructor */
-    RingIndividual::~RingIndividual ()
-    {}
-    
-    /* Set chromosome */
-    void RingIndividual::setChromosome (const Chromosome& chromosome)
+      inline void insert (RingIndividual::Gene gene, unsigned int position)
+      {
+	_stamps[gene] = _stamp;
+	_positions[gene] = position;
+      }
+
+      /*
+       * Insert a sequence of genes
+       *
+       * \param genes  Sequence within a chromosome
+       * \param origin First gene of that chromosome, so the positions can be
+       *               derived from the gene addresses
+       */
+      void insert (const CircularSpan<const RingIndividual::Gene>& genes,
+		   const RingIndividual::Gene* origin)
+      {
+	const RingIndividual::Gene* run = genes.getFirst ();
+	for (unsigned int i=0; i < genes.getFirstLength (); ++i)
+	  insert (run[i], run + i - origin);
+
+	run = genes.getSecond ();
+	for (unsigned int i=0; i < genes.getSecondLength (); ++i)
+	  insert (run[i], run + i - origin);
+      }
+
+      inline void remove (RingIndividual::Gene gene)
+      {
+	_stamps[gene] = _stamp - 1;
+      }
+
+      inline bool contains (RingIndividual::Gene gene) const
+      {
+	return gene < _stamps.size () && _stamps[gene] == _stamp;
+      }
+
+      inline unsigned int getPosition (RingIndividual::Gene gene) const
+      {
+	return _positions[gene];
+      }
+
+      void clear ();
+
+    private:
+      std::vector<unsigned int> _stamps;
+      std::vector<unsigned int> _positions;
+      unsigned int _stamp;
+    };
+
+    static QThreadStorage<GeneIndex*> gene_indices;
+
+    /*
+     * Return the empty gene index of the calling thread
+     *
+     * \param genes Genes which are going to be inserted into the index
+     */
+    GeneIndex* GeneIndex::getInstance (const RingIndividual::Chromosome& genes)
     {
-      _chromosome = chromosome;
-    }
+      if (!gene_indices.hasLocalData ())
+	gene_indices.setLocalData (new GeneIndex ());
 
+      GeneIndex* index = gene_indices.localData ();
 
-    //#***********************************************************************
-    // CLASS GEP::Core::RingPartiallyMatchedCrossoverOperator
-    //#***********************************************************************
+      RingIndividual::Gene max_gene = 0;
+      for (unsigned int i=0; i < genes.size (); ++i)
+	max_gene = std::max (max_gene, genes[i]);
 
-    /* Constructor */
-    RingPartiallyMatchedCrossoverOperator::
-    RingPartiallyMatchedCrossoverOperator ()
-      : CrossoverOperator ("Partially matched crossover")
+      if (max_gene >= index->_stamps.size ())
+	{
+	  index->_stamps.resize (max_gene + 1, 0);
+	  index->_positions.resize (max_gene + 1, 0);
+	}
+
+      index->clear ();
+      return index;
+    }
+
+    /* Remove all genes from the index */
+    void GeneIndex::clear ()
     {
+      if (++_stamp == 0)
+	{
+	  std::fill (_stamps.begin (), _stamps.end (), 0);
+	  _stamp = 1;
+	}
     }
 
-    /* Destructor */
-    RingPartiallyMatchedCrossoverOperator::
-    ~RingPartiallyMatchedCrossoverOperator ()
-    {}
+    /*
+     * Scratch arrays of the edge recombination crossover
+     *
+     * Each gene has at most four neighbours in the union of the parent
+     * edges, so the edge table is a flat array with four slots per gene.
+     * One instance is kept per thread, so no allocation is necessary once
+     * the arrays have grown to the largest gene.
+     */
+    struct EdgeTable
+    {
+      static EdgeTable* getInstance ();
 
-    /* Execute crossover operation */
-    void RingPartiallyMatchedCrossoverOperator::crossover
-    (const Individual* individual_1,
-     const Individual* individual_2,
-     Population* target) const
+      void prepare (const RingIndividual::Chromosome& parent_1,
+		    const RingIndividual::Chromosome& parent_2);
+
+      std::vector<RingIndividual::Gene> neighbours;
+      std::vector<unsigned char> number_of_neighbours;
+      std::vector<RingIndividual::Gene> unvisited;
+      std::vector<unsigned int> unvisited_positions;
+    };
+
+    static QThreadStorage<EdgeTable*> edge_tables;
+
+    /* Return the edge table of the calling thread */
+    EdgeTable* EdgeTable::getInstance ()
     {
-      DV ("* Crossover");
+      if (!edge_tables.hasLocalData ())
+	edge_tables.setLocalData (new EdgeTable ());
 
-      const RingIndividual* ring_1 =
-        dynamic_cast<const RingIndividual*> (individual_1);
-      if (ring_1 == 0)
-        throw InternalException ("Individual is not a ring object");
+      return edge_tables.localData ();
+    }
 
-      const RingIndividual* ring_2 =
-        dynamic_cast<const RingIndividual*> (individual_2);
-      if (ring_2 == 0)
+    /*
+     * Prepare the table for a child of two parents
+     *
+     * The arrays grow to the largest parent gene. Only the entries of the
+     * parent genes are cleared, all genes of the first parent are
+     * unvisited.
+     */
+    void EdgeTable::prepare (const RingIndividual::Chromosome& parent_1,
+			     const RingIndividual::Chromosome& parent_2)
+    {
+      for (unsigned int i=0; i < parent_1.size (); ++i)
+	{
+	  RingIndividual::Gene max_gene = std::max (parent_1[i], parent_2[i]);
+
+	  if (max_gene >= number_of_neighbours.size ())
+	    {
+	      neighbours.resize (4 * (max_gene + 1));
+	      number_of_neighbours.resize (max_gene + 1, 0);
+	      unvisited_positions.resize (max_gene + 1, 0);
+	    }
+
+	  number_of_neighbours[parent_1[i]] = 0;
+	  number_of_neighbours[parent_2[i]] = 0;
+	}
+
+      unvisited.assign (parent_1.begin (), parent_1.end ());
+
+      for (unsigned int i=0; i < unvisited.size (); ++i)
+	unvisited_positions[unvisited[i]] = i;
+    }
+
+    /*
+     * Cast individual into a ring individual
+     */
+    static const RingIndividual* toRing (const Individual* individual)
+    {
+      const RingIndividual* ring =
+        dynamic_cast<const RingIndividual*> (individual);
+      if (ring == 0)
         throw InternalException ("Individual is not a ring object");
 
-      RingIndividual::Chromosome chromosome_1 = ring_1->getChromosome ();
-      RingIndividual::Chromosome chromosome_2 = ring_2->getChromosome ();
-      
+      return ring;
+    }
+
+    /*
+     * Check that two parent chromosomes can be recombined
+     */
+    static void checkParents (const RingIndividual::Chromosome& chromosome_1,
+			      const RingIndividual::Chromosome& chromosome_2)
+    {
       if (chromosome_1.size () != chromosome_2.size ())
 	throw InternalException ("Chromosomes have different sizes");
-      
+
       if (chromosome_1.size () < 3)
 	throw InternalException ("Chromosome size must be at least 3 "
 				 "for this operator");
-      
-      //
-      // Select gene cutting locations
-      //
-      unsigned int size = chromosome_1.size ();
-      unsigned int index_1 = _random.getInt (0, size - 1);
-      unsigned int index_2 = index_1 + _random.getInt (1, size - 2);
-      
-      DV ("  index_1=" << index_1 << ", index_2=" << (index_2 % size));
-      
-      //
-      // Cut gene sequence and adapt individuals
-      //
-      std::vector<RingIndividual::Gene> cut_1 (index_2 - index_1 + 1);
-      std::vector<RingIndividual::Gene> cut_2 (index_2 - index_1 + 1);
-      
-      for (unsigned int i=index_1; i <= index_2; ++i)
-        {
-          cut_1[(i - index_1) % size] = chromosome_1[i % size];
-          cut_2[(i - index_1) % size] = chromosome_2[i % size];
-        }
-      
-      adaptChromosome (index_1, index_2, cut_1, chromosome_2);
-      adaptChromosome (index_1, index_2, cut_2, chromosome_1);
-      
-      RingIndividual* target_1 =
-	dynamic_cast<RingIndividual*> (ring_1->clone ());
-      target_1->setChromosome (chromosome_1);
-      target->addIndividual (target_1);
-      
-      RingIndividual* target_2 =
-	dynamic_cast<RingIndividual*> (ring_2->clone ());
-      target_2->setChromosome (chromosome_2);
-      target->addIndividual (target_2);
     }
 
+    /*
+     * Add a crossover child to the target population
+     *
+     * \param parent     Parent the child is cloned from
+     * \param other      Other parent, used for the mutation rate
+     * \param chromosome Chromosome of the child
+     * \param target     Target population
+     */
+    static void addChild (const RingIndividual* parent,
+			  const RingIndividual* other,
+			  const RingIndividual::Chromosome& chromosome,
+			  Population* target)
+    {
+      RingIndividual* child = dynamic_cast<RingIndividual*> (parent->clone ());
+      child->setChromosome (chromosome);
+      child->recombineMutationRate (other);
+      target->addIndividual (child);
+    }
+
+    /*
+     * Mix bits of a 64 bit value (finalizer of the SplitMix64 generator)
+     */
+    static inline quint64 mix (quint64 value)
+    {
+      value ^= value >> 30;
+      value *= 0xbf58476d1ce4e5b9ULL;
+      value ^= value >> 27;
+      value *= 0x94d049bb133111ebULL;
+      value ^= value >> 31;
+      return value;
+    }
 
     /*
-     * Insert cut sequence into chromosome)
+     * Compute key of the undirected edge between two genes
      */
-    void RingPartiallyMatchedCrossoverOperator::adaptChromosome
-    (unsigned int index_1, unsigned int index_2,
-     const std::vector<RingIndividual::Gene>& cut,
-     RingIndividual::Chromosome& chromosome) const
+    static inline quint64 computeEdgeKey (RingIndividual::Gene gene_1,
+					  RingIndividual::Gene gene_2)
     {
-      typedef RingIndividual::Gene Gene;
-      unsigned int size = chromosome.size ();
+      if (gene_1 > gene_2)
+	swap (&gene_1, &gene_2);
 
-      //
-      // Step 1: Keep the removed chromosomes for later insertion
-      //
-      std::vector<Gene> removed (index_2 - index_1 + 1);
-      for (unsigned int i=index_1; i <= index_2; ++i)
-        removed[(i - index_1) % size] = chromosome[i % size];
+      return (static_cast<quint64> (gene_1) << 32) | gene_2;
+    }
 
-      //
-      // Step 2: Replace the gene sequence
-      //
-      std::set<Gene> inserted;
-      for (unsigned int i=0; i < cut.size (); ++i)
-      {
-        chromosome[(index_1 + i) % size] = cut[i];
-        inserted.insert (cut[i]);
-      }
+    /*
+     * Compute x * log (x) with 0 * log (0) = 0
+     */
+    static inline double xlogx (double x)
+    {
+      return x > 0.0 ? x * log (x) : 0.0;
+    }
 
-      //
-      // Step 3: Find the genes which have just been removed and are not part
-      //         of the inserted sequence. These genes must be placed
-      //         outside of the swapped area in the next step.
-      //
-      std::vector<Gene> replacements;
-      for (unsigned int i=0; i < removed.size (); ++i)
-        if (inserted.find (removed[i]) == inserted.end ())
-          replacements.push_back (removed[i]);
+    /*
+     * Swap each gene with the given probability against a random other gene
+     *
+     * Instead of drawing a random number per gene, the distance to the next
+     * mutated gene is drawn from the geometric distribution, so the cost is
+     * proportional to the number of mutations (usually pm = 1 / size).
+     */
+    static void mutateUniform (const Random& random,
+			       RingIndividual::Chromosome& chromosome,
+			       double mutation_probability)
+    {
+      unsigned int size = chromosome.size ();
 
-      //
-      // Step 4: Find double genes outside of the just swapped area
-      //
-      for (unsigned int i=0; i < size; ++i)
-      {
-        bool index_ok = true;
-        if (index_1 < index_2 % size)
-          index_ok = i < index_1 || i > index_2;
-        else
-          index_ok = i > index_2 % size && i < index_1;
-
-        //
-        // Check, if we are within the unswapped sequence and the gene at
-        // this position is part of the just inserted chromosome snippet. If
-        // so, replace it with a randomly selected gene from the replacement
-        // vector.
-        //
-        if (index_ok && inserted.find (chromosome[i]) != inserted.end ())
-        {
-          unsigned int replacement_index =
-            _random.getInt (0, replacements.size () - 1);
-          chromosome[i] = replacements[replacement_index];
-
-          for ( unsigned int j=replacement_index + 1;
-                j < replacements.size (); ++j )
-            replacements[j-1] = replacements[j];
-
-          replacements.pop_back ();
-        }
+      if (mutation_probability <= 0.0)
+	return;
+
+      double log_q = log1p (-mutation_probability);
+
+      for (unsigned int index_1=0; index_1 < size; ++index_1)
+	{
+	  //
+	  // Skip the genes which are not mutated. With pm = 1 the skip is
+	  // always 0.
+	  //
+	  if (mutation_probability < 1.0)
+	    {
+	      double skip =
+		floor (log (1.0 - random.getDouble (0.0, 1.0)) / log_q);
+
+	      if (skip >= size - index_1)
+		break;
+
+	      index_1 += static_cast<unsigned int> (skip);
+	    }
+
+	  //
+	  // Draw the swap partner from the other size - 1 genes
+	  //
+	  unsigned int index_2 = random.getInt (0, size - 2);
+	  if (index_2 >= index_1)
+	    ++index_2;
+
+	  swap (&chromosome[index_1], &chromosome[index_2]);
       }
     }
 
 
     //#***********************************************************************
-    // CLASS GEP::Core::RingResortingCrossoverOperator
+    // CLASS GEP::Core::RingIndividual
     //#***********************************************************************
 
-    /* Constructor */
-    RingResortingCrossoverOperator::RingResortingCrossoverOperator ()
-      : CrossoverOperator ("Resorting crossover")
+    /*
+     * Constructor
+     *
+     * \param round_trip If 'false', the chromosome is an open path and the
+     *                   edge from the last gene to the first one is left
+     *                   out of the genotype hash
+     */
+    RingIndividual::RingIndividual (bool round_trip)
+      : Individual (),
+	_round_trip     (round_trip),
+	_hash           (0),
+	_has_change_log (false)
+    {}
+    
+    /*
+     * Copy constructor
+     *
+     * The objective of an evaluated individual becomes the parent objective
+     * of the copy, so its change log, which relates to the objective of the
+     * grandparent, is not copied.
+     */
+    RingIndividual::RingIndividual (const RingIndividual& toCopy)
+      : Individual (toCopy),
+	_round_trip     (toCopy._round_trip),
+        _chromosome     (toCopy._chromosome),
+	_hash           (toCopy._hash),
+	_has_change_log (toCopy._has_change_log && !toCopy.hasObjective ())
     {
+      if (_has_change_log)
+	{
+	  _change_log = toCopy._change_log;
+	  _former_genes = toCopy._former_genes;
+	}
     }
-
+    
     /* Destructor */
-    RingResortingCrossoverOperator::~RingResortingCrossoverOperator ()
+    RingIndividual::~RingIndividual ()
     {}
 
-    /* Execute crossover operation */
-    void RingResortingCrossoverOperator::crossover
-    (const Individual* individual_1,
-     const Individual* individual_2,
-     Population* target) const
+    /* Return the direction invariant genotype hash, see computeHash () */
+    quint64 RingIndividual::getHash () const
     {
-      DV ("* Crossover");
+      return _hash;
+    }
+    
+    /*
+     * Set chromosome
+     *
+     * A changed chromosome invalidates the objective value, so the
+     * individual is evaluated again. If only a few positions differ from the
+     * current chromosome, the runs of changed positions are recorded in the
+     * change log like any other edit, so swaps or replaced ranges can be
+     * evaluated incrementally, too.
+     */
+    void RingIndividual::setChromosome (const Chromosome& chromosome)
+    {
+      if (chromosome == _chromosome)
+	return;
 
-      const RingIndividual* ring_1 =
-        dynamic_cast<const RingIndividual*> (individual_1);
-      if (ring_1 == 0)
-        throw InternalException ("Individual is not a ring object");
+      unsigned int size = chromosome.size ();
 
-      const RingIndividual* ring_2 =
-        dynamic_cast<const RingIndividual*> (individual_2);
-      if (ring_2 == 0)
-        throw InternalException ("Individual is not a ring object");
-      
-      RingIndividual::Chromosome chromosome_1 = ring_1->getChromosome ();
-      RingIndividual::Chromosome chromosome_2 = ring_2->getChromosome ();
+      if (size == _chromosome.size () && (hasObjective () || _has_change_log))
+	{
+	  ChangeLog runs;
+	  unsigned int changed = 0;
+
+	  for (unsigned int i=0; i < size && changed <= size / 4; )
+	    if (chromosome[i] != _chromosome[i])
+	      {
+		Change run;
+		run.position = i;
+		run.offset = 0;
+
+		while (i < size && chromosome[i] != _chromosome[i])
+		  ++i;
+
+		run.length = i - run.position;
+		runs.push_back (run);
+		changed += run.length;
+	      }
+	    else
+	      ++i;
+
+	  if (changed <= size / 4)
+	    {
+	      //
+	      // Runs at both chromosome ends are a single wrapped run
+	      //
+	      if (runs.size () > 1 && runs.front ().position == 0 &&
+		  runs.back ().position + runs.back ().length == size)
+		{
+		  runs.back ().length += runs.front ().length;
+		  runs.erase (runs.begin ());
+		}
+
+	      for (unsigned int i=0; i < runs.size (); ++i)
+		beginChange (runs[i].position, runs[i].length);
+
+	      for (unsigned int i=0; i < runs.size (); ++i)
+		makeCircularSpan (chromosome, runs[i].position, runs[i].length)
+		  .copyTo (makeCircularSpan (_chromosome, runs[i].position,
+					     runs[i].length));
+
+	      for (unsigned int i=0; i < runs.size (); ++i)
+		endChange (runs[i].position, runs[i].length);
+
+	      return;
+	    }
+	}
 
-      if (chromosome_1.size () != chromosome_2.size ())
-	throw InternalException ("Chromosomes have different sizes");
+      _chromosome = chromosome;
+      _hash = computeHash (_chromosome, _round_trip);
 
-      if (chromosome_1.size () < 3)
-	throw InternalException ("Chromosome size must be at least 3 "
-				 "for this operator");
+      _has_change_log = false;
+      _change_log.clear ();
+      _former_genes.clear ();
 
-      //
-      // Select gene cutting locations
-      //
-      unsigned int size = chromosome_1.size ();
-      unsigned int index_1 = _random.getInt (0, size - 1);
-      unsigned int index_2 = index_1 + _random.getInt (1, size - 2);
+      clearObjective ();
+    }
 
-      DV ("  index_1=" << index_1 << ", index_2=" << (index_2 % size));
+    /*
+     * Reverse a chromosome sequence
+     *
+     * \param position First position of the sequence
+     * \param length   Sequence length, the sequence may wrap around the
+     *                 chromosome end
+     */
+    void RingIndividual::invert (unsigned int position, unsigned int length)
+    {
+      beginChange (position, length);
+      reverse (position, length);
+      endChange (position, length);
+    }
 
+    /*
+     * Move a chromosome sequence forward
+     *
+     * The genes between the sequence and its new position move backward by
+     * the sequence length, so the changed range covers 'length + distance'
+     * positions.
+     *
+     * \param position First position of the sequence
+     * \param length   Sequence length
+     * \param distance Number of positions the sequence is moved
+     */
+    void RingIndividual::displace (unsigned int position, unsigned int length,
+				   unsigned int distance)
+    {
       //
-      // Cut gene sequence and adapt individuals
+      // Rotation of the affected range by three reversals
       //
-      std::vector<RingIndividual::Gene> cut_1 (index_2 - index_1 + 1);
-      std::vector<RingIndividual::Gene> cut_2 (index_2 - index_1 + 1);
-
-      for (unsigned int i=index_1; i <= index_2; ++i)
-        {
-          cut_1[(i - index_1) % size] = chromosome_1[i % size];
-          cut_2[(i - index_1) % size] = chromosome_2[i % size];
-        }
+      beginChange (position, length + distance);
+      reverse (position, length);
+      reverse (position + length, distance);
+      reverse (position, length + distance);
+      endChange (position, length + distance);
+    }
 
-      insertSequence (cut_1, chromosome_2);
-      insertSequence (cut_2, chromosome_1);
+    /*
+     * Randomly permute the genes of a chromosome sequence
+     *
+     * \param position First position of the sequence
+     * \param length   Sequence length
+     * \param random   Random number generator
+     */
+    void RingIndividual::scramble (unsigned int position, unsigned int length,
+				   const Random& random)
+    {
+      beginChange (position, length);
 
-      RingIndividual* target_1 =
-	dynamic_cast<RingIndividual*> (ring_1->clone ());
-      target_1->setChromosome (chromosome_1);
-      target->addIndividual (target_1);
+      unsigned int size = _chromosome.size ();
+      for (unsigned int i=length - 1; i > 0; --i)
+	swap (&_chromosome[(position + i) % size],
+	      &_chromosome[(position + random.getInt (0, i)) % size]);
 
-      RingIndividual* target_2 =
-	dynamic_cast<RingIndividual*> (ring_2->clone ());
-      target_2->setChromosome (chromosome_2);
-      target->addIndividual (target_2);
+      endChange (position, length);
     }
 
-
     /*
-     * Insert cut sequence into chromosome)
+     * Prepare the change of a chromosome range
+     *
+     * If the objective is known, it becomes the parent objective and a new
+     * change log is started. The edges touching the range are removed from
+     * the hash, so the hash update costs O(length), too.
      */
-    void RingResortingCrossoverOperator::insertSequence
-    (const std::vector<RingIndividual::Gene>& sequence,
-     RingIndividual::Chromosome& chromosome) const
+    void RingIndividual::beginChange (unsigned int position,
+				      unsigned int length)
     {
-      typedef RingIndividual::Gene Gene;
+      unsigned int size = _chromosome.size ();
 
-      if (sequence.size () == 0)
-        throw InternalException ("Attempt to insert zero sequence");
+      if (position >= size || length == 0 || length >= size)
+	throw InternalException ("Invalid chromosome range");
 
-      //
-      // Step 1: Remove all genes from the chromosome which are present in
-      //         the sequence to insert, too
-      //
-      std::set<Gene> inserted_genes (sequence.begin (), sequence.end ());
+      if (hasObjective ())
+	{
+	  _has_change_log = true;
+	  _change_log.clear ();
+	  _former_genes.clear ();
+	}
 
-      RingIndividual::Chromosome target;
+      if (_has_change_log)
+	{
+	  Change change;
+	  change.position = position;
+	  change.length = length;
+	  change.offset = _former_genes.size ();
+	  _change_log.push_back (change);
 
-      unsigned int index = std::numeric_limits<unsigned int>::max ();
-      for (unsigned int i=0; i < chromosome.size (); ++i)
-      {
-        const Gene& gene = chromosome[i];
-
-        //
-        // If the gene is part of the inserted sequence, it is skipped
-        //
-        if (inserted_genes.find (gene) == inserted_genes.end ())
-          target.push_back (gene);
-
-        //
-        // The original position of the sequence starting gene is the
-        // insertion point
-        //
-        else if (gene == sequence[0])
-          index = target.size ();
-      }
+	  for (unsigned int i=position; i < position + length; ++i)
+	    _former_genes.push_back (_chromosome[i % size]);
+	}
 
-      std::vector<Gene>::iterator insertion_pos = target.begin ();
-      insertion_pos += index;
+      _hash -= computeRangeHash (position, length);
 
-      target.insert (insertion_pos, sequence.begin (), sequence.end ());
+      clearObjective ();
+    }
 
-      chromosome = target;
+    /* Complete the change of a chromosome range */
+    void RingIndividual::endChange (unsigned int position, unsigned int length)
+    {
+      _hash += computeRangeHash (position, length);
     }
 
+    /* Reverse a chromosome sequence without any bookkeeping */
+    void RingIndividual::reverse (unsigned int position, unsigned int length)
+    {
+      unsigned int size = _chromosome.size ();
 
-    //#***********************************************************************
-    // CLASS GEP::Core::RingUniformMutationOperator
-    //#***********************************************************************
+      for (unsigned int i=0; i < length / 2; ++i)
+	swap (&_chromosome[(position + i) % size],
+	      &_chromosome[(position + length - 1 - i) % size]);
+    }
 
-    /* Constructor */
-    RingUniformMutationOperator::RingUniformMutationOperator
+    /* Compute the hash part of the edges touching a chromosome range */
+    quint64 RingIndividual::computeRangeHash (unsigned int position,
+					      unsigned int length) const
+    {
+      unsigned int size = _chromosome.size ();
+      quint64 hash = 0;
+
+      for (unsigned int i=position + size - 1; i < position + size + length;
+	   ++i)
+	if (_round_trip || i % size != size - 1)
+	  hash += mix (computeEdgeKey (_chromosome[i % size],
+				       _chromosome[(i + 1) % size]));
+
+      return hash;
+    }
+
+    /*
+     * Compute rotation and direction invariant hash of a ring chromosome
+     *
+     * Zobrist style: the hash is the sum of pseudo random values assigned
+     * to the undirected edges of the ring. Two rings with the same edge set
+     * (the same tour, started anywhere and in any direction) get the same
+     * hash. An open path has no edge from the last gene to the first one,
+     * so its hash is only direction invariant. [STATIC]
+     *
+     * \param chromosome Chromosome to be hashed
+     * \param round_trip If 'false', the chromosome is an open path
+     */
+    quint64 RingIndividual::computeHash (const Chromosome& chromosome,
+					 bool round_trip)
+    {
+      quint64 hash = 0;
+
+      unsigned int size = chromosome.size ();
+      unsigned int number_of_edges = round_trip || size == 0 ? size : size - 1;
+
+      for (unsigned int i=0; i < number_of_edges; ++i)
+	hash += mix (computeEdgeKey (chromosome[i],
+				     chromosome[i + 1 < size ? i + 1 : 0]));
+
+      return hash;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingDiversityMetrics
+    //#***********************************************************************
+
+    /* Constructor */
+    RingDiversityMetrics::RingDiversityMetrics ()
+      : DiversityMetrics (),
+	_size                   (0),
+	_chromosome_size        (0),
+	_edge_count_entropy_sum (0.0),
+	_shared_edge_pairs      (0.0)
+    {
+    }
+
+    /* Destructor */
+    RingDiversityMetrics::~RingDiversityMetrics ()
+    {
+    }
+
+    /* Create new, empty metrics object */
+    DiversityMetrics* RingDiversityMetrics::create () const
+    {
+      return new RingDiversityMetrics ();
+    }
+
+    /* Account for an individual added to the population */
+    void RingDiversityMetrics::add (const Individual* individual)
+    {
+      const RingIndividual* ring =
+        dynamic_cast<const RingIndividual*> (individual);
+      if (ring == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      update (ring, true);
+    }
+
+    /* Account for an individual removed from the population */
+    void RingDiversityMetrics::remove (const Individual* individual)
+    {
+      const RingIndividual* ring =
+        dynamic_cast<const RingIndividual*> (individual);
+      if (ring == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      update (ring, false);
+    }
+
+    /* Reset metrics to an empty population */
+    void RingDiversityMetrics::clear ()
+    {
+      _edge_counts.clear ();
+      _genotype_counts.clear ();
+
+      _size = 0;
+      _chromosome_size = 0;
+      _edge_count_entropy_sum = 0.0;
+      _shared_edge_pairs = 0.0;
+    }
+
+    /* Return the number of individuals accounted for */
+    unsigned int RingDiversityMetrics::size () const
+    {
+      return _size;
+    }
+
+    /*
+     * Return the normalized edge entropy
+     *
+     * The entropy of the edge frequency distribution is scaled to [0, 1],
+     * where 0 means all individuals consist of the same edges and 1 means
+     * no edge is shared between any two individuals.
+     */
+    double RingDiversityMetrics::getEntropy () const
+    {
+      if (_size < 2 || _chromosome_size == 0)
+	return 0.0;
+
+      //
+      // With T edges in total and edge counts c_e, the entropy is
+      // log (T) - sum (c_e * log (c_e)) / T. It ranges from log (L) (all
+      // individuals identical) to log (N * L) (all edges distinct).
+      //
+      double total = static_cast<double> (_size) * _chromosome_size;
+      double entropy = log (total) - _edge_count_entropy_sum / total;
+
+      return std::max (0.0, std::min (1.0, (entropy - log (_chromosome_size))
+				      / log (_size)));
+    }
+
+    /*
+     * Return the average pairwise edge distance
+     *
+     * The edge distance of two individuals is the share of edges of the
+     * first one not present in the second one. The average over all pairs
+     * is computed exactly from the edge counts: every edge contained in c_e
+     * individuals is shared by c_e * (c_e - 1) / 2 pairs.
+     *
+     * \return Average distance in [0, 1]
+     */
+    double RingDiversityMetrics::getAverageDistance () const
+    {
+      if (_size < 2 || _chromosome_size == 0)
+	return 0.0;
+
+      double pairs = 0.5 * _size * (_size - 1.0);
+      double shared = _shared_edge_pairs / pairs;
+
+      return std::max (0.0, 1.0 - shared / _chromosome_size);
+    }
+
+    /* Return the number of distinct genotypes */
+    unsigned int RingDiversityMetrics::getNumberOfGenotypes () const
+    {
+      return _genotype_counts.size ();
+    }
+
+    /*
+     * Update edge and genotype counts for a single individual
+     *
+     * \param ring Individual to account for
+     * \param add  'true' if the individual is added, 'false' if removed
+     */
+    void RingDiversityMetrics::update (const RingIndividual* ring, bool add)
+    {
+      const RingIndividual::Chromosome& chromosome = ring->getChromosome ();
+      unsigned int size = chromosome.size ();
+
+      if (_size == 0 && add)
+	_chromosome_size = size;
+      else if (size != _chromosome_size)
+	throw InternalException ("Chromosomes have different sizes");
+
+      //
+      // Edge counts. The entropy sum and the number of edge sharing pairs
+      // are maintained incrementally with each count change.
+      //
+      for (unsigned int i=0; i < size; ++i)
+	{
+	  quint64 key = computeEdgeKey (chromosome[i],
+					chromosome[i + 1 < size ? i + 1 : 0]);
+
+	  if (add)
+	    {
+	      unsigned int& count = _edge_counts[key];
+
+	      _edge_count_entropy_sum += xlogx (count + 1) - xlogx (count);
+	      _shared_edge_pairs += count;
+	      ++count;
+	    }
+	  else
+	    {
+	      CountMap::iterator pos = _edge_counts.find (key);
+	      if (pos == _edge_counts.end ())
+		throw InternalException ("Removed edge not accounted for");
+
+	      unsigned int count = pos->second;
+
+	      _edge_count_entropy_sum += xlogx (count - 1) - xlogx (count);
+	      _shared_edge_pairs -= count - 1;
+
+	      if (count > 1)
+		pos->second = count - 1;
+	      else
+		_edge_counts.erase (pos);
+	    }
+	}
+
+      //
+      // Genotype counts
+      //
+      quint64 hash = ring->getHash ();
+
+      if (add)
+	{
+	  ++_genotype_counts[hash];
+	  ++_size;
+	}
+      else
+	{
+	  CountMap::iterator pos = _genotype_counts.find (hash);
+	  if (pos == _genotype_counts.end ())
+	    throw InternalException ("Removed genotype not accounted for");
+
+	  if (pos->second > 1)
+	    --pos->second;
+	  else
+	    _genotype_counts.erase (pos);
+
+	  --_size;
+	}
+
+      if (_size == 0)
+	clear ();
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingEdgeSurrogateModel
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param min_samples       Number of training samples before the model
+     *                          is considered usable
+     * \param learning_rate     NLMS step size in (0, 2)
+     * \param number_of_weights Size of the hashed edge weight table
+     */
+    RingEdgeSurrogateModel::RingEdgeSurrogateModel
+    (unsigned int min_samples, double learning_rate,
+     unsigned int number_of_weights)
+      : SurrogateModel (),
+	_min_samples       (min_samples),
+	_learning_rate     (learning_rate),
+	_weights           (number_of_weights, 0.0),
+	_bias              (0.0),
+	_number_of_samples (0)
+    {
+      if (_learning_rate <= 0.0 || _learning_rate >= 2.0)
+	throw InternalException ("Learning rate out of valid range");
+
+      if (number_of_weights == 0)
+	throw InternalException ("Number of weights must not be 0");
+    }
+
+    /* Destructor */
+    RingEdgeSurrogateModel::~RingEdgeSurrogateModel ()
+    {
+    }
+
+    /* Return the weight table index of an undirected edge */
+    inline unsigned int RingEdgeSurrogateModel::getWeightIndex
+    (RingIndividual::Gene gene_1, RingIndividual::Gene gene_2) const
+    {
+      return mix (computeEdgeKey (gene_1, gene_2)) % _weights.size ();
+    }
+
+    /* Check if enough samples have been trained */
+    bool RingEdgeSurrogateModel::isTrained () const
+    {
+      return _number_of_samples >= _min_samples;
+    }
+
+    /* Predict the objective of an individual */
+    double RingEdgeSurrogateModel::predict (const Individual* individual) const
+    {
+      const RingIndividual* ring =
+        dynamic_cast<const RingIndividual*> (individual);
+      if (ring == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      const RingIndividual::Chromosome& chromosome = ring->getChromosome ();
+      unsigned int size = chromosome.size ();
+
+      double prediction = _bias;
+      for (unsigned int i=0; i < size; ++i)
+	prediction += _weights[getWeightIndex
+			       (chromosome[i],
+				chromosome[i + 1 < size ? i + 1 : 0])];
+
+      return prediction;
+    }
+
+    /*
+     * Train the model with an exactly evaluated individual
+     *
+     * Each sample activates the bias and one feature per edge, so the
+     * normalized update distributes the prediction error evenly over them.
+     */
+    void RingEdgeSurrogateModel::train (const Individual* individual,
+					double objective)
+    {
+      const RingIndividual* ring =
+        dynamic_cast<const RingIndividual*> (individual);
+      if (ring == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      const RingIndividual::Chromosome& chromosome = ring->getChromosome ();
+      unsigned int size = chromosome.size ();
+
+      double delta = _learning_rate * (objective - predict (individual)) /
+	(size + 1);
+
+      _bias += delta;
+      for (unsigned int i=0; i < size; ++i)
+	_weights[getWeightIndex (chromosome[i],
+				 chromosome[i + 1 < size ? i + 1 : 0])] += delta;
+
+      ++_number_of_samples;
+    }
+
+    /* Reset the model to its untrained state */
+    void RingEdgeSurrogateModel::clear ()
+    {
+      std::fill (_weights.begin (), _weights.end (), 0.0);
+      _bias = 0.0;
+      _number_of_samples = 0;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingGenomeEncoder
+    //#***********************************************************************
+
+    /* Constructor */
+    RingGenomeEncoder::RingGenomeEncoder ()
+      : GenomeEncoder ()
+    {
+    }
+
+    /* Destructor */
+    RingGenomeEncoder::~RingGenomeEncoder ()
+    {
+    }
+
+    /* Append the binary representation of an individual to a buffer */
+    void RingGenomeEncoder::encode (const Individual* individual,
+				    std::string* buffer) const
+    {
+      const RingIndividual* ring =
+        dynamic_cast<const RingIndividual*> (individual);
+      if (ring == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      const RingIndividual::Chromosome& chromosome = ring->getChromosome ();
+
+      quint32 size = chromosome.size ();
+      buffer->append (reinterpret_cast<const char*> (&size), sizeof (size));
+
+      for (unsigned int i=0; i < chromosome.size (); ++i)
+	{
+	  quint32 gene = chromosome[i];
+	  buffer->append (reinterpret_cast<const char*> (&gene), sizeof (gene));
+	}
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingPartiallyMatchedCrossoverOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RingPartiallyMatchedCrossoverOperator::
+    RingPartiallyMatchedCrossoverOperator ()
+      : CrossoverOperator ("Partially matched crossover")
+    {
+    }
+
+    /* Destructor */
+    RingPartiallyMatchedCrossoverOperator::
+    ~RingPartiallyMatchedCrossoverOperator ()
+    {}
+
+    /* Execute crossover operation */
+    void RingPartiallyMatchedCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      DV ("* Crossover");
+
+      const RingIndividual* ring_1 =
+        dynamic_cast<const RingIndividual*> (individual_1);
+      if (ring_1 == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      const RingIndividual* ring_2 =
+        dynamic_cast<const RingIndividual*> (individual_2);
+      if (ring_2 == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      RingIndividual::Chromosome chromosome_1 = ring_1->getChromosome ();
+      RingIndividual::Chromosome chromosome_2 = ring_2->getChromosome ();
+
+      if (chromosome_1.size () != chromosome_2.size ())
+	throw InternalException ("Chromosomes have different sizes");
+      
+      if (chromosome_1.size () < 3)
+	throw InternalException ("Chromosome size must be at least 3 "
+				 "for this operator");
+      
+      //
+      // Select gene cutting locations
+      //
+      unsigned int size = chromosome_1.size ();
+      unsigned int index_1 = _random.getInt (0, size - 1);
+      unsigned int index_2 = index_1 + _random.getInt (1, size - 2);
+      
+      DV ("  index_1=" << index_1 << ", index_2=" << (index_2 % size));
+      
+      //
+      // Each child keeps the genes of one parent and receives the cut
+      // sequence of the other one
+      //
+      adaptChromosome (index_1, index_2, ring_2->getChromosome (),
+		       chromosome_1);
+      adaptChromosome (index_1, index_2, ring_1->getChromosome (),
+		       chromosome_2);
+      
+      RingIndividual* target_1 =
+	dynamic_cast<RingIndividual*> (ring_1->clone ());
+      target_1->setChromosome (chromosome_1);
+      target_1->recombineMutationRate (ring_2);
+      target->addIndividual (target_1);
+      
+      RingIndividual* target_2 =
+	dynamic_cast<RingIndividual*> (ring_2->clone ());
+      target_2->setChromosome (chromosome_2);
+      target_2->recombineMutationRate (ring_1);
+      target->addIndividual (target_2);
+    }
+
+
+    /*
+     * Insert the cut sequence of another parent into a chromosome
+     *
+     * Genes outside of the cut sequence which are duplicated by the inserted
+     * genes are replaced by following the mapping between the two sequences
+     * until a gene not part of the inserted sequence is found. The mapping
+     * chains are disjoint, so the whole operation is O(L).
+     *
+     * \param index_1    First position of the cut sequence
+     * \param index_2    Last position of the cut sequence, may exceed the
+     *                   chromosome size if the sequence wraps around
+     * \param donor      Chromosome the cut sequence is taken from
+     * \param chromosome Chromosome to be adapted
+     */
+    void RingPartiallyMatchedCrossoverOperator::adaptChromosome
+    (unsigned int index_1, unsigned int index_2,
+     const RingIndividual::Chromosome& donor,
+     RingIndividual::Chromosome& chromosome) const
+    {
+      typedef RingIndividual::Gene Gene;
+
+      unsigned int size = chromosome.size ();
+      unsigned int length = index_2 - index_1 + 1;
+
+      CircularSpan<const Gene> cut = makeCircularSpan (donor, index_1, length);
+      CircularSpan<Gene> outside =
+	makeCircularSpan (chromosome, index_2 + 1, size - length);
+
+      //
+      // Step 1: Index the inserted genes by their position
+      //
+      GeneIndex* inserted = GeneIndex::getInstance (donor);
+      inserted->insert (cut, &donor[0]);
+
+      //
+      // Step 2: Resolve the duplicates outside of the cut sequence. The cut
+      //         sequence still holds the original genes here.
+      //
+      for (unsigned int i=0; i < outside.size (); ++i)
+	{
+	  Gene gene = outside[i];
+
+	  while (inserted->contains (gene))
+	    gene = chromosome[inserted->getPosition (gene)];
+
+	  outside[i] = gene;
+	}
+
+      //
+      // Step 3: Insert the cut sequence
+      //
+      cut.copyTo (makeCircularSpan (chromosome, index_1, length));
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingResortingCrossoverOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RingResortingCrossoverOperator::RingResortingCrossoverOperator ()
+      : CrossoverOperator ("Resorting crossover")
+    {
+    }
+
+    /* Destructor */
+    RingResortingCrossoverOperator::~RingResortingCrossoverOperator ()
+    {}
+
+    /* Execute crossover operation */
+    void RingResortingCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      DV ("* Crossover");
+
+      const RingIndividual* ring_1 =
+        dynamic_cast<const RingIndividual*> (individual_1);
+      if (ring_1 == 0)
+        throw InternalException ("Individual is not a ring object");
+
+      const RingIndividual* ring_2 =
+        dynamic_cast<const RingIndividual*> (individual_2);
+      if (ring_2 == 0)
+        throw InternalException ("Individual is not a ring object");
+      
+      RingIndividual::Chromosome chromosome_1 = ring_1->getChromosome ();
+      RingIndividual::Chromosome chromosome_2 = ring_2->getChromosome ();
+
+      if (chromosome_1.size () != chromosome_2.size ())
+	throw InternalException ("Chromosomes have different sizes");
+
+      if (chromosome_1.size () < 3)
+	throw InternalException ("Chromosome size must be at least 3 "
+				 "for this operator");
+
+      //
+      // Select gene cutting locations
+      //
+      unsigned int size = chromosome_1.size ();
+      unsigned int index_1 = _random.getInt (0, size - 1);
+      unsigned int index_2 = index_1 + _random.getInt (1, size - 2);
+
+      DV ("  index_1=" << index_1 << ", index_2=" << (index_2 % size));
+
+      //
+      // Insert the cut sequence of each parent into the other one
+      //
+      insertSequence (ring_1->getChromosome (), index_1, index_2,
+		      chromosome_2);
+      insertSequence (ring_2->getChromosome (), index_1, index_2,
+		      chromosome_1);
+
+      RingIndividual* target_1 =
+	dynamic_cast<RingIndividual*> (ring_1->clone ());
+      target_1->setChromosome (chromosome_1);
+      target_1->recombineMutationRate (ring_2);
+      target->addIndividual (target_1);
+
+      RingIndividual* target_2 =
+	dynamic_cast<RingIndividual*> (ring_2->clone ());
+      target_2->setChromosome (chromosome_2);
+      target_2->recombineMutationRate (ring_1);
+      target->addIndividual (target_2);
+    }
+
+
+    /*
+     * Insert the cut sequence of another parent into a chromosome
+     *
+     * The genes of the sequence are removed from the chromosome and the
+     * sequence is inserted as a whole where its first gene has been. The
+     * chromosome is compacted in place and then opened up for the sequence,
+     * so this is O(L) without any temporary chromosome.
+     *
+     * \param donor      Chromosome the sequence is taken from
+     * \param index_1    First position of the sequence
+     * \param index_2    Last position of the sequence, may exceed the
+     *                   chromosome size if the sequence wraps around
+     * \param chromosome Chromosome to be adapted
+     */
+    void RingResortingCrossoverOperator::insertSequence
+    (const RingIndividual::Chromosome& donor,
+     unsigned int index_1, unsigned int index_2,
+     RingIndividual::Chromosome& chromosome) const
+    {
+      typedef RingIndividual::Gene Gene;
+
+      unsigned int size = chromosome.size ();
+      unsigned int length = index_2 - index_1 + 1;
+
+      if (length == 0 || length > size)
+        throw InternalException ("Invalid sequence length");
+
+      //
+      // Step 1: Remove all genes from the chromosome which are present in
+      //         the sequence to insert, too. The original position of the
+      //         sequence starting gene is the insertion point.
+      //
+      CircularSpan<const Gene> sequence =
+	makeCircularSpan (donor, index_1, length);
+
+      GeneIndex* inserted_genes = GeneIndex::getInstance (donor);
+      inserted_genes->insert (sequence, &donor[0]);
+
+      Gene first_gene = sequence[0];
+      unsigned int index = 0;
+      unsigned int kept = 0;
+
+      for (unsigned int i=0; i < size; ++i)
+	{
+	  Gene gene = chromosome[i];
+
+	  if (!inserted_genes->contains (gene))
+	    chromosome[kept++] = gene;
+	  else if (gene == first_gene)
+	    index = kept;
+	}
+
+      if (kept + length != size)
+	throw InternalException ("Chromosomes contain different genes");
+
+      //
+      // Step 2: Move the genes behind the insertion point to the end and
+      //         copy the sequence into the gap
+      //
+      std::copy_backward (chromosome.begin () + index,
+			  chromosome.begin () + kept, chromosome.end ());
+
+      sequence.copyTo (&chromosome[index]);
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingOrderCrossoverOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RingOrderCrossoverOperator::RingOrderCrossoverOperator ()
+      : CrossoverOperator ("Order crossover")
+    {
+    }
+
+    /* Destructor */
+    RingOrderCrossoverOperator::~RingOrderCrossoverOperator ()
+    {}
+
+    /* Execute crossover operation */
+    void RingOrderCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      DV ("* Crossover");
+
+      const RingIndividual* ring_1 = toRing (individual_1);
+      const RingIndividual* ring_2 = toRing (individual_2);
+
+      const RingIndividual::Chromosome& parent_1 = ring_1->getChromosome ();
+      const RingIndividual::Chromosome& parent_2 = ring_2->getChromosome ();
+
+      checkParents (parent_1, parent_2);
+
+      unsigned int size = parent_1.size ();
+      unsigned int index_1 = _random.getInt (0, size - 1);
+      unsigned int index_2 = index_1 + _random.getInt (1, size - 2);
+
+      DV ("  index_1=" << index_1 << ", index_2=" << (index_2 % size));
+
+      RingIndividual::Chromosome chromosome (size);
+
+      fillChromosome (parent_1, parent_2, index_1, index_2, chromosome);
+      addChild (ring_1, ring_2, chromosome, target);
+
+      fillChromosome (parent_2, parent_1, index_1, index_2, chromosome);
+      addChild (ring_2, ring_1, chromosome, target);
+    }
+
+    /*
+     * Compute one child
+     *
+     * The child keeps the sequence [index_1, index_2] of the first parent.
+     * The remaining positions are filled behind the sequence with the
+     * missing genes in the order they appear in the second parent, starting
+     * behind the sequence, too.
+     *
+     * \param parent_1   Parent providing the sequence
+     * \param parent_2   Parent providing the order of the other genes
+     * \param index_1    First position of the sequence
+     * \param index_2    Last position of the sequence, may exceed the
+     *                   chromosome size if the sequence wraps around
+     * \param chromosome Resulting chromosome, already sized
+     */
+    void RingOrderCrossoverOperator::fillChromosome
+    (const RingIndividual::Chromosome& parent_1,
+     const RingIndividual::Chromosome& parent_2,
+     unsigned int index_1, unsigned int index_2,
+     RingIndividual::Chromosome& chromosome) const
+    {
+      typedef RingIndividual::Gene Gene;
+
+      unsigned int size = chromosome.size ();
+      unsigned int length = index_2 - index_1 + 1;
+
+      CircularSpan<const Gene> sequence =
+	makeCircularSpan (parent_1, index_1, length);
+      sequence.copyTo (makeCircularSpan (chromosome, index_1, length));
+
+      GeneIndex* kept = GeneIndex::getInstance (parent_1);
+      kept->insert (sequence, &parent_1[0]);
+
+      CircularSpan<const Gene> order =
+	makeCircularSpan (parent_2, index_2 + 1, size);
+      CircularSpan<Gene> rest =
+	makeCircularSpan (chromosome, index_2 + 1, size - length);
+
+      unsigned int next = 0;
+
+      for (unsigned int i=0; i < order.size (); ++i)
+	{
+	  Gene gene = order[i];
+
+	  if (!kept->contains (gene))
+	    {
+	      if (next == rest.size ())
+		throw InternalException ("Chromosomes contain different genes");
+
+	      rest[next++] = gene;
+	    }
+	}
+
+      if (next != rest.size ())
+	throw InternalException ("Chromosomes contain different genes");
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingOrderBasedCrossoverOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param selection_probability Probability of a position to be part of
+     *                              the reordered gene set
+     */
+    RingOrderBasedCrossoverOperator::RingOrderBasedCrossoverOperator
+    (double selection_probability)
+      : CrossoverOperator ("Order based crossover"),
+	_selection_probability (selection_probability)
+    {
+      if (_selection_probability <= 0.0 || _selection_probability > 1.0)
+	throw InternalException ("Selection probability out of valid range");
+    }
+
+    /* Destructor */
+    RingOrderBasedCrossoverOperator::~RingOrderBasedCrossoverOperator ()
+    {}
+
+    /* Execute crossover operation */
+    void RingOrderBasedCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      DV ("* Crossover");
+
+      const RingIndividual* ring_1 = toRing (individual_1);
+      const RingIndividual* ring_2 = toRing (individual_2);
+
+      const RingIndividual::Chromosome& parent_1 = ring_1->getChromosome ();
+      const RingIndividual::Chromosome& parent_2 = ring_2->getChromosome ();
+
+      checkParents (parent_1, parent_2);
+
+      unsigned int size = parent_1.size ();
+
+      std::vector<unsigned int> positions;
+      for (unsigned int i=0; i < size; ++i)
+	if (_random.getDouble (0.0, 1.0) < _selection_probability)
+	  positions.push_back (i);
+
+      RingIndividual::Chromosome chromosome (size);
+
+      reorderChromosome (parent_1, parent_2, positions, chromosome);
+      addChild (ring_1, ring_2, chromosome, target);
+
+      reorderChromosome (parent_2, parent_1, positions, chromosome);
+      addChild (ring_2, ring_1, chromosome, target);
+    }
+
+    /*
+     * Compute one child
+     *
+     * The genes found at the selected positions in the second parent are
+     * rearranged in the first parent to follow their order in the second
+     * one. All other genes keep their positions.
+     *
+     * \param parent_1   Parent providing the gene positions
+     * \param parent_2   Parent providing the order of the selected genes
+     * \param positions  Selected positions in ascending order
+     * \param chromosome Resulting chromosome, already sized
+     */
+    void RingOrderBasedCrossoverOperator::reorderChromosome
+    (const RingIndividual::Chromosome& parent_1,
+     const RingIndividual::Chromosome& parent_2,
+     const std::vector<unsigned int>& positions,
+     RingIndividual::Chromosome& chromosome) const
+    {
+      GeneIndex* selected = GeneIndex::getInstance (parent_2);
+
+      for (unsigned int i=0; i < positions.size (); ++i)
+	selected->insert (parent_2[positions[i]], i);
+
+      unsigned int next = 0;
+
+      for (unsigned int i=0; i < parent_1.size (); ++i)
+	{
+	  RingIndividual::Gene gene = parent_1[i];
+
+	  if (selected->contains (gene))
+	    {
+	      if (next == positions.size ())
+		throw InternalException ("Chromosomes contain different genes");
+
+	      chromosome[i] = parent_2[positions[next++]];
+	    }
+	  else
+	    chromosome[i] = gene;
+	}
+
+      if (next != positions.size ())
+	throw InternalException ("Chromosomes contain different genes");
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingCycleCrossoverOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RingCycleCrossoverOperator::RingCycleCrossoverOperator ()
+      : CrossoverOperator ("Cycle crossover")
+    {
+    }
+
+    /* Destructor */
+    RingCycleCrossoverOperator::~RingCycleCrossoverOperator ()
+    {}
+
+    /*
+     * Execute crossover operation
+     *
+     * The positions are partitioned into cycles: following a position to the
+     * position of the second parent's gene in the first parent leads back to
+     * the start eventually. The children take the genes of the cycles
+     * alternately from the first and the second parent, so every gene stays
+     * at a position it had in one of the parents.
+     */
+    void RingCycleCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      DV ("* Crossover");
+
+      const RingIndividual* ring_1 = toRing (individual_1);
+      const RingIndividual* ring_2 = toRing (individual_2);
+
+      const RingIndividual::Chromosome& parent_1 = ring_1->getChromosome ();
+      const RingIndividual::Chromosome& parent_2 = ring_2->getChromosome ();
+
+      checkParents (parent_1, parent_2);
+
+      unsigned int size = parent_1.size ();
+
+      RingIndividual::Chromosome chromosome_1 (parent_1);
+      RingIndividual::Chromosome chromosome_2 (parent_2);
+
+      //
+      // The positions of the genes in the first parent. Genes are removed
+      // from the index as soon as their cycle has been processed.
+      //
+      GeneIndex* unvisited = GeneIndex::getInstance (parent_1);
+      for (unsigned int i=0; i < size; ++i)
+	unvisited->insert (parent_1[i], i);
+
+      bool swapped = false;
+
+      for (unsigned int start=0; start < size; ++start)
+	{
+	  if (!unvisited->contains (parent_1[start]))
+	    continue;
+
+	  unsigned int position = start;
+
+	  do
+	    {
+	      unvisited->remove (parent_1[position]);
+
+	      if (swapped)
+		{
+		  chromosome_1[position] = parent_2[position];
+		  chromosome_2[position] = parent_1[position];
+		}
+
+	      RingIndividual::Gene gene = parent_2[position];
+	      if (!unvisited->contains (gene) && gene != parent_1[start])
+		throw InternalException ("Chromosomes contain different genes");
+
+	      position = unvisited->getPosition (gene);
+	    }
+	  while (position != start);
+
+	  swapped = !swapped;
+	}
+
+      addChild (ring_1, ring_2, chromosome_1, target);
+      addChild (ring_2, ring_1, chromosome_2, target);
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingEdgeRecombinationCrossoverOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RingEdgeRecombinationCrossoverOperator::
+    RingEdgeRecombinationCrossoverOperator ()
+      : CrossoverOperator ("Edge recombination crossover")
+    {
+    }
+
+    /* Destructor */
+    RingEdgeRecombinationCrossoverOperator::
+    ~RingEdgeRecombinationCrossoverOperator ()
+    {}
+
+    /* Execute crossover operation */
+    void RingEdgeRecombinationCrossoverOperator::crossover
+    (const Individual* individual_1,
+     const Individual* individual_2,
+     Population* target) const
+    {
+      DV ("* Crossover");
+
+      const RingIndividual* ring_1 = toRing (individual_1);
+      const RingIndividual* ring_2 = toRing (individual_2);
+
+      const RingIndividual::Chromosome& parent_1 = ring_1->getChromosome ();
+      const RingIndividual::Chromosome& parent_2 = ring_2->getChromosome ();
+
+      checkParents (parent_1, parent_2);
+
+      RingIndividual::Chromosome chromosome (parent_1.size ());
+
+      buildChromosome (parent_1, parent_2, parent_1[0], chromosome);
+      addChild (ring_1, ring_2, chromosome, target);
+
+      buildChromosome (parent_1, parent_2, parent_2[0], chromosome);
+      addChild (ring_2, ring_1, chromosome, target);
+    }
+
+    /*
+     * Compute one child
+     *
+     * The edge table of the parents is built in the scratch arrays of the
+     * calling thread. Starting with the given gene, the child always
+     * continues with the unvisited neighbour having the fewest unvisited
+     * neighbours itself, breaking ties randomly. Only if there is no such
+     * neighbour, a random unvisited gene is taken, which is O(1) with the
+     * swap removed list of unvisited genes.
+     *
+     * \param parent_1   First parent
+     * \param parent_2   Second parent
+     * \param start      Start gene
+     * \param chromosome Resulting chromosome, already sized
+     */
+    void RingEdgeRecombinationCrossoverOperator::buildChromosome
+    (const RingIndividual::Chromosome& parent_1,
+     const RingIndividual::Chromosome& parent_2,
+     RingIndividual::Gene start,
+     RingIndividual::Chromosome& chromosome) const
+    {
+      typedef RingIndividual::Gene Gene;
+
+      unsigned int size = parent_1.size ();
+
+      //
+      // Step 1: Build the edge table and the list of unvisited genes
+      //
+      EdgeTable* table = EdgeTable::getInstance ();
+      table->prepare (parent_1, parent_2);
+
+      std::vector<Gene>& neighbours = table->neighbours;
+      std::vector<unsigned char>& number_of_neighbours =
+	table->number_of_neighbours;
+      std::vector<Gene>& unvisited = table->unvisited;
+      std::vector<unsigned int>& unvisited_positions =
+	table->unvisited_positions;
+
+      const RingIndividual::Chromosome* parents[] = { &parent_1, &parent_2 };
+
+      for (unsigned int p=0; p < 2; ++p)
+	{
+	  const RingIndividual::Chromosome& parent = *parents[p];
+
+	  for (unsigned int i=0; i < size; ++i)
+	    {
+	      Gene gene = parent[i];
+	      Gene adjacent[] = { parent[(i + size - 1) % size],
+				  parent[(i + 1) % size] };
+
+	      for (unsigned int j=0; j < 2; ++j)
+		{
+		  Gene* begin = &neighbours[4 * gene];
+		  Gene* end = begin + number_of_neighbours[gene];
+
+		  if (std::find (begin, end, adjacent[j]) == end)
+		    {
+		      *end = adjacent[j];
+		      ++number_of_neighbours[gene];
+		    }
+		}
+	    }
+	}
+
+      //
+      // Step 2: Walk along the edges
+      //
+      Gene gene = start;
+
+      for (unsigned int i=0; i < size; ++i)
+	{
+	  chromosome[i] = gene;
+
+	  //
+	  // Remove the gene from the unvisited list and from the edge table
+	  //
+	  unsigned int position = unvisited_positions[gene];
+	  if (position >= unvisited.size () || unvisited[position] != gene)
+	    throw InternalException ("Chromosomes contain different genes");
+
+	  unvisited[position] = unvisited.back ();
+	  unvisited_positions[unvisited[position]] = position;
+	  unvisited.pop_back ();
+
+	  const Gene* candidates = &neighbours[4 * gene];
+	  unsigned int number_of_candidates = number_of_neighbours[gene];
+
+	  for (unsigned int j=0; j < number_of_candidates; ++j)
+	    {
+	      Gene* begin = &neighbours[4 * candidates[j]];
+	      Gene* end = begin + number_of_neighbours[candidates[j]];
+	      Gene* pos = std::find (begin, end, gene);
+
+	      if (pos != end)
+		{
+		  *pos = *(end - 1);
+		  --number_of_neighbours[candidates[j]];
+		}
+	    }
+
+	  if (unvisited.empty ())
+	    break;
+
+	  //
+	  // Select the next gene
+	  //
+	  unsigned int best = 5;
+	  unsigned int number_of_best = 0;
+
+	  for (unsigned int j=0; j < number_of_candidates; ++j)
+	    {
+	      unsigned int count = number_of_neighbours[candidates[j]];
+
+	      if (count < best)
+		{
+		  best = count;
+		  number_of_best = 1;
+		  gene = candidates[j];
+		}
+	      else if (count == best &&
+		       _random.getInt (0, number_of_best++) == 0)
+		gene = candidates[j];
+	    }
+
+	  if (number_of_best == 0)
+	    gene = unvisited[_random.getInt (0, unvisited.size () - 1)];
+	}
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingInversionMutationOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param mutation_probability Probability of an individual to be mutated
+     * \param max_length           Maximum length of the reversed sequence or
+     *                             0 for no limit
+     */
+    RingInversionMutationOperator::RingInversionMutationOperator
+    (double mutation_probability, unsigned int max_length)
+      : MutationOperator ("Inversion mutation"),
+	_mutation_probability (mutation_probability),
+	_max_length           (max_length)
+    {
+      if (_mutation_probability < 0.0 || _mutation_probability > 1.0)
+        throw InternalException ("Mutation probability out of valid range");
+
+      if (_max_length == 1)
+	throw InternalException ("Maximum length must be at least 2");
+    }
+
+    /* Destructor */
+    RingInversionMutationOperator::~RingInversionMutationOperator ()
+    {}
+
+    /* Mutate ring based individual */
+    Individual* RingInversionMutationOperator::mutate
+    (const Individual* source) const
+    {
+      const RingIndividual* ring = toRing (source);
+      unsigned int size = ring->getChromosome ().size ();
+
+      if (size < 4)
+        throw InternalException ("Individual size must be at least 4 for "
+                                 "this operator");
+
+      if (_random.getDouble (0.0, 1.0) >= _mutation_probability)
+	return ring->clone ();
+
+      //
+      // Reversing the complement yields the same ring, so lengths beyond
+      // half the size are not needed
+      //
+      unsigned int max_length = size / 2;
+      if (_max_length > 0)
+	max_length = std::min (max_length, _max_length);
+
+      RingIndividual* target = dynamic_cast<RingIndividual*> (ring->clone ());
+      target->invert (_random.getInt (0, size - 1),
+		      _random.getInt (2, max_length));
+
+      return target;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingDisplacementMutationOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param mutation_probability Probability of an individual to be mutated
+     * \param max_length           Maximum length of the moved sequence
+     * \param max_distance         Maximum distance the sequence is moved or 0
+     *                             for no limit
+     */
+    RingDisplacementMutationOperator::RingDisplacementMutationOperator
+    (double mutation_probability, unsigned int max_length,
+     unsigned int max_distance)
+      : MutationOperator ("Displacement mutation"),
+	_mutation_probability (mutation_probability),
+	_max_length           (max_length),
+	_max_distance         (max_distance)
+    {
+      if (_mutation_probability < 0.0 || _mutation_probability > 1.0)
+        throw InternalException ("Mutation probability out of valid range");
+
+      if (_max_length == 0)
+	throw InternalException ("Maximum length must not be 0");
+    }
+
+    /* Destructor */
+    RingDisplacementMutationOperator::~RingDisplacementMutationOperator ()
+    {}
+
+    /*
+     * Mutate ring based individual
+     *
+     * Moving a sequence forward by d positions yields the same ring as
+     * moving the genes behind its new position forward by the sequence
+     * length, which changes size - d instead of length + d positions. The
+     * cheaper variant is executed.
+     */
+    Individual* RingDisplacementMutationOperator::mutate
+    (const Individual* source) const
+    {
+      const RingIndividual* ring = toRing (source);
+      unsigned int size = ring->getChromosome ().size ();
+
+      if (size < 4)
+        throw InternalException ("Individual size must be at least 4 for "
+                                 "this operator");
+
+      if (_random.getDouble (0.0, 1.0) >= _mutation_probability)
+	return ring->clone ();
+
+      unsigned int length =
+	_random.getInt (1, std::min (_max_length, size - 3));
+
+      unsigned int max_distance = size - length - 1;
+      if (_max_distance > 0)
+	max_distance = std::min (max_distance, _max_distance);
+
+      unsigned int position = _random.getInt (0, size - 1);
+      unsigned int distance = _random.getInt (1, max_distance);
+
+      RingIndividual* target = dynamic_cast<RingIndividual*> (ring->clone ());
+
+      if (length + distance <= size - distance)
+	target->displace (position, length, distance);
+      else
+	target->displace ((position + length + distance) % size,
+			  size - length - distance, length);
+
+      return target;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingScrambleMutationOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param mutation_probability Probability of an individual to be mutated
+     * \param max_length           Maximum length of the scrambled sequence
+     */
+    RingScrambleMutationOperator::RingScrambleMutationOperator
+    (double mutation_probability, unsigned int max_length)
+      : MutationOperator ("Scramble mutation"),
+	_mutation_probability (mutation_probability),
+	_max_length           (max_length)
+    {
+      if (_mutation_probability < 0.0 || _mutation_probability > 1.0)
+        throw InternalException ("Mutation probability out of valid range");
+
+      if (_max_length < 2)
+	throw InternalException ("Maximum length must be at least 2");
+    }
+
+    /* Destructor */
+    RingScrambleMutationOperator::~RingScrambleMutationOperator ()
+    {}
+
+    /* Mutate ring based individual */
+    Individual* RingScrambleMutationOperator::mutate
+    (const Individual* source) const
+    {
+      const RingIndividual* ring = toRing (source);
+      unsigned int size = ring->getChromosome ().size ();
+
+      if (size < 3)
+        throw InternalException ("Individual size must be at least 3 for "
+                                 "this operator");
+
+      if (_random.getDouble (0.0, 1.0) >= _mutation_probability)
+	return ring->clone ();
+
+      RingIndividual* target = dynamic_cast<RingIndividual*> (ring->clone ());
+      target->scramble (_random.getInt (0, size - 1),
+			_random.getInt (2, std::min (_max_length, size - 1)),
+			_random);
+
+      return target;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingUniformMutationOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RingUniformMutationOperator::RingUniformMutationOperator
     (double mutation_probability)
         : MutationOperator ("Uniform mutation"),
         _mutation_probability (mutation_probability)
@@ -352,6 +1879,16 @@ namespace GEP
         throw InternalException ("Mutation probability out of valid range");
     }
 
+    /* Constructor for derived operators */
+    RingUniformMutationOperator::RingUniformMutationOperator
+    (const QString& description, double mutation_probability)
+      : MutationOperator (description),
+	_mutation_probability (mutation_probability)
+    {
+      if (_mutation_probability < 0.0 || _mutation_probability > 1.0)
+	throw InternalException ("Mutation probability out of valid range");
+    }
+
     /* Destructor */
     RingUniformMutationOperator::~RingUniformMutationOperator ()
     {}
@@ -381,32 +1918,642 @@ namespace GEP
         throw InternalException ("Individual size must be at least 2 for "
                                  "this operator");
 
-      //
-      // All genes get the chance for mutation...
-      //
-      unsigned int size = chromosome.size ();
-      for (unsigned int index_1=0; index_1 < size; ++index_1)
-      {
-        //
-        // ...with the given mutation probability (usually pm = 1 / size)
-        //
-	if (_random.getDouble (0.0, 1.0) < _mutation_probability)
-        {
-          unsigned int index_2 = _random.getInt (0, size - 1);
-
-          while (index_1 == index_2)
-	    index_2 = _random.getInt (0, size - 1);
-
-          swap (&chromosome[index_1], &chromosome[index_2]);
-        }
-      }
+      mutateUniform (_random, chromosome, _mutation_probability);
+
+      RingIndividual* target =
+	dynamic_cast<RingIndividual*> (ring->clone ());
+      target->setChromosome (chromosome);
+      return target;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingSuccessRuleMutationOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param mutation_probability Initial per gene mutation probability
+     * \param min_probability      Lower bound for the adapted probability
+     * \param max_probability      Upper bound for the adapted probability
+     * \param adaptation_factor    Factor in (0, 1) the probability is
+     *                             multiplied or divided by per update
+     */
+    RingSuccessRuleMutationOperator::RingSuccessRuleMutationOperator
+    (double mutation_probability, double min_probability,
+     double max_probability, double adaptation_factor)
+      : RingUniformMutationOperator ("Success rule mutation",
+				     mutation_probability),
+	_min_probability   (min_probability),
+	_max_probability   (max_probability),
+	_adaptation_factor (adaptation_factor)
+    {
+      if (_min_probability < 0.0 || _max_probability > 1.0 ||
+	  _min_probability > _max_probability)
+	throw InternalException ("Mutation probability bounds invalid");
+
+      if (_adaptation_factor <= 0.0 || _adaptation_factor >= 1.0)
+	throw InternalException ("Adaptation factor out of valid range");
+    }
+
+    /* Destructor */
+    RingSuccessRuleMutationOperator::~RingSuccessRuleMutationOperator ()
+    {
+    }
+
+    /*
+     * Mutate ring based individual
+     *
+     * Changed offspring are marked with this operator, so update () can
+     * tell them from unchanged copies and from offspring of other
+     * operators.
+     */
+    Individual* RingSuccessRuleMutationOperator::mutate
+    (const Individual* source) const
+    {
+      Individual* target = RingUniformMutationOperator::mutate (source);
+
+      if (dynamic_cast<const RingIndividual*> (target)->getChromosome () !=
+	  dynamic_cast<const RingIndividual*> (source)->getChromosome ())
+	target->setMutationOperator (this);
+
+      return target;
+    }
+
+    /*
+     * Adapt the mutation probability via the 1/5th success rule
+     *
+     * Every evaluated offspring of this operator counts as trial, offspring
+     * better than their parent as success. If more than a fifth of the
+     * trials of the step succeeded, the search is too local and the
+     * mutation probability is increased, otherwise it is decreased.
+     */
+    void RingSuccessRuleMutationOperator::update
+    (const std::vector<const Population*>& populations)
+    {
+      unsigned int trials = 0;
+      unsigned int successes = 0;
+
+      for (unsigned int i=0; i < populations.size (); ++i)
+	for ( Population::IndividualConstIterator j =
+		populations[i]->getIndividualBegin ();
+	      j != populations[i]->getIndividualEnd (); ++j )
+	  {
+	    const Individual* individual = *j;
+
+	    if (individual->getMutationOperator () == this &&
+		individual->hasObjective () &&
+		individual->hasParentObjective ())
+	      {
+		++trials;
+		if (individual->getObjective () <
+		    individual->getParentObjective ())
+		  ++successes;
+	      }
+	  }
+
+      if (trials == 0)
+	return;
+
+      double success_rate = static_cast<double> (successes) / trials;
+      double probability = getMutationProbability ();
+
+      if (success_rate > 0.2)
+	probability /= _adaptation_factor;
+      else if (success_rate < 0.2)
+	probability *= _adaptation_factor;
+
+      probability = std::max (probability, _min_probability);
+      probability = std::min (probability, _max_probability);
+
+      DV ("* Success rule, rate=" << success_rate <<
+	  ", probability=" << probability);
+
+      setMutationProbability (probability);
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingSelfAdaptiveMutationOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param initial_rate  Mutation rate of individuals without own rate
+     * \param min_rate      Lower bound for the individual mutation rates
+     * \param max_rate      Upper bound for the individual mutation rates
+     * \param learning_rate Standard deviation of the log-normal perturbation
+     */
+    RingSelfAdaptiveMutationOperator::RingSelfAdaptiveMutationOperator
+    (double initial_rate, double min_rate, double max_rate,
+     double learning_rate)
+      : MutationOperator ("Self adaptive mutation"),
+	_initial_rate  (initial_rate),
+	_min_rate      (min_rate),
+	_max_rate      (max_rate),
+	_learning_rate (learning_rate)
+    {
+      if (_min_rate < 0.0 || _max_rate > 1.0 || _min_rate > _max_rate)
+	throw InternalException ("Mutation rate bounds invalid");
+
+      if (_initial_rate < _min_rate || _initial_rate > _max_rate)
+	throw InternalException ("Initial mutation rate out of bounds");
+
+      if (_learning_rate < 0.0)
+	throw InternalException ("Learning rate must not be negative");
+    }
+
+    /* Destructor */
+    RingSelfAdaptiveMutationOperator::~RingSelfAdaptiveMutationOperator ()
+    {}
+
+    /*
+     * Mutate ring based individual
+     *
+     * The mutation rate of the individual is perturbed log-normally first
+     * and then used for a uniform mutation. The mutated individual inherits
+     * the new rate, so selection favours well performing rates.
+     */
+    Individual* RingSelfAdaptiveMutationOperator::mutate
+    (const Individual* source) const
+    {
+      const RingIndividual* ring =
+	dynamic_cast<const RingIndividual*> (source);
+      if (ring == 0)
+	throw InternalException ("Individual is not a ring object");
+
+      RingIndividual::Chromosome chromosome = ring->getChromosome ();
+
+      if (chromosome.size () < 2)
+	throw InternalException ("Individual size must be at least 2 for "
+				 "this operator");
+
+      double rate = ring->getMutationRate ();
+      if (rate < 0.0)
+	rate = _initial_rate;
+
+      rate *= exp (_learning_rate * _random.getGaussian (0.0, 1.0));
+      rate = std::max (rate, _min_rate);
+      rate = std::min (rate, _max_rate);
+
+      mutateUniform (_random, chromosome, rate);
 
       RingIndividual* target =
-        dynamic_cast<RingIndividual*> (ring->clone ());
+	dynamic_cast<RingIndividual*> (ring->clone ());
       target->setChromosome (chromosome);
+      target->setMutationRate (rate);
+      return target;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::RingLocalSearchMutationOperator
+    //#***********************************************************************
+
+    //
+    // Minimum cost improvement of an applied move
+    //
+    static const double MIN_GAIN = 1e-9;
+
+    //
+    // Maximum length of a sequence moved by an or-opt move
+    //
+    static const unsigned int MAX_OR_OPT_LENGTH = 3;
+
+    /*
+     * 2-opt and or-opt local search on a tour of genes
+     *
+     * The tour is kept as gene array plus the position of each gene, so a
+     * move is applied by reversing tour sections. An open path is closed by
+     * a dummy gene with zero cost edges. Sections containing the dummy are
+     * never reversed, so it stays at the tour end and the path keeps its
+     * direction.
+     */
+    class LocalSearch
+    {
+    public:
+      LocalSearch (const Neighbourhood* neighbourhood,
+		   const RingIndividual::Chromosome& chromosome,
+		   bool round_trip);
+
+      unsigned int optimize (unsigned int max_moves);
+      void getChromosome (RingIndividual::Chromosome* chromosome) const;
+
+    private:
+      inline unsigned int getNext (unsigned int gene) const
+      {
+	unsigned int position = _positions[gene] + 1;
+	return _tour[position == _tour.size () ? 0 : position];
+      }
+
+      inline unsigned int getPrevious (unsigned int gene) const
+      {
+	unsigned int position = _positions[gene];
+	return _tour[position == 0 ? _tour.size () - 1 : position - 1];
+      }
+
+      inline double getCost (unsigned int gene_1, unsigned int gene_2) const
+      {
+	if (gene_1 == _dummy || gene_2 == _dummy)
+	  return 0.0;
+
+	return _neighbourhood->getCost (gene_1, gene_2);
+      }
+
+      inline bool isInSequence (unsigned int gene, unsigned int first,
+				unsigned int length) const
+      {
+	unsigned int size = _tour.size ();
+	return (_positions[gene] + size - _positions[first]) % size < length;
+      }
+
+      bool improveTwoOpt (unsigned int gene);
+      bool improveOrOpt (unsigned int gene);
+
+      void connect (unsigned int gene_1, unsigned int gene_2,
+		    unsigned int gene_3, unsigned int gene_4);
+      void reverse (unsigned int first, unsigned int last);
+      void activate (unsigned int gene);
+
+    private:
+      const Neighbourhood* _neighbourhood;
+      bool _round_trip;
+      unsigned int _dummy;
+
+      std::vector<unsigned int> _tour;
+      std::vector<unsigned int> _positions;
+      std::vector<bool> _active;
+      std::deque<unsigned int> _queue;
+    };
+
+    /*
+     * Constructor
+     *
+     * \param neighbourhood Candidate neighbours and edge costs of the genes
+     * \param chromosome    Start tour
+     * \param round_trip    If 'false', the chromosome is an open path and
+     *                      the edge from the last to the first gene is free
+     */
+    LocalSearch::LocalSearch (const Neighbourhood* neighbourhood,
+			      const RingIndividual::Chromosome& chromosome,
+			      bool round_trip)
+      : _neighbourhood (neighbourhood),
+	_round_trip    (round_trip),
+	_dummy         (neighbourhood->getNumberOfGenes ()),
+	_tour          (chromosome),
+	_positions     (_dummy + 1),
+	_active        (_dummy + 1, true)
+    {
+      if (chromosome.size () != _dummy)
+	throw InternalException ("Neighbourhood does not match chromosome");
+
+      if (!_round_trip)
+	_tour.push_back (_dummy);
+
+      for (unsigned int i=0; i < _tour.size (); ++i)
+	{
+	  if (_tour[i] > _dummy)
+	    throw InternalException ("Gene exceeds neighbourhood");
+
+	  _positions[_tour[i]] = i;
+	}
+
+      _queue.insert (_queue.end (), chromosome.begin (), chromosome.end ());
+      _active[_dummy] = false;
+    }
+
+    /*
+     * Apply improving moves
+     *
+     * \param max_moves Maximum number of applied moves
+     * \return Number of applied moves
+     */
+    unsigned int LocalSearch::optimize (unsigned int max_moves)
+    {
+      //
+      // Or-opt needs the moved sequence and four other genes
+      //
+      if (_tour.size () < MAX_OR_OPT_LENGTH + 5)
+	return 0;
+
+      unsigned int moves = 0;
+
+      while (!_queue.empty () && moves < max_moves)
+	{
+	  unsigned int gene = _queue.front ();
+	  _queue.pop_front ();
+	  _active[gene] = false;
+
+	  if (improveTwoOpt (gene) || improveOrOpt (gene))
+	    ++moves;
+	}
+
+      return moves;
+    }
+
+    /* Return the optimized chromosome */
+    void LocalSearch::getChromosome (RingIndividual::Chromosome* chromosome)
+      const
+    {
+      chromosome->assign (_tour.begin (), _tour.begin () + _dummy);
+    }
+
+    /*
+     * Try 2-opt moves replacing an edge of a gene by an edge to one of its
+     * candidate neighbours
+     *
+     * \return 'true' if an improving move has been applied
+     */
+    bool LocalSearch::improveTwoOpt (unsigned int gene)
+    {
+      const unsigned int* neighbours = _neighbourhood->getNeighbours (gene);
+      unsigned int number_of_neighbours =
+	_neighbourhood->getNumberOfNeighbours ();
+
+      for (unsigned int direction=0; direction < 2; ++direction)
+	{
+	  unsigned int next = direction == 0 ?
+	    getNext (gene) : getPrevious (gene);
+	  double removed_cost = getCost (gene, next);
+
+	  for (unsigned int i=0; i < number_of_neighbours; ++i)
+	    {
+	      unsigned int neighbour = neighbours[i];
+	      double added_cost = getCost (gene, neighbour);
+
+	      if (added_cost >= removed_cost)
+		break;
+
+	      unsigned int neighbour_next = direction == 0 ?
+		getNext (neighbour) : getPrevious (neighbour);
+
+	      if (neighbour == next || neighbour_next == gene)
+		continue;
+
+	      double gain = removed_cost + getCost (neighbour, neighbour_next) -
+		added_cost - getCost (next, neighbour_next);
+
+	      if (gain > MIN_GAIN)
+		{
+		  connect (gene, next, neighbour, neighbour_next);
+
+		  activate (gene);
+		  activate (next);
+		  activate (neighbour);
+		  activate (neighbour_next);
+		  return true;
+		}
+	    }
+	}
+
+      return false;
+    }
+
+    /*
+     * Try or-opt moves inserting a short sequence starting or ending with a
+     * gene between one of the candidate neighbours of its end genes and a
+     * tour neighbour of that candidate
+     *
+     * \return 'true' if an improving move has been applied
+     */
+    bool LocalSearch::improveOrOpt (unsigned int gene)
+    {
+      unsigned int number_of_neighbours =
+	_neighbourhood->getNumberOfNeighbours ();
+
+      for (unsigned int length=1; length <= MAX_OR_OPT_LENGTH; ++length)
+	for (unsigned int direction=0; direction < 2; ++direction)
+	  {
+	    if (length == 1 && direction == 1)
+	      continue;
+
+	    //
+	    // Sequence first ... last in tour direction, enclosed by 'previous'
+	    // and 'next'
+	    //
+	    unsigned int size = _tour.size ();
+	    unsigned int position = direction == 0 ?
+	      _positions[gene] : _positions[gene] + size - (length - 1);
+	    unsigned int first = _tour[position % size];
+	    unsigned int last = _tour[(position + length - 1) % size];
+
+	    if (!_round_trip && isInSequence (_dummy, first, length))
+	      continue;
+
+	    unsigned int previous = getPrevious (first);
+	    unsigned int next = getNext (last);
+
+	    double removed_cost = getCost (previous, first) +
+	      getCost (last, next) - getCost (previous, next);
+
+	    if (removed_cost <= MIN_GAIN)
+	      continue;
+
+	    for (unsigned int end=0; end < 2; ++end)
+	      {
+		unsigned int end_gene = end == 0 ? first : last;
+		const unsigned int* neighbours =
+		  _neighbourhood->getNeighbours (end_gene);
+
+		for (unsigned int i=0; i < number_of_neighbours; ++i)
+		  {
+		    unsigned int neighbour = neighbours[i];
+		    if (getCost (end_gene, neighbour) >= removed_cost)
+		      break;
+
+		    if (isInSequence (neighbour, first, length))
+		      continue;
+
+		    for (unsigned int side=0; side < 2; ++side)
+		      {
+			//
+			// The sequence is inserted between 'left' and 'right'
+			//
+			unsigned int left =
+			  side == 0 ? neighbour : getPrevious (neighbour);
+			unsigned int right =
+			  side == 0 ? getNext (neighbour) : neighbour;
+
+			if (isInSequence (left, first, length) ||
+			    isInSequence (right, first, length) ||
+			    left == next || right == previous)
+			  continue;
+
+			double reversed_cost =
+			  getCost (left, last) + getCost (first, right);
+			double kept_cost =
+			  getCost (left, first) + getCost (last, right);
+
+			double gain = removed_cost + getCost (left, right) -
+			  std::min (reversed_cost, kept_cost);
+
+			if (gain <= MIN_GAIN)
+			  continue;
+
+			//
+			// The move consists of two or three 2-opt moves
+			//
+			connect (previous, first, left, right);
+			connect (previous, left, next, last);
+			if (kept_cost < reversed_cost)
+			  connect (left, last, first, right);
+
+			activate (previous);
+			activate (next);
+			activate (left);
+			activate (right);
+			activate (first);
+			activate (last);
+			return true;
+		      }
+		  }
+	      }
+	  }
+
+      return false;
+    }
+
+    /*
+     * Replace the edges gene_1-gene_2 and gene_3-gene_4 by the edges
+     * gene_1-gene_3 and gene_2-gene_4
+     *
+     * Both edges must be given in the same tour direction.
+     */
+    void LocalSearch::connect (unsigned int gene_1, unsigned int gene_2,
+			       unsigned int gene_3, unsigned int gene_4)
+    {
+      if (getNext (gene_1) == gene_2)
+	reverse (_positions[gene_2], _positions[gene_3]);
+      else
+	reverse (_positions[gene_1], _positions[gene_4]);
+    }
+
+    /*
+     * Reverse the tour section from position 'first' up to position 'last'
+     *
+     * Reversing the complementary section yields the same tour, so the
+     * shorter one is reversed. For open paths, the section without the
+     * dummy gene is reversed instead.
+     */
+    void LocalSearch::reverse (unsigned int first, unsigned int last)
+    {
+      unsigned int size = _tour.size ();
+      unsigned int length = (last + size - first) % size + 1;
+
+      bool complement = _round_trip ?
+	2 * length > size : isInSequence (_dummy, _tour[first], length);
+
+      if (complement)
+	{
+	  first = (last + 1) % size;
+	  length = size - length;
+	}
+
+      for (unsigned int i=0; i < length / 2; ++i)
+	{
+	  unsigned int position_1 = (first + i) % size;
+	  unsigned int position_2 = (first + length - 1 - i) % size;
+
+	  swap (&_tour[position_1], &_tour[position_2]);
+	  _positions[_tour[position_1]] = position_1;
+	  _positions[_tour[position_2]] = position_2;
+	}
+    }
+
+    /* Reset the don't look bit of a gene */
+    void LocalSearch::activate (unsigned int gene)
+    {
+      if (gene == _dummy || _active[gene])
+	return;
+
+      _active[gene] = true;
+      _queue.push_back (gene);
+    }
+
+    static QThreadStorage<Random*> randoms;
+    static QMutex seed_mutex;
+    static Random seed_random;
+
+    /*
+     * Return the random number generator of the calling thread
+     *
+     * The generators are seeded from a common one, so threads started at
+     * the same time do not produce the same numbers.
+     */
+    static const Random& getRandom ()
+    {
+      if (!randoms.hasLocalData ())
+	{
+	  QMutexLocker locker (&seed_mutex);
+	  int seed = seed_random.getInt (0, std::numeric_limits<int>::max ());
+	  randoms.setLocalData (new Random (seed));
+	}
+
+      return *randoms.localData ();
+    }
+
+    /*
+     * Constructor
+     *
+     * \param neighbourhood        Candidate neighbours and edge costs of the
+     *                             genes. Not owned by the operator.
+     * \param mutation_probability Probability of an individual to be
+     *                             improved
+     * \param max_moves            Maximum number of moves per individual
+     * \param round_trip           If 'false', the chromosome is an open path
+     *                             and the edge from the last to the first
+     *                             gene costs nothing
+     */
+    RingLocalSearchMutationOperator::RingLocalSearchMutationOperator
+    (const Neighbourhood* neighbourhood, double mutation_probability,
+     unsigned int max_moves, bool round_trip)
+      : MutationOperator ("Local search mutation"),
+	_neighbourhood        (neighbourhood),
+	_mutation_probability (mutation_probability),
+	_max_moves            (max_moves),
+	_round_trip           (round_trip)
+    {
+      if (_neighbourhood == 0)
+	throw InternalException ("No neighbourhood given");
+
+      if (_mutation_probability < 0.0 || _mutation_probability > 1.0)
+        throw InternalException ("Mutation probability out of valid range");
+    }
+
+    /* Destructor */
+    RingLocalSearchMutationOperator::~RingLocalSearchMutationOperator ()
+    {}
+
+    /* Improve ring based individual */
+    Individual* RingLocalSearchMutationOperator::mutate
+    (const Individual* source) const
+    {
+      const RingIndividual* ring = toRing (source);
+      RingIndividual* target = dynamic_cast<RingIndividual*> (ring->clone ());
+
+      if (getRandom ().getDouble (0.0, 1.0) >= _mutation_probability)
+	return target;
+
+      LocalSearch search (_neighbourhood, ring->getChromosome (), _round_trip);
+
+      if (search.optimize (_max_moves) > 0)
+	{
+	  RingIndividual::Chromosome chromosome;
+	  search.getChromosome (&chromosome);
+	  target->setChromosome (chromosome);
+	}
+
       return target;
     }
 
+    /* Return if the operator can mutate several individuals in parallel */
+    bool RingLocalSearchMutationOperator::isThreadSafe () const
+    {
+      return true;
+    }
+
 
   } // namespace Core
 } // namespace GEP
@@ -6,15 +6,186 @@
 
 #include "GEPCoreSelection.hpp"
 #include "GEPCoreIndividual.hpp"
+#include "GEPCoreParetoRanking.hpp"
 #include "GEPCorePopulation.hpp"
 
 #include <GEPDebug.hpp>
+#include <GEPException.hpp>
+#include <GEPParallel.hpp>
+
+#include <QtCore/QMutexLocker>
 
 #include <algorithm>
+#include <limits>
+#include <math.h>
 
 namespace GEP {
   namespace Core {
-    
+
+    namespace {
+
+      /*
+       * Return the selection weights of the individuals of a population
+       *
+       * Negative fitness values are treated as 0. If no individual has a
+       * positive fitness, all are weighted equally.
+       *
+       * \param sum Set to the sum of all weights
+       */
+      std::vector<double> getFitnessWeights (const Population* source,
+					     double* sum)
+      {
+	std::vector<double> weights;
+	weights.reserve (source->size ());
+
+	*sum = 0.0;
+	for ( Population::IndividualConstIterator i =
+		source->getIndividualBegin ();
+	      i != source->getIndividualEnd (); ++i )
+	  {
+	    weights.push_back (std::max ((*i)->getFitness (), 0.0));
+	    *sum += weights.back ();
+	  }
+
+	if (*sum <= 0.0)
+	  {
+	    std::fill (weights.begin (), weights.end (), 1.0);
+	    *sum = weights.size ();
+	  }
+
+	return weights;
+      }
+
+      /*
+       * Comparator ordering population indices by descending fitness
+       */
+      class IndexFitnessComparator
+      {
+      public:
+	IndexFitnessComparator (const std::vector<double>& fitness)
+	  : _fitness (fitness)
+	{
+	}
+
+	inline bool operator () (unsigned int a, unsigned int b) const
+	{
+	  return _fitness[a] > _fitness[b];
+	}
+
+      private:
+	const std::vector<double>& _fitness;
+      };
+
+      /*
+       * Return the fitness values of the individuals of a population
+       */
+      std::vector<double> getFitness (const Population* source)
+      {
+	std::vector<double> fitness;
+	fitness.reserve (source->size ());
+
+	for ( Population::IndividualConstIterator i =
+		source->getIndividualBegin ();
+	      i != source->getIndividualEnd (); ++i )
+	  fitness.push_back ((*i)->getFitness ());
+
+	return fitness;
+      }
+
+      /*
+       * Return the indices of a population in ascending order
+       */
+      std::vector<unsigned int> getIndices (const Population* source)
+      {
+	std::vector<unsigned int> indices (source->size ());
+	for (unsigned int i=0; i < indices.size (); ++i)
+	  indices[i] = i;
+
+	return indices;
+      }
+
+      /*
+       * Alias table for O(1) sampling from a discrete distribution
+       * (Vose's method)
+       */
+      class AliasTable
+      {
+      public:
+	AliasTable (const std::vector<double>& weights, double sum);
+
+	unsigned int draw (const Random& random) const;
+
+      private:
+	std::vector<double> _probabilities;
+	std::vector<unsigned int> _aliases;
+      };
+
+      /*
+       * Constructor
+       *
+       * Each column i keeps its own index with probability _probabilities[i]
+       * and otherwise yields _aliases[i]. Columns with less than average
+       * weight are filled up with the excess of columns above average.
+       */
+      AliasTable::AliasTable (const std::vector<double>& weights, double sum)
+	: _probabilities (weights.size (), 1.0),
+	  _aliases       (weights.size ())
+      {
+	unsigned int n = weights.size ();
+
+	std::vector<double> scaled (n);
+	std::vector<unsigned int> small;
+	std::vector<unsigned int> large;
+
+	for (unsigned int i=0; i < n; ++i)
+	  {
+	    scaled[i] = weights[i] * n / sum;
+	    _aliases[i] = i;
+
+	    if (scaled[i] < 1.0)
+	      small.push_back (i);
+	    else
+	      large.push_back (i);
+	  }
+
+	while (!small.empty () && !large.empty ())
+	  {
+	    unsigned int less = small.back ();
+	    unsigned int more = large.back ();
+	    small.pop_back ();
+
+	    _probabilities[less] = scaled[less];
+	    _aliases[less] = more;
+
+	    scaled[more] -= 1.0 - scaled[less];
+	    if (scaled[more] < 1.0)
+	      {
+		large.pop_back ();
+		small.push_back (more);
+	      }
+	  }
+
+	//
+	// Remaining columns are full up to rounding errors
+	//
+	for (unsigned int i=0; i < small.size (); ++i)
+	  _probabilities[small[i]] = 1.0;
+      }
+
+      /* Draw a random index */
+      inline unsigned int AliasTable::draw (const Random& random) const
+      {
+	unsigned int column = random.getInt (0, _probabilities.size () - 1);
+
+	if (random.getDouble (0.0, 1.0) < _probabilities[column])
+	  return column;
+
+	return _aliases[column];
+      }
+
+    }
+
+
     //#***********************************************************************
     // CLASS GEP::Core::SelectionOperator
     //#***********************************************************************
@@ -46,22 +217,235 @@ namespace GEP {
     {
     }
 
+    /*
+     * Select individuals
+     *
+     * Only the better half is needed, so the individuals are partitioned
+     * instead of sorted.
+     */
+    void BestSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      if (source->size () == 0)
+	return;
+
+      std::vector<double> fitness = getFitness (source);
+      std::vector<unsigned int> indices = getIndices (source);
+
+      unsigned int half = indices.size () / 2;
+      std::nth_element (indices.begin (), indices.begin () + half,
+			indices.end (), IndexFitnessComparator (fitness));
+
+      for (unsigned int i=0; i < source->size (); ++i)
+	selection->push_back (indices[_random.getInt (0, half)]);
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::TruncationSelectionOperator
+    //#***********************************************************************
+
+    namespace {
+
+      /*
+       * Comparator ordering candidates by descending fitness
+       */
+      class CandidateComparator
+      {
+      public:
+	inline bool operator () (const std::pair<double, unsigned int>& a,
+				 const std::pair<double, unsigned int>& b) const
+	{
+	  return a.first > b.first;
+	}
+      };
+
+      /*
+       * Task determining the best candidates per chunk of a population
+       */
+      class TruncationTask : public ParallelTask
+      {
+      public:
+	typedef std::pair<double, unsigned int> Candidate;
+	typedef void (*SelectFunction) (std::vector<Candidate>*, unsigned int);
+
+	TruncationTask (const Population* source, unsigned int number,
+			unsigned int number_of_chunks,
+			SelectFunction select_best)
+	  : _source (source), _number (number), _chunks (number_of_chunks),
+	    _select_best (select_best)
+	{
+	}
+
+	virtual void execute (unsigned int chunk, unsigned int begin,
+			      unsigned int end)
+	{
+	  std::vector<Candidate>& candidates = _chunks[chunk];
+	  candidates.reserve (end - begin);
+
+	  for (unsigned int i=begin; i < end; ++i)
+	    candidates.push_back (Candidate ((*_source)[i]->getFitness (), i));
+
+	  _select_best (&candidates, _number);
+	}
+
+	inline const std::vector<Candidate>& getChunk (unsigned int chunk) const
+	{
+	  return _chunks[chunk];
+	}
+
+      private:
+	const Population* _source;
+	unsigned int _number;
+	std::vector< std::vector<Candidate> > _chunks;
+	SelectFunction _select_best;
+      };
+
+    }
+
+    /*
+     * Constructor
+     *
+     * \param ratio Share of the best individuals to select from in (0, 1]
+     */
+    TruncationSelectionOperator::TruncationSelectionOperator (double ratio)
+      : SelectionOperator ("Truncation selection"),
+	_ratio (ratio)
+    {
+      if (_ratio <= 0.0 || _ratio > 1.0)
+	throw InternalException ("Truncation ratio out of valid range");
+    }
+
+    /* Constructor for derived operators */
+    TruncationSelectionOperator::TruncationSelectionOperator
+    (const QString& description, double ratio)
+      : SelectionOperator (description),
+	_ratio (ratio)
+    {
+      if (_ratio <= 0.0 || _ratio > 1.0)
+	throw InternalException ("Truncation ratio out of valid range");
+    }
+
+    /* Destructor */
+    TruncationSelectionOperator::~TruncationSelectionOperator ()
+    {
+    }
+
+    /* Return the number of best individuals to select from */
+    unsigned int TruncationSelectionOperator::getNumberOfSelectable
+    (unsigned int size) const
+    {
+      unsigned int number = static_cast<unsigned int> (ceil (size * _ratio));
+      return std::max (std::min (number, size), 1u);
+    }
+
+    /*
+     * [STATIC] Keep only the best candidates
+     *
+     * \param candidates (fitness, index) pairs, shrunk to the best 'number'
+     *                   ones in arbitrary order
+     * \param number     Number of candidates to keep
+     */
+    void TruncationSelectionOperator::selectBest
+    (std::vector<Candidate>* candidates, unsigned int number)
+    {
+      if (number < candidates->size ())
+	{
+	  std::nth_element (candidates->begin (),
+			    candidates->begin () + number,
+			    candidates->end (), CandidateComparator ());
+	  candidates->resize (number);
+	}
+    }
+
+    /* Add random picks among the best to the selection */
+    void TruncationSelectionOperator::addSelected
+    (const Population* source, const std::vector<Candidate>& best,
+     std::vector<unsigned int>* selection) const
+    {
+      std::vector<int> picks;
+      _random.getInts (0, best.size () - 1, source->size (), &picks);
+
+      for (unsigned int i=0; i < picks.size (); ++i)
+	selection->push_back (best[picks[i]].second);
+    }
+
     /* Select individuals */
-    void BestSelectionOperator::select (const Population* source,
-					Population* target) const
+    void TruncationSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
     {
-      std::vector<const Individual*> individuals;
+      unsigned int n = source->size ();
+      if (n == 0)
+	return;
+
+      std::vector<Candidate> candidates;
+      candidates.reserve (n);
+
+      unsigned int index = 0;
       for ( Population::IndividualConstIterator i =
 	      source->getIndividualBegin ();
-	    i != source->getIndividualEnd (); ++i )
-	individuals.push_back (*i);
+	    i != source->getIndividualEnd (); ++i, ++index )
+	candidates.push_back (Candidate ((*i)->getFitness (), index));
 
-      std::sort (individuals.begin (), individuals.end (),
-		 IndividualFitnessComparator ());
+      selectBest (&candidates, getNumberOfSelectable (n));
+      addSelected (source, candidates, selection);
+    }
 
-      for (unsigned int i=0; i < source->size (); ++i)
-	target->addIndividual
-	  (individuals[_random.getInt (0, individuals.size () / 2)]->clone ());
+
+    //#***********************************************************************
+    // CLASS GEP::Core::ParallelTruncationSelectionOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param ratio             Share of the best individuals to select from
+     *                          in (0, 1]
+     * \param number_of_threads Number of parallel threads or 0 to use one
+     *                          per processor
+     */
+    ParallelTruncationSelectionOperator::ParallelTruncationSelectionOperator
+    (double ratio, unsigned int number_of_threads)
+      : TruncationSelectionOperator ("Parallel truncation selection", ratio),
+	_number_of_threads (number_of_threads)
+    {
+      if (_number_of_threads == 0)
+	_number_of_threads = Parallel::getNumberOfThreads ();
+    }
+
+    /* Destructor */
+    ParallelTruncationSelectionOperator::~ParallelTruncationSelectionOperator ()
+    {
+    }
+
+    /*
+     * Select individuals
+     *
+     * Each chunk keeps its best 'k' candidates, since the overall best 'k'
+     * are contained in the union of these.
+     */
+    void ParallelTruncationSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      unsigned int n = source->size ();
+      if (n == 0)
+	return;
+
+      unsigned int number = getNumberOfSelectable (n);
+      unsigned int number_of_chunks = std::min (_number_of_threads, n);
+
+      TruncationTask task (source, number, number_of_chunks, &selectBest);
+      Parallel::execute (&task, n, number_of_chunks);
+
+      std::vector<Candidate> candidates;
+      candidates.reserve (number_of_chunks * number);
+
+      for (unsigned int i=0; i < number_of_chunks; ++i)
+	candidates.insert (candidates.end (), task.getChunk (i).begin (),
+			   task.getChunk (i).end ());
+
+      selectBest (&candidates, number);
+      addSelected (source, candidates, selection);
     }
 
     
@@ -81,44 +465,633 @@ namespace GEP {
     }
 
     /* Select individuals */
-    void RouletteSelectionOperator::select (const Population* source,
-					    Population* target) const
+    void RouletteSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
     {
+      if (source->size () == 0)
+	return;
+
       //
-      // Step 1: Create table with fitness sum
+      // Step 1: Create alias table from the fitness values
       //
-      typedef std::pair<double, const Individual*> Fitness;
-      std::vector<Fitness> fitness;
-
       double sum = 0.0;
-      for ( Population::IndividualConstIterator i =
-	      source->getIndividualBegin ();
-	    i != source->getIndividualEnd (); ++i )
-      {
-	const Individual* individual = *i;
-	sum += individual->getFitness ();
-	fitness.push_back (Fitness (sum, individual));
-      }
+      std::vector<double> weights = getFitnessWeights (source, &sum);
+
+      AliasTable table (weights, sum);
 
       //
       // Step 2: Select individuals via roulette selection
       //
       for (unsigned i=0; i < source->size (); ++i)
+	selection->push_back (table.draw (_random));
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::StochasticUniversalSamplingOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    StochasticUniversalSamplingOperator::StochasticUniversalSamplingOperator ()
+      : SelectionOperator ("Stochastic universal sampling")
+    {
+    }
+
+    /* Destructor */
+    StochasticUniversalSamplingOperator::~StochasticUniversalSamplingOperator ()
+    {
+    }
+
+    /*
+     * Select individuals
+     *
+     * The selected individuals are shuffled afterwards, since sampling
+     * yields them in population order, which would let crossover mostly
+     * combine copies of the same individual.
+     */
+    void StochasticUniversalSamplingOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      unsigned int n = source->size ();
+      if (n == 0)
+	return;
+
+      double sum = 0.0;
+      std::vector<double> weights = getFitnessWeights (source, &sum);
+
+      //
+      // Step 1: Sweep the equally spaced pointers over the fitness sums
+      //
+      std::vector<unsigned int> selected;
+      selected.reserve (n);
+
+      double step = sum / n;
+      double pointer = _random.getDouble (0.0, step);
+      double cumulated = 0.0;
+      unsigned int last = 0;
+
+      for (unsigned int i=0; i < n && selected.size () < n; ++i)
+	{
+	  cumulated += weights[i];
+	  if (weights[i] > 0.0)
+	    last = i;
+
+	  while (pointer < cumulated && selected.size () < n)
+	    {
+	      selected.push_back (i);
+	      pointer += step;
+	    }
+	}
+
+      //
+      // Rounding errors may leave the last pointers behind the sum
+      //
+      while (selected.size () < n)
+	selected.push_back (last);
+
+      //
+      // Step 2: Add the selected individuals in random order
+      //
+      for (unsigned int i=n - 1; i > 0; --i)
+	std::swap (selected[i], selected[_random.getInt (0, i)]);
+
+      selection->insert (selection->end (), selected.begin (), selected.end ());
+    }
+
+    
+    //#***********************************************************************
+    // CLASS GEP::Core::RankSelectionOperator
+    //#***********************************************************************
+
+    /* Constructor */
+    RankSelectionOperator::RankSelectionOperator (const QString& description)
+      : SelectionOperator (description)
+    {
+    }
+
+    /* Destructor */
+    RankSelectionOperator::~RankSelectionOperator ()
+    {
+    }
+
+    /*
+     * Return the cumulative probability table for a population size
+     *
+     * Entry i is the probability to select an individual with rank <= i,
+     * where rank 0 is the best individual. Tables are never removed, so
+     * the returned reference stays valid.
+     */
+    const std::vector<double>& RankSelectionOperator::getTable
+    (unsigned int size) const
+    {
+      QMutexLocker lock (&_mutex);
+
+      std::map<unsigned int, std::vector<double> >::iterator pos =
+	_tables.find (size);
+      if (pos != _tables.end ())
+	return pos->second;
+
+      std::vector<double>& table = _tables[size];
+      table.resize (size);
+
+      double sum = 0.0;
+      for (unsigned int rank=0; rank < size; ++rank)
+	{
+	  sum += computeWeight (rank, size);
+	  table[rank] = sum;
+	}
+
+      for (unsigned int rank=0; rank < size; ++rank)
+	table[rank] /= sum;
+
+      return table;
+    }
+
+    /* Select individuals */
+    void RankSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      unsigned int n = source->size ();
+      if (n == 0)
+	return;
+
+      std::vector<double> fitness = getFitness (source);
+      std::vector<unsigned int> indices = getIndices (source);
+      std::sort (indices.begin (), indices.end (),
+		 IndexFitnessComparator (fitness));
+
+      const std::vector<double>& table = getTable (n);
+
+      std::vector<double> chances;
+      _random.getDoubles (0.0, 1.0, n, &chances);
+
+      for (unsigned int i=0; i < n; ++i)
+	{
+	  unsigned int rank =
+	    std::upper_bound (table.begin (), table.end (), chances[i]) -
+	    table.begin ();
+
+	  selection->push_back (indices[std::min (rank, n - 1)]);
+	}
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::LinearRankSelectionOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param pressure Selection pressure in [1, 2]. 1 selects uniformly.
+     */
+    LinearRankSelectionOperator::LinearRankSelectionOperator (double pressure)
+      : RankSelectionOperator ("Linear rank selection"),
+	_pressure (pressure)
+    {
+      if (_pressure < 1.0 || _pressure > 2.0)
+	throw InternalException ("Selection pressure out of valid range");
+    }
+
+    /* Destructor */
+    LinearRankSelectionOperator::~LinearRankSelectionOperator ()
+    {
+    }
+
+    /* Compute the relative selection weight of a rank */
+    double LinearRankSelectionOperator::computeWeight (unsigned int rank,
+						       unsigned int size) const
+    {
+      if (size < 2)
+	return 1.0;
+
+      double position = static_cast<double> (size - 1 - rank) / (size - 1);
+      return 2.0 - _pressure + 2.0 * (_pressure - 1.0) * position;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::ExponentialRankSelectionOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param base Weight ratio of neighbouring ranks in (0, 1]
+     */
+    ExponentialRankSelectionOperator::ExponentialRankSelectionOperator
+    (double base)
+      : RankSelectionOperator ("Exponential rank selection"),
+	_base (base)
+    {
+      if (_base <= 0.0 || _base > 1.0)
+	throw InternalException ("Exponential base out of valid range");
+    }
+
+    /* Destructor */
+    ExponentialRankSelectionOperator::~ExponentialRankSelectionOperator ()
+    {
+    }
+
+    /* Compute the relative selection weight of a rank */
+    double ExponentialRankSelectionOperator::computeWeight
+    (unsigned int rank, unsigned int /*size*/) const
+    {
+      return pow (_base, static_cast<double> (rank));
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::TournamentSelectionOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param tournament_size    Number of individuals competing per selection
+     * \param winner_probability Probability of the best candidate to win
+     *                           in (0, 1]
+     */
+    TournamentSelectionOperator::TournamentSelectionOperator
+    (unsigned int tournament_size, double winner_probability)
+      : SelectionOperator ("Tournament selection"),
+	_tournament_size    (tournament_size),
+	_winner_probability (winner_probability)
+    {
+      if (_tournament_size < 1)
+	throw InternalException ("Tournament size must be at least 1");
+
+      if (_winner_probability <= 0.0 || _winner_probability > 1.0)
+	throw InternalException ("Winner probability out of valid range");
+    }
+
+    /* Destructor */
+    TournamentSelectionOperator::~TournamentSelectionOperator ()
+    {
+    }
+
+    /*
+     * Select individuals
+     *
+     * The candidates of all tournaments are drawn in a single batch and
+     * compared via a contiguous copy of the fitness values.
+     */
+    void TournamentSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      unsigned int n = source->size ();
+      if (n == 0)
+	return;
+
+      std::vector<double> fitness = getFitness (source);
+
+      std::vector<int> candidates;
+      _random.getInts (0, n - 1, n * _tournament_size, &candidates);
+
+      std::vector<double> chances;
+      if (_winner_probability < 1.0)
+	_random.getDoubles (0.0, 1.0, n, &chances);
+
+      for (unsigned int i=0; i < n; ++i)
+	{
+	  int* begin = &candidates[i * _tournament_size];
+	  int* end = begin + _tournament_size;
+
+	  int winner = *begin;
+
+	  if (_winner_probability >= 1.0)
+	    {
+	      for (int* candidate = begin + 1; candidate != end; ++candidate)
+		if (fitness[*candidate] > fitness[winner])
+		  winner = *candidate;
+	    }
+	  else
+	    {
+	      //
+	      // Rank the (few) candidates by insertion sort, then walk down
+	      // the ranking until the winner probability hits
+	      //
+	      for (int* j = begin + 1; j != end; ++j)
+		for (int* k = j; k != begin && fitness[*k] > fitness[*(k - 1)];
+		     --k)
+		  std::swap (*k, *(k - 1));
+
+	      double chance = chances[i];
+	      double probability = _winner_probability;
+
+	      int* candidate = begin;
+	      while (candidate + 1 != end && chance >= probability)
+		{
+		  chance -= probability;
+		  probability *= 1.0 - _winner_probability;
+		  ++candidate;
+		}
+
+	      winner = *candidate;
+	    }
+
+	  selection->push_back (winner);
+	}
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::LexicaseSelectionOperator
+    //#***********************************************************************
+
+    namespace {
+
+      /*
+       * Task executing a chunk of lexicase selection events
+       *
+       * The errors are stored case by case, so filtering the candidates on
+       * a case reads a contiguous row.
+       */
+      class LexicaseTask : public ParallelTask
       {
-	double n = _random.getDouble (0.0, sum);
+      public:
+	LexicaseTask (const std::vector<double>& errors,
+		      const std::vector<double>& epsilons,
+		      unsigned int number_of_individuals,
+		      const std::vector<unsigned int>& seeds,
+		      std::vector<unsigned int>* selection)
+	  : _errors (errors), _epsilons (epsilons),
+	    _number_of_individuals (number_of_individuals),
+	    _number_of_cases (epsilons.size ()),
+	    _seeds (seeds), _selection (selection)
+	{
+	}
 
-	const Individual* selected = 0;
-	for (unsigned int j=0; j < fitness.size () && selected == 0; ++j)
+	virtual void execute (unsigned int chunk, unsigned int begin,
+			      unsigned int end)
 	{
-	  if (fitness[j].first > n)
-	    selected = fitness[j].second;
+	  Random random (_seeds[chunk]);
+
+	  std::vector<unsigned int> candidates (_number_of_individuals);
+	  std::vector<unsigned int> cases (_number_of_cases);
+
+	  for (unsigned int i=0; i < cases.size (); ++i)
+	    cases[i] = i;
+
+	  for (unsigned int event=begin; event < end; ++event)
+	    {
+	      for (unsigned int i=0; i < _number_of_individuals; ++i)
+		candidates[i] = i;
+
+	      unsigned int size = _number_of_individuals;
+
+	      //
+	      // The case order is shuffled lazily, since mostly only a few
+	      // cases are needed to reduce the candidates to one
+	      //
+	      for (unsigned int i=0; i < _number_of_cases && size > 1; ++i)
+		{
+		  std::swap (cases[i],
+			     cases[random.getInt (i, _number_of_cases - 1)]);
+
+		  const double* row =
+		    &_errors[cases[i] * _number_of_individuals];
+
+		  double best = row[candidates[0]];
+		  for (unsigned int j=1; j < size; ++j)
+		    best = std::min (best, row[candidates[j]]);
+
+		  double limit = best + _epsilons[cases[i]];
+
+		  unsigned int kept = 0;
+		  for (unsigned int j=0; j < size; ++j)
+		    if (row[candidates[j]] <= limit)
+		      candidates[kept++] = candidates[j];
+
+		  size = kept;
+		}
+
+	      (*_selection)[event] = candidates[random.getInt (0, size - 1)];
+	    }
 	}
 
-	if (selected == 0 && source->size () > 0)
-	  selected = (*source)[source->size () - 1];
+      private:
+	const std::vector<double>& _errors;
+	const std::vector<double>& _epsilons;
+	unsigned int _number_of_individuals;
+	unsigned int _number_of_cases;
+	const std::vector<unsigned int>& _seeds;
+	std::vector<unsigned int>* _selection;
+      };
+
+      /*
+       * Return the median of a range of values, which is reordered
+       */
+      double computeMedian (std::vector<double>::iterator begin,
+			    std::vector<double>::iterator end)
+      {
+	std::vector<double>::iterator middle = begin + (end - begin) / 2;
+	std::nth_element (begin, middle, end);
+
+	if ((end - begin) % 2 == 1)
+	  return *middle;
 
-	target->addIndividual (selected->clone ());
+	return (*middle + *std::max_element (begin, middle)) / 2.0;
       }
+
+    }
+
+    /*
+     * Constructor
+     *
+     * \param number_of_threads Number of parallel threads or 0 to use one
+     *                          per processor
+     */
+    LexicaseSelectionOperator::LexicaseSelectionOperator
+    (unsigned int number_of_threads)
+      : SelectionOperator ("Lexicase selection"),
+	_number_of_threads (number_of_threads)
+    {
+      if (_number_of_threads == 0)
+	_number_of_threads = Parallel::getNumberOfThreads ();
+    }
+
+    /* Constructor for derived operators */
+    LexicaseSelectionOperator::LexicaseSelectionOperator
+    (const QString& description, unsigned int number_of_threads)
+      : SelectionOperator (description),
+	_number_of_threads (number_of_threads)
+    {
+      if (_number_of_threads == 0)
+	_number_of_threads = Parallel::getNumberOfThreads ();
+    }
+
+    /* Destructor */
+    LexicaseSelectionOperator::~LexicaseSelectionOperator ()
+    {
+    }
+
+    /*
+     * Compute the tolerated error difference to the best candidate per case
+     *
+     * Plain lexicase selection keeps only candidates with exactly the best
+     * error.
+     *
+     * \param errors                Errors stored case by case
+     * \param number_of_individuals Number of errors per case
+     * \param epsilons              Receives one tolerance per case. The
+     *                              vector is already sized accordingly.
+     */
+    void LexicaseSelectionOperator::computeEpsilons
+    (const std::vector<double>& /*errors*/,
+     unsigned int /*number_of_individuals*/,
+     std::vector<double>* epsilons) const
+    {
+      std::fill (epsilons->begin (), epsilons->end (), 0.0);
+    }
+
+    /*
+     * Select individuals
+     *
+     * All individuals must have the same number of objective values, which
+     * are the errors on the test cases.
+     */
+    void LexicaseSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      unsigned int n = source->size ();
+      if (n == 0)
+	return;
+
+      //
+      // Step 1: Copy the errors into a case major matrix
+      //
+      unsigned int number_of_cases = (*source)[0]->getNumberOfObjectives ();
+      if (number_of_cases == 0)
+	throw InternalException ("Lexicase selection needs objective values");
+
+      std::vector<double> errors (number_of_cases * n);
+
+      for (unsigned int i=0; i < n; ++i)
+	{
+	  const Individual* individual = (*source)[i];
+	  if (individual->getNumberOfObjectives () != number_of_cases)
+	    throw InternalException ("Individuals differ in number of cases");
+
+	  for (unsigned int c=0; c < number_of_cases; ++c)
+	    errors[c * n + i] = individual->getObjective (c);
+	}
+
+      std::vector<double> epsilons (number_of_cases, 0.0);
+      computeEpsilons (errors, n, &epsilons);
+
+      //
+      // Step 2: Execute the selection events in parallel. Each chunk gets
+      //         its own random generator. Small populations are not worth
+      //         the thread overhead.
+      //
+      unsigned int number_of_chunks =
+	std::max (std::min (_number_of_threads, n / 64), 1u);
+
+      std::vector<unsigned int> seeds;
+      for (unsigned int i=0; i < number_of_chunks; ++i)
+	seeds.push_back (_random.getInt (0, std::numeric_limits<int>::max ()));
+
+      std::vector<unsigned int> selected (n);
+      LexicaseTask task (errors, epsilons, n, seeds, &selected);
+      Parallel::execute (&task, n, number_of_chunks);
+
+      selection->insert (selection->end (), selected.begin (), selected.end ());
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::EpsilonLexicaseSelectionOperator
+    //#***********************************************************************
+
+    /*
+     * Constructor
+     *
+     * \param number_of_threads Number of parallel threads or 0 to use one
+     *                          per processor
+     */
+    EpsilonLexicaseSelectionOperator::EpsilonLexicaseSelectionOperator
+    (unsigned int number_of_threads)
+      : LexicaseSelectionOperator ("Epsilon lexicase selection",
+				   number_of_threads)
+    {
+    }
+
+    /* Destructor */
+    EpsilonLexicaseSelectionOperator::~EpsilonLexicaseSelectionOperator ()
+    {
+    }
+
+    /* Compute the median absolute deviation of the errors per case */
+    void EpsilonLexicaseSelectionOperator::computeEpsilons
+    (const std::vector<double>& errors, unsigned int number_of_individuals,
+     std::vector<double>* epsilons) const
+    {
+      std::vector<double> values (number_of_individuals);
+
+      for (unsigned int c=0; c < epsilons->size (); ++c)
+	{
+	  std::vector<double>::const_iterator row =
+	    errors.begin () + c * number_of_individuals;
+
+	  std::copy (row, row + number_of_individuals, values.begin ());
+	  double median = computeMedian (values.begin (), values.end ());
+
+	  for (unsigned int i=0; i < number_of_individuals; ++i)
+	    values[i] = fabs (row[i] - median);
+
+	  (*epsilons)[c] = computeMedian (values.begin (), values.end ());
+	}
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::NonDominatedSortingSelectionOperator
+    //#***********************************************************************
+    
+    /*
+     * Constructor
+     *
+     * \param tournament_size Number of individuals competing per selection
+     */
+    NonDominatedSortingSelectionOperator::NonDominatedSortingSelectionOperator
+    (unsigned int tournament_size)
+      : SelectionOperator ("NSGA-II selection"),
+	_tournament_size (tournament_size)
+    {
+      if (_tournament_size < 1)
+	throw InternalException ("Tournament size must be at least 1");
+    }
+
+    /* Destructor */
+    NonDominatedSortingSelectionOperator::
+    ~NonDominatedSortingSelectionOperator ()
+    {
+    }
+
+    /* Select individuals */
+    void NonDominatedSortingSelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      if (source->size () == 0)
+	return;
+
+      ParetoRanking ranking;
+      ranking.compute (source);
+
+      for (unsigned int i=0; i < source->size (); ++i)
+	{
+	  unsigned int winner = _random.getInt (0, source->size () - 1);
+
+	  for (unsigned int j=1; j < _tournament_size; ++j)
+	    {
+	      unsigned int candidate = _random.getInt (0, source->size () - 1);
+	      if (ranking.isBetter (candidate, winner))
+		winner = candidate;
+	    }
+
+	  selection->push_back (winner);
+	}
     }
 
   } // namespace Core
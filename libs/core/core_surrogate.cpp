@@ -0,0 +1,27 @@
+/*
+ * core_surrogate.cpp - Surrogate models approximating the objective
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCoreSurrogate.hpp"
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::SurrogateModel
+    //#***********************************************************************
+
+    /* Constructor */
+    SurrogateModel::SurrogateModel ()
+    {
+    }
+
+    /* Destructor */
+    SurrogateModel::~SurrogateModel ()
+    {
+    }
+
+  } // namespace Core
+} // namespace GEP
@@ -0,0 +1,457 @@
+/*
+ * test_controller.cpp - Tests for the population handling of the controller
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#define _DEBUG
+
+#include "GEPCoreController.hpp"
+#include "GEPCoreCriterion.hpp"
+#include "GEPCorePopulation.hpp"
+#include "GEPCorePopulationSize.hpp"
+#include "GEPCoreRestart.hpp"
+#include "GEPCoreRingIndividual.hpp"
+#include "GEPCoreSelection.hpp"
+
+#include <GEPDebug.hpp>
+#include <GEPException.hpp>
+#include <GEPRandom.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <set>
+
+//
+// Size of the test chromosome
+//
+#define CHROMOSOME_SIZE 20
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::TestIndividual
+    //#***********************************************************************
+
+    class TestIndividual : public GEP::Core::RingIndividual
+    {
+    public:
+      TestIndividual ();
+      TestIndividual (const TestIndividual& toCopy);
+      virtual ~TestIndividual ();
+
+      virtual Individual* clone () const;
+    };
+
+    TestIndividual::TestIndividual ()
+      : RingIndividual ()
+    {
+    }
+
+    TestIndividual::TestIndividual (const TestIndividual& toCopy)
+      : RingIndividual (toCopy)
+    {
+    }
+
+    TestIndividual::~TestIndividual ()
+    {
+    }
+
+    Individual* TestIndividual::clone () const
+    {
+      return new TestIndividual (*this);
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::TestPopulation
+    //#***********************************************************************
+
+    /*
+     * Population deriving distinct objectives from the genotype hashes, so
+     * equal objectives mean equal genotypes
+     */
+    class TestPopulation : public GEP::Core::Population
+    {
+    public:
+      TestPopulation ();
+      virtual ~TestPopulation ();
+
+      virtual void computeFitness () const;
+    };
+
+    TestPopulation::TestPopulation ()
+      : Population ()
+    {
+    }
+
+    TestPopulation::~TestPopulation ()
+    {
+    }
+
+    void TestPopulation::computeFitness () const
+    {
+      double min_objective = std::numeric_limits<double>::max ();
+      double max_objective = -std::numeric_limits<double>::max ();
+
+      for ( IndividualConstIterator i = getIndividualBegin ();
+	    i != getIndividualEnd (); ++i )
+	{
+	  Individual* individual = *i;
+
+	  if (!individual->hasObjective ())
+	    individual->setObjective
+	      (static_cast<double> (individual->getHash ()));
+
+	  double objective = individual->getObjective ();
+	  min_objective = std::min (min_objective, objective);
+	  max_objective = std::max (max_objective, objective);
+	}
+
+      for ( IndividualConstIterator i = getIndividualBegin ();
+	    i != getIndividualEnd (); ++i )
+	{
+	  Individual* individual = *i;
+
+	  if (max_objective > min_objective)
+	    individual->setFitness
+	      ((max_objective - individual->getObjective ()) /
+	       (max_objective - min_objective));
+	  else
+	    individual->setFitness (1.0);
+	}
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::TestPopulationCreator
+    //#***********************************************************************
+
+    /*
+     * Creator for populations of random or identical individuals
+     */
+    class TestPopulationCreator : public GEP::Core::PopulationCreator
+    {
+    public:
+      TestPopulationCreator (bool identical);
+      virtual ~TestPopulationCreator ();
+
+      virtual Population* create (unsigned int size) const;
+
+      inline unsigned int getNumberOfCreated () const
+      { return _number_of_created; }
+
+    private:
+      bool _identical;
+      Random _random;
+
+      mutable unsigned int _number_of_created;
+    };
+
+    TestPopulationCreator::TestPopulationCreator (bool identical)
+      : PopulationCreator (),
+	_identical (identical),
+	_number_of_created (0)
+    {
+    }
+
+    TestPopulationCreator::~TestPopulationCreator ()
+    {
+    }
+
+    Population* TestPopulationCreator::create (unsigned int size) const
+    {
+      Population* population = new TestPopulation ();
+
+      for (unsigned int i=0; i < size; ++i)
+	{
+	  RingIndividual::Chromosome chromosome (CHROMOSOME_SIZE);
+	  for (unsigned int j=0; j < CHROMOSOME_SIZE; ++j)
+	    chromosome[j] = j;
+
+	  if (!_identical)
+	    for (unsigned int j=CHROMOSOME_SIZE - 1; j > 0; --j)
+	      std::swap (chromosome[j], chromosome[_random.getInt (0, j)]);
+
+	  TestIndividual* individual = new TestIndividual ();
+	  individual->setChromosome (chromosome);
+	  population->addIndividual (individual, true);
+	}
+
+      _number_of_created += size;
+
+      return population;
+    }
+
+
+    //#***********************************************************************
+    // CLASS GEP::Core::IdentitySelectionOperator
+    //#***********************************************************************
+
+    /*
+     * Selection keeping every individual once, so together with unchanged
+     * offspring the populations do not change
+     */
+    class IdentitySelectionOperator : public GEP::Core::SelectionOperator
+    {
+    public:
+      IdentitySelectionOperator ();
+      virtual ~IdentitySelectionOperator ();
+
+      virtual void select (const Population* source,
+			   std::vector<unsigned int>* selection) const;
+    };
+
+    IdentitySelectionOperator::IdentitySelectionOperator ()
+      : SelectionOperator ("Identity selection")
+    {
+    }
+
+    IdentitySelectionOperator::~IdentitySelectionOperator ()
+    {
+    }
+
+    void IdentitySelectionOperator::select
+    (const Population* source, std::vector<unsigned int>* selection) const
+    {
+      for (unsigned int i=0; i < source->size (); ++i)
+	selection->push_back (i);
+    }
+
+
+    //#***********************************************************************
+    // Test functions
+    //#***********************************************************************
+
+    /*
+     * Set up a controller with a single population, which does not change
+     * apart from restarts and resizing
+     */
+    static void setupController (Controller* controller,
+				 const TestPopulationCreator* creator,
+				 unsigned int size,
+				 double crossover_probability)
+    {
+      controller->setPopulationCreator (creator);
+      controller->setNumberOfPopulations (1);
+      controller->setNumberOfIndividuals (size);
+      controller->setCrossoverProbability (crossover_probability);
+      controller->addSelectionOperator (new IdentitySelectionOperator ());
+      controller->addCrossoverOperator
+	(new RingPartiallyMatchedCrossoverOperator ());
+      controller->addMutationOperator (new RingUniformMutationOperator (0.0));
+      controller->addTerminationCriterion
+	(new FixedStepTerminationCriterion (1000, 0));
+    }
+
+    /*
+     * Return the genotype hashes of a population
+     */
+    static std::multiset<quint64> getHashes (const Population* population)
+    {
+      std::multiset<quint64> hashes;
+
+      for ( Population::IndividualConstIterator i =
+	      population->getIndividualBegin ();
+	    i != population->getIndividualEnd (); ++i )
+	hashes.insert ((*i)->getHash ());
+
+      return hashes;
+    }
+
+    /*
+     * Test the restart of stagnated populations
+     */
+    static void testRestart () throw (InternalException)
+    {
+      DV ("* Testing restart");
+
+      const unsigned int max_unchanged_steps = 3;
+      const unsigned int number_of_elites = 2;
+      const unsigned int expected_sizes[] = { 15, 23, 25, 25 };
+
+      Controller controller;
+      TestPopulationCreator* creator = new TestPopulationCreator (false);
+
+      setupController (&controller, creator, 10, 0.0);
+      controller.setRestartPolicy
+	(new RestartPolicy (max_unchanged_steps, number_of_elites, 1.5, 25));
+      controller.initialize ();
+
+      //
+      // Best distinct objectives seen at the restarts, which form the
+      // elite archive. The objectives identify the genotypes.
+      //
+      std::set<double> archive;
+
+      for (unsigned int restart=0;
+	   restart < sizeof (expected_sizes) / sizeof (expected_sizes[0]);
+	   ++restart)
+	{
+	  const Population* population = *controller.getPopulationBegin ();
+	  std::set<double> elites = archive;
+
+	  for ( Population::IndividualConstIterator i =
+		  population->getIndividualBegin ();
+		i != population->getIndividualEnd (); ++i )
+	    elites.insert ((*i)->getObjective ());
+
+	  while (elites.size () > number_of_elites)
+	    elites.erase (--elites.end ());
+
+	  //
+	  // The population must not change until it is restarted
+	  //
+	  std::multiset<quint64> hashes = getHashes (population);
+	  unsigned int created = creator->getNumberOfCreated ();
+	  unsigned int steps = 0;
+
+	  while (controller.getNumberOfRestarts () == restart)
+	    {
+	      if (++steps > max_unchanged_steps + 2)
+		throw InternalException ("Stagnated population not restarted");
+
+	      if (getHashes (*controller.getPopulationBegin ()) != hashes)
+		throw InternalException ("Population changed without restart");
+
+	      controller.executeStep ();
+	    }
+
+	  //
+	  // The restarted population consists of the archived elites and
+	  // newly created individuals
+	  //
+	  population = *controller.getPopulationBegin ();
+
+	  if (population->size () != expected_sizes[restart])
+	    throw InternalException ("Wrong restarted population size");
+
+	  if (creator->getNumberOfCreated () - created !=
+	      population->size () - number_of_elites)
+	    throw InternalException ("Wrong number of created individuals");
+
+	  std::set<double> objectives;
+	  for ( Population::IndividualConstIterator i =
+		  population->getIndividualBegin ();
+		i != population->getIndividualEnd (); ++i )
+	    objectives.insert ((*i)->getObjective ());
+
+	  for ( std::set<double>::const_iterator i = elites.begin ();
+		i != elites.end (); ++i )
+	    if (objectives.find (*i) == objectives.end ())
+	      throw InternalException ("Elite missing in restarted "
+				       "population");
+
+	  archive = elites;
+	}
+    }
+
+
+    /*
+     * Test the population size control
+     */
+    static void testPopulationSize () throw (InternalException)
+    {
+      DV ("* Testing population size control");
+
+      const unsigned int min_size = 4;
+      const unsigned int max_size = 40;
+      const unsigned int max_unchanged_steps = 5;
+
+      //
+      // A collapsed population shrinks to the minimum size. All children
+      // are created by crossover, so odd sizes must pass the last parent
+      // on to keep the size.
+      //
+      {
+	const unsigned int expected_sizes[] = { 16, 12, 9, 7, 5, 4, 4 };
+
+	Controller controller;
+	setupController (&controller, new TestPopulationCreator (true), 20,
+			 1.0);
+	controller.setPopulationSizeController
+	  (new PopulationSizeController (min_size, max_size, 0.3,
+					 max_unchanged_steps));
+	controller.initialize ();
+
+	for (unsigned int i=0;
+	     i < sizeof (expected_sizes) / sizeof (expected_sizes[0]); ++i)
+	  {
+	    controller.executeStep ();
+
+	    if ((*controller.getPopulationBegin ())->size () !=
+		expected_sizes[i])
+	      throw InternalException ("Wrong size of collapsed population");
+	  }
+      }
+
+      //
+      // A diverse population without improvement grows up to the maximum
+      // size
+      //
+      {
+	Controller controller;
+	setupController (&controller, new TestPopulationCreator (false), 20,
+			 0.0);
+	controller.setPopulationSizeController
+	  (new PopulationSizeController (min_size, max_size, 0.3,
+					 max_unchanged_steps));
+	controller.initialize ();
+
+	unsigned int size = 20;
+	unsigned int unchanged_steps = 0;
+
+	for (unsigned int step=0; step < 40; ++step)
+	  {
+	    controller.executeStep ();
+
+	    unsigned int new_size =
+	      (*controller.getPopulationBegin ())->size ();
+
+	    if (new_size < size || new_size > max_size)
+	      throw InternalException ("Stagnating population size out of "
+				       "bounds");
+
+	    if (new_size == size)
+	      ++unchanged_steps;
+	    else
+	      unchanged_steps = 0;
+
+	    if (size == 20 && new_size != 20 && new_size != 25)
+	      throw InternalException ("Wrong growth factor");
+
+	    if (unchanged_steps > max_unchanged_steps + 1 && size < max_size)
+	      throw InternalException ("Stagnating population not grown");
+
+	    size = new_size;
+	  }
+
+	if (size != max_size)
+	  throw InternalException ("Maximum population size not reached");
+      }
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+  bool ok = true;
+
+  try
+  {
+    GEP::Core::testRestart ();
+    GEP::Core::testPopulationSize ();
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/*
+ * test_evaluation_cache.cpp - Tests for the evaluation caches
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#define _DEBUG
+
+#include "GEPCoreEvaluationCache.hpp"
+
+#include <GEPDebug.hpp>
+#include <GEPException.hpp>
+
+#include <iostream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+//
+// Number of entries per test
+//
+static const unsigned int NUMBER_OF_ENTRIES=5000;
+
+//
+// Number of concurrently writing processes
+//
+static const unsigned int NUMBER_OF_PROCESSES=4;
+
+//
+// Key of the tested problem instance
+//
+static const quint64 CACHE_KEY=0x0123456789abcdefULL;
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // Test functions
+    //#***********************************************************************
+
+    /*
+     * Test hash value of an entry
+     */
+    static quint64 getHash (unsigned int index)
+    {
+      return (index + 1) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    /*
+     * Test objective value of an entry
+     */
+    static double getObjective (unsigned int index)
+    {
+      return index * 0.5;
+    }
+
+    /*
+     * Check that a cache contains all entries in [begin, end)
+     */
+    static void checkEntries (const EvaluationCache* cache,
+			      unsigned int begin, unsigned int end)
+    {
+      for (unsigned int i=begin; i < end; ++i)
+	{
+	  double objective = -1.0;
+
+	  if (!cache->lookup (getHash (i), &objective))
+	    throw InternalException (QString ("Entry %1 not found").arg (i));
+
+	  if (objective != getObjective (i))
+	    throw InternalException (QString ("Entry %1 corrupted").arg (i));
+	}
+    }
+
+    /*
+     * Test the in memory cache
+     */
+    static void testMemoryCache () throw (InternalException)
+    {
+      std::cout << "*** Testing memory cache" << std::endl;
+      std::cout << std::endl;
+
+      MemoryEvaluationCache cache (NUMBER_OF_ENTRIES, 4);
+
+      for (unsigned int i=0; i < 2 * NUMBER_OF_ENTRIES; ++i)
+	cache.insert (getHash (i), getObjective (i));
+
+      if (cache.size () > NUMBER_OF_ENTRIES)
+	throw InternalException ("Cache size exceeded");
+
+      checkEntries (&cache, 2 * NUMBER_OF_ENTRIES - 100, 2 * NUMBER_OF_ENTRIES);
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+    /*
+     * Test the persistent cache
+     */
+    static void testPersistentCache () throw (InternalException)
+    {
+      std::cout << "*** Testing persistent cache" << std::endl;
+      std::cout << std::endl;
+
+      char directory[] = "/tmp/gep_cache_XXXXXX";
+      if (mkdtemp (directory) == 0)
+	throw InternalException ("Cannot create test directory");
+
+      QString path = QString ("%1/cache").arg (QString (directory));
+
+      {
+	std::cout << "* Growing index" << std::endl;
+
+	PersistentEvaluationCache writer (path, CACHE_KEY, 16);
+	PersistentEvaluationCache reader (path, CACHE_KEY, 16);
+
+	for (unsigned int i=0; i < NUMBER_OF_ENTRIES; ++i)
+	  writer.insert (getHash (i), getObjective (i));
+
+	checkEntries (&reader, 0, NUMBER_OF_ENTRIES);
+
+	if (reader.size () != NUMBER_OF_ENTRIES)
+	  throw InternalException ("Wrong cache size");
+      }
+
+      {
+	std::cout << "* Concurrent processes" << std::endl;
+
+	std::vector<pid_t> children;
+
+	for (unsigned int p=0; p < NUMBER_OF_PROCESSES; ++p)
+	  {
+	    pid_t pid = fork ();
+	    if (pid == 0)
+	      {
+		//
+		// Overlapping ranges, so the same entries are inserted by
+		// several processes concurrently
+		//
+		PersistentEvaluationCache cache (path, CACHE_KEY);
+		unsigned int begin = NUMBER_OF_ENTRIES / 2 * (p + 1);
+
+		for (unsigned int i=begin; i < begin + NUMBER_OF_ENTRIES; ++i)
+		  cache.insert (getHash (i), getObjective (i));
+
+		_exit (0);
+	      }
+
+	    children.push_back (pid);
+	  }
+
+	bool ok = true;
+	for (unsigned int i=0; i < children.size (); ++i)
+	  {
+	    int status = 0;
+	    waitpid (children[i], &status, 0);
+	    ok = ok && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+	  }
+
+	if (!ok)
+	  throw InternalException ("Writing process failed");
+
+	unsigned int end = NUMBER_OF_ENTRIES / 2 * (NUMBER_OF_PROCESSES + 2);
+
+	PersistentEvaluationCache cache (path, CACHE_KEY);
+	checkEntries (&cache, 0, end);
+
+	if (cache.size () != end)
+	  throw InternalException ("Duplicate or missing entries");
+      }
+
+      {
+	std::cout << "* Recovery from log" << std::endl;
+
+	QString index_path = path + ".idx";
+	QString log_path = path + ".log";
+
+	unlink (qPrintable (index_path));
+	if (truncate (qPrintable (log_path), 101 * 24 + 5) != 0)
+	  throw InternalException ("Cannot truncate log");
+
+	PersistentEvaluationCache cache (path, CACHE_KEY);
+	checkEntries (&cache, 0, 100);
+
+	if (cache.size () != 100)
+	  throw InternalException ("Wrong recovered cache size");
+
+	cache.clear ();
+	if (cache.size () != 0)
+	  throw InternalException ("Cache not cleared");
+      }
+
+      {
+	std::cout << "* Key mismatch" << std::endl;
+
+	//
+	// The cleared cache keeps its key
+	//
+	bool refused = false;
+
+	try
+	  {
+	    PersistentEvaluationCache cache (path, CACHE_KEY + 1);
+	  }
+	catch (const InternalException&)
+	  {
+	    refused = true;
+	  }
+
+	if (!refused)
+	  throw InternalException ("Cache with another key not refused");
+
+	//
+	// An index with another key is rebuilt from the new log
+	//
+	{
+	  PersistentEvaluationCache cache (path, CACHE_KEY);
+	  cache.insert (getHash (0), getObjective (0));
+	}
+
+	unlink (qPrintable (path + ".log"));
+
+	{
+	  PersistentEvaluationCache cache (path, CACHE_KEY + 1);
+	  if (cache.size () != 0)
+	    throw InternalException ("Index with another key used");
+	}
+      }
+
+      const char* suffixes[] = { ".log", ".idx", ".lock" };
+      for (unsigned int i=0; i < 3; ++i)
+	unlink (qPrintable (path + suffixes[i]));
+      rmdir (directory);
+
+      std::cout << std::endl;
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+  bool ok = true;
+
+  try
+  {
+    GEP::Core::testMemoryCache ();
+    GEP::Core::testPersistentCache ();
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
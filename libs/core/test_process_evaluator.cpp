@@ -0,0 +1,330 @@
+/*
+ * test_process_evaluator.cpp - Tests for the process based evaluator
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#define _DEBUG
+
+#include "GEPCoreProcessEvaluator.hpp"
+#include "GEPCoreRingIndividual.hpp"
+
+#include <GEPDebug.hpp>
+#include <GEPException.hpp>
+#include <GEPRandom.hpp>
+
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//
+// Number of individuals per test evaluation
+//
+static const unsigned int NUMBER_OF_INDIVIDUALS=200;
+
+//
+// Number of genes per individual
+//
+static const unsigned int NUMBER_OF_GENES=20;
+
+namespace GEP {
+  namespace Core {
+
+    //#***********************************************************************
+    // CLASS GEP::Core::TestRingIndividual
+    //#***********************************************************************
+
+    class TestRingIndividual : public GEP::Core::RingIndividual
+    {
+    public:
+      TestRingIndividual ();
+      TestRingIndividual (const TestRingIndividual& toCopy);
+      virtual ~TestRingIndividual ();
+
+      virtual Individual* clone () const;
+    };
+
+    TestRingIndividual::TestRingIndividual ()
+      : RingIndividual ()
+    {
+    }
+
+    TestRingIndividual::TestRingIndividual (const TestRingIndividual& toCopy)
+      : RingIndividual (toCopy)
+    {
+    }
+
+    TestRingIndividual::~TestRingIndividual ()
+    {
+    }
+
+    Individual* TestRingIndividual::clone () const
+    {
+      return new TestRingIndividual (*this);
+    }
+
+
+    //#***********************************************************************
+    // Worker process
+    //#***********************************************************************
+
+    /*
+     * Objective computed by the worker
+     */
+    static double computeObjective (const std::vector<quint32>& genes)
+    {
+      double objective = 0.0;
+      for (unsigned int i=0; i < genes.size (); ++i)
+	objective += (i + 1) * genes[i];
+
+      return objective;
+    }
+
+    /*
+     * Read exactly 'size' bytes from stdin
+     */
+    static bool readFully (void* data, unsigned int size)
+    {
+      char* pos = static_cast<char*> (data);
+
+      while (size > 0)
+	{
+	  ssize_t n = read (STDIN_FILENO, pos, size);
+	  if (n <= 0)
+	    return false;
+
+	  pos += n;
+	  size -= n;
+	}
+
+      return true;
+    }
+
+    /*
+     * Write exactly 'size' bytes to stdout
+     */
+    static bool writeFully (const void* data, unsigned int size)
+    {
+      const char* pos = static_cast<const char*> (data);
+
+      while (size > 0)
+	{
+	  ssize_t n = write (STDOUT_FILENO, pos, size);
+	  if (n <= 0)
+	    return false;
+
+	  pos += n;
+	  size -= n;
+	}
+
+      return true;
+    }
+
+    /*
+     * Worker main loop
+     *
+     * In the 'crash' and 'hang' modes, the worker randomly exits or stops
+     * responding after receiving a request.
+     */
+    static int runWorker (const QString& mode)
+    {
+      srand (getpid ());
+
+      for (;;)
+	{
+	  char magic[4];
+	  quint32 id, count;
+
+	  if (!readFully (magic, sizeof (magic)))
+	    return 0;
+
+	  if (memcmp (magic, "GEPQ", 4) != 0 ||
+	      !readFully (&id, sizeof (id)) ||
+	      !readFully (&count, sizeof (count)))
+	    return 1;
+
+	  std::vector<double> objectives;
+
+	  for (unsigned int i=0; i < count; ++i)
+	    {
+	      quint32 length, size;
+	      if (!readFully (&length, sizeof (length)) ||
+		  !readFully (&size, sizeof (size)) ||
+		  length != (size + 1) * sizeof (quint32))
+		return 1;
+
+	      std::vector<quint32> genes (size);
+	      if (size > 0 && !readFully (&genes[0], size * sizeof (quint32)))
+		return 1;
+
+	      objectives.push_back (computeObjective (genes));
+	    }
+
+	  if (rand () % 10 < 3)
+	    {
+	      if (mode == "crash")
+		return 2;
+	      if (mode == "hang")
+		for (;;)
+		  pause ();
+	    }
+
+	  if (!writeFully ("GEPR", 4) ||
+	      !writeFully (&id, sizeof (id)) ||
+	      !writeFully (&count, sizeof (count)) ||
+	      !writeFully (&objectives[0], count * sizeof (double)))
+	    return 1;
+	}
+    }
+
+
+    //#***********************************************************************
+    // Test functions
+    //#***********************************************************************
+
+    /*
+     * Evaluate random individuals and compare the objectives
+     */
+    static void testEvaluation (ProcessEvaluator* evaluator,
+				unsigned int number_of_individuals)
+    {
+      Random random;
+
+      std::vector<Individual*> individuals;
+      std::vector<double> expected;
+
+      for (unsigned int i=0; i < number_of_individuals; ++i)
+	{
+	  RingIndividual::Chromosome chromosome;
+	  std::vector<quint32> genes;
+
+	  for (unsigned int j=0; j < NUMBER_OF_GENES; ++j)
+	    {
+	      chromosome.push_back (random.getInt (0, 1000));
+	      genes.push_back (chromosome.back ());
+	    }
+
+	  TestRingIndividual* individual = new TestRingIndividual ();
+	  individual->setChromosome (chromosome);
+
+	  individuals.push_back (individual);
+	  expected.push_back (computeObjective (genes));
+	}
+
+      bool ok = true;
+
+      try
+	{
+	  evaluator->evaluate (individuals);
+
+	  for (unsigned int i=0; i < individuals.size (); ++i)
+	    if (!individuals[i]->hasObjective () ||
+		individuals[i]->getObjective () != expected[i])
+	      ok = false;
+	}
+      catch (...)
+	{
+	  for (unsigned int i=0; i < individuals.size (); ++i)
+	    delete individuals[i];
+	  throw;
+	}
+
+      for (unsigned int i=0; i < individuals.size (); ++i)
+	delete individuals[i];
+
+      if (!ok)
+	throw InternalException ("Wrong objective returned");
+    }
+
+    /*
+     * Test the evaluator with regular, crashing and hanging workers
+     */
+    static void testProcessEvaluator (const QString& program)
+      throw (InternalException)
+    {
+      std::cout << "*** Testing process evaluator" << std::endl;
+      std::cout << std::endl;
+
+      {
+	std::cout << "* Regular workers" << std::endl;
+
+	ProcessEvaluator evaluator (program + " --worker", new RingGenomeEncoder,
+				    4, 7, 3, 10000, 3);
+	testEvaluation (&evaluator, NUMBER_OF_INDIVIDUALS);
+	testEvaluation (&evaluator, 1);
+	testEvaluation (&evaluator, 0);
+
+	if (evaluator.getNumberOfRestarts () != 0)
+	  throw InternalException ("Unexpected worker restart");
+      }
+
+      {
+	std::cout << "* Crashing workers" << std::endl;
+
+	ProcessEvaluator evaluator (program + " --worker crash",
+				    new RingGenomeEncoder, 4, 7, 3, 10000, 20);
+	testEvaluation (&evaluator, NUMBER_OF_INDIVIDUALS);
+
+	if (evaluator.getNumberOfRestarts () == 0)
+	  throw InternalException ("Crashed workers not restarted");
+      }
+
+      {
+	std::cout << "* Hanging workers" << std::endl;
+
+	ProcessEvaluator evaluator (program + " --worker hang",
+				    new RingGenomeEncoder, 4, 10, 1, 200, 20);
+	testEvaluation (&evaluator, 40);
+      }
+
+      {
+	std::cout << "* Failing workers" << std::endl;
+
+	ProcessEvaluator evaluator ("exit 1", new RingGenomeEncoder,
+				    2, 10, 2, 10000, 2);
+	bool failed = false;
+
+	try
+	  {
+	    testEvaluation (&evaluator, 40);
+	  }
+	catch (const InternalException&)
+	  {
+	    failed = true;
+	  }
+
+	if (!failed)
+	  throw InternalException ("Worker failure not reported");
+      }
+
+      std::cout << std::endl;
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+  } // namespace Core
+} // namespace GEP
+
+
+int main (int argc, char** argv)
+{
+  if (argc > 1 && QString (argv[1]) == "--worker")
+    return GEP::Core::runWorker (argc > 2 ? argv[2] : "");
+
+  bool ok = true;
+
+  try
+  {
+    GEP::Core::testProcessEvaluator (argv[0]);
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -6,6 +6,8 @@
 
 #define _DEBUG
 
+#include "GEPCoreEvaluationCache.hpp"
+#include "GEPCoreNeighbourhood.hpp"
 #include "GEPCoreRingIndividual.hpp"
 #include "GEPCorePopulation.hpp"
 
@@ -13,8 +15,12 @@
 #include <GEPException.hpp>
 #include <GEPRandom.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <set>
+#include <math.h>
+#include <stdlib.h>
 
 //
 // Size of the test chromosome
@@ -85,6 +91,72 @@ namespace GEP {
     }
     
     
+    //#***********************************************************************
+    // CLASS GEP::Core::TestNeighbourhood
+    //#***********************************************************************
+
+    /*
+     * Genes placed evenly on a circle, so the best round trip visits them
+     * in ascending order
+     */
+    class TestNeighbourhood : public GEP::Core::Neighbourhood
+    {
+    public:
+      TestNeighbourhood ();
+      virtual ~TestNeighbourhood ();
+
+      virtual unsigned int getNumberOfGenes () const;
+      virtual unsigned int getNumberOfNeighbours () const;
+      virtual const unsigned int* getNeighbours (unsigned int gene) const;
+
+      virtual double getCost (unsigned int gene_1, unsigned int gene_2) const;
+
+    private:
+      std::vector<unsigned int> _neighbours;
+    };
+
+    TestNeighbourhood::TestNeighbourhood ()
+      : Neighbourhood ()
+    {
+      for (unsigned int i=0; i < CHROMOSOME_SIZE; ++i)
+	for (unsigned int j=1; j < CHROMOSOME_SIZE; ++j)
+	  {
+	    unsigned int offset = (j + 1) / 2;
+	    _neighbours.push_back (j % 2 == 1 ?
+				   (i + offset) % CHROMOSOME_SIZE :
+				   (i + CHROMOSOME_SIZE - offset) %
+				   CHROMOSOME_SIZE);
+	  }
+    }
+
+    TestNeighbourhood::~TestNeighbourhood ()
+    {
+    }
+
+    unsigned int TestNeighbourhood::getNumberOfGenes () const
+    {
+      return CHROMOSOME_SIZE;
+    }
+
+    unsigned int TestNeighbourhood::getNumberOfNeighbours () const
+    {
+      return CHROMOSOME_SIZE - 1;
+    }
+
+    const unsigned int* TestNeighbourhood::getNeighbours (unsigned int gene)
+      const
+    {
+      return &_neighbours[gene * (CHROMOSOME_SIZE - 1)];
+    }
+
+    double TestNeighbourhood::getCost (unsigned int gene_1,
+				       unsigned int gene_2) const
+    {
+      int offset = static_cast<int> (gene_1) - static_cast<int> (gene_2);
+      return 2.0 * sin (M_PI * abs (offset) / CHROMOSOME_SIZE);
+    }
+    
+    
     //#***********************************************************************
     // Test functions
     //#***********************************************************************
@@ -129,6 +201,8 @@ namespace GEP {
      */
     static void setRandomChromosome (RingIndividual* individual)
     {
+      Random random;
+
       std::vector<RingIndividual::Gene> genes;
       for (unsigned int i=0; i < CHROMOSOME_SIZE; ++i)
 	genes.push_back (i);
@@ -136,7 +210,7 @@ namespace GEP {
       RingIndividual::Chromosome chromosome (CHROMOSOME_SIZE);
       for (unsigned int i=0; i < CHROMOSOME_SIZE; ++i)
       {
-	unsigned int index = Random::getInt (0, genes.size () - 1);
+	unsigned int index = random.getInt (0, genes.size () - 1);
 	chromosome[i] = genes[index];
 
 	for (unsigned int j=index + 1; j < genes.size (); ++j)
@@ -218,20 +292,64 @@ namespace GEP {
     {
       DV ("* Testing crossover");
       
-      testCrossoverOperator (RingPartiallyMatchedCrossoverOperator (1.0));
-      testCrossoverOperator (RingResortingCrossoverOperator (1.0));
+      testCrossoverOperator (RingPartiallyMatchedCrossoverOperator ());
+      testCrossoverOperator (RingResortingCrossoverOperator ());
+      testCrossoverOperator (RingOrderCrossoverOperator ());
+      testCrossoverOperator (RingOrderBasedCrossoverOperator ());
+      testCrossoverOperator (RingCycleCrossoverOperator ());
+      testCrossoverOperator (RingEdgeRecombinationCrossoverOperator ());
+
+      //
+      // Cycle crossover keeps every gene at a position of one parent, edge
+      // recombination reproduces identical parents
+      //
+      for (unsigned int i=0; i < 100; ++i)
+	{
+	  TestIndividual ring1;
+	  TestIndividual ring2;
+
+	  setRandomChromosome (&ring1);
+	  setRandomChromosome (&ring2);
+
+	  CrossoverResult result =
+	    executeCrossover (RingCycleCrossoverOperator (), &ring1, &ring2);
+	  std::auto_ptr<TestIndividual> result_1 (result.first);
+	  std::auto_ptr<TestIndividual> result_2 (result.second);
+
+	  for (unsigned int j=0; j < CHROMOSOME_SIZE; ++j)
+	    {
+	      RingIndividual::Gene gene_1 = ring1.getChromosome ()[j];
+	      RingIndividual::Gene gene_2 = ring2.getChromosome ()[j];
+	      RingIndividual::Gene child_1 = result_1->getChromosome ()[j];
+	      RingIndividual::Gene child_2 = result_2->getChromosome ()[j];
+
+	      if ((child_1 != gene_1 || child_2 != gene_2) &&
+		  (child_1 != gene_2 || child_2 != gene_1))
+		throw InternalException ("Cycle crossover moved a gene");
+	    }
+
+	  result = executeCrossover (RingEdgeRecombinationCrossoverOperator (),
+				     &ring1, &ring1);
+	  result_1.reset (result.first);
+	  result_2.reset (result.second);
+
+	  if (RingIndividual::computeHash (result_1->getChromosome ()) !=
+	      RingIndividual::computeHash (ring1.getChromosome ()) ||
+	      RingIndividual::computeHash (result_2->getChromosome ()) !=
+	      RingIndividual::computeHash (ring1.getChromosome ()))
+	    throw InternalException ("Edge recombination changed the tour");
+	}
     }
     
 
     /*
      * Test mutation operator
      */
-    static void testMutation () throw (InternalException)
+    static void testMutationOperator (const MutationOperator& mutation_operator)
+      throw (InternalException)
     {
-      DV ("* Testing mutation");
+      DV ("* Testing mutation: " << mutation_operator.getDescription ());
 
-      RingUniformMutationOperator mutation_operator (1.0 / CHROMOSOME_SIZE);
-      
       for (unsigned int i=0; i < 100; ++i)
       {
 	DV ("- Run " << i);
@@ -250,11 +368,605 @@ namespace GEP {
 	  
 	  checkChromosome (*result.get ());
 	  ring.setChromosome (result->getChromosome ());
+	  ring.setMutationRate (std::max (0.0, result->getMutationRate ()));
 
 	  DV ("  ring=" << Debug::toString (ring.getChromosome ()));
 	}
       }
     }
+
+    /*
+     * Test mutation operators
+     */
+    static void testMutation () throw (InternalException)
+    {
+      DV ("* Testing mutation");
+
+      testMutationOperator
+	(RingUniformMutationOperator (1.0 / CHROMOSOME_SIZE));
+      testMutationOperator (RingUniformMutationOperator (1.0));
+      testMutationOperator (RingInversionMutationOperator (1.0));
+      testMutationOperator (RingDisplacementMutationOperator (1.0));
+      testMutationOperator (RingDisplacementMutationOperator (0.5, 4, 2));
+      testMutationOperator (RingScrambleMutationOperator (1.0, 4));
+
+      //
+      // The number of swaps of uniform mutation must match the probability
+      //
+      {
+	const unsigned int size = 1000;
+	const unsigned int runs = 200;
+
+	RingIndividual::Chromosome chromosome (size);
+	for (unsigned int i=0; i < size; ++i)
+	  chromosome[i] = i;
+
+	TestIndividual ring;
+	ring.setChromosome (chromosome);
+
+	RingUniformMutationOperator uniform (10.0 / size);
+	unsigned int changed = 0;
+
+	for (unsigned int i=0; i < runs; ++i)
+	  {
+	    std::auto_ptr<RingIndividual> result
+	      (dynamic_cast<RingIndividual*> (uniform.mutate (&ring)));
+
+	    for (unsigned int j=0; j < size; ++j)
+	      if (result->getChromosome ()[j] != j)
+		++changed;
+	  }
+
+	//
+	// About 10 swaps moving 2 genes each, minus a few overlapping ones
+	//
+	double average = static_cast<double> (changed) / runs;
+	if (average < 16.0 || average > 23.0)
+	  throw InternalException ("Wrong uniform mutation rate");
+      }
+
+      testMutationOperator
+	(RingSuccessRuleMutationOperator (1.0 / CHROMOSOME_SIZE,
+					  0.1 / CHROMOSOME_SIZE,
+					  5.0 / CHROMOSOME_SIZE));
+
+      //
+      // Self adaptive mutation must keep the individual rates in bounds
+      //
+      double min_rate = 0.1 / CHROMOSOME_SIZE;
+      double max_rate = 5.0 / CHROMOSOME_SIZE;
+
+      RingSelfAdaptiveMutationOperator self_adaptive
+	(1.0 / CHROMOSOME_SIZE, min_rate, max_rate);
+      testMutationOperator (self_adaptive);
+
+      TestIndividual ring;
+      setRandomChromosome (&ring);
+
+      for (unsigned int i=0; i < 1000; ++i)
+	{
+	  std::auto_ptr<Individual> result (self_adaptive.mutate (&ring));
+	  double rate = result->getMutationRate ();
+
+	  if (rate < min_rate || rate > max_rate)
+	    throw InternalException ("Self adaptive mutation rate out of "
+				     "bounds");
+
+	  ring.setMutationRate (rate);
+	}
+      }
+
+
+    /*
+     * Add evaluated offspring differing from their parent to a population
+     *
+     * \param mutation_operator Operator creating the offspring
+     * \param population        Population receiving the offspring
+     * \param number            Number of offspring
+     * \param improved          Number of offspring better than their parent
+     */
+    static void addOffspring (const MutationOperator& mutation_operator,
+			      Population* population, unsigned int number,
+			      unsigned int improved)
+    {
+      TestIndividual ring;
+      setRandomChromosome (&ring);
+      ring.setObjective (100.0);
+
+      for (unsigned int i=0; i < number; )
+	{
+	  std::auto_ptr<RingIndividual> offspring
+	    (dynamic_cast<RingIndividual*> (mutation_operator.mutate (&ring)));
+
+	  if (offspring->getChromosome () != ring.getChromosome ())
+	    {
+	      offspring->setObjective (i < improved ? 90.0 : 110.0);
+	      population->addIndividual (offspring.release (), true);
+	      ++i;
+	    }
+	}
+    }
+
+    /*
+     * Check the adaptation of the success rule mutation after a step
+     */
+    static void checkSuccessRule
+    (RingSuccessRuleMutationOperator* success_rule, unsigned int improved_1,
+     unsigned int improved_2, double expected)
+      throw (InternalException)
+    {
+      TestPopulation population_1;
+      TestPopulation population_2;
+
+      addOffspring (*success_rule, &population_1, 10, improved_1);
+      addOffspring (*success_rule, &population_2, 10, improved_2);
+
+      //
+      // Unchanged copies and offspring of other operators are no trials
+      //
+      TestIndividual ring;
+      setRandomChromosome (&ring);
+      ring.setObjective (100.0);
+
+      Individual* copy = ring.clone ();
+      copy->setObjective (90.0);
+      population_1.addIndividual (copy, true);
+
+      addOffspring (RingInversionMutationOperator (1.0), &population_2,
+		    10, 10);
+
+      std::vector<const Population*> populations;
+      populations.push_back (&population_1);
+      populations.push_back (&population_2);
+
+      success_rule->update (populations);
+
+      if (fabs (success_rule->getMutationProbability () - expected) > 1e-12)
+	throw InternalException ("Wrong success rule adaptation");
+    }
+
+    /*
+     * Test the adaptation of the success rule mutation
+     */
+    static void testSuccessRule () throw (InternalException)
+    {
+      DV ("* Testing success rule mutation");
+
+      const double min_probability = 0.02;
+      const double max_probability = 0.5;
+      const double factor = 0.5;
+
+      RingSuccessRuleMutationOperator success_rule
+	(0.1, min_probability, max_probability, factor);
+
+      //
+      // A high success rate over all populations raises the probability,
+      // once per step
+      //
+      checkSuccessRule (&success_rule, 2, 6, 0.2);
+
+      //
+      // A success rate of a fifth keeps it, a lower one lowers it
+      //
+      checkSuccessRule (&success_rule, 2, 2, 0.2);
+      checkSuccessRule (&success_rule, 1, 2, 0.1);
+
+      //
+      // The probability stays within its bounds
+      //
+      checkSuccessRule (&success_rule, 10, 10, 0.2);
+      checkSuccessRule (&success_rule, 10, 10, 0.4);
+      checkSuccessRule (&success_rule, 10, 10, max_probability);
+      checkSuccessRule (&success_rule, 10, 10, max_probability);
+
+      for (unsigned int i=0; i < 10; ++i)
+	checkSuccessRule (&success_rule, 0, 0,
+			  std::max (max_probability * pow (factor, i + 1.0),
+				    min_probability));
+    }
+
+
+    /*
+     * Compute the average pairwise edge distance of a population directly
+     */
+    static double computeAverageDistance (const Population& population)
+    {
+      typedef std::set< std::pair<RingIndividual::Gene, RingIndividual::Gene> >
+	EdgeSet;
+
+      std::vector<EdgeSet> edges;
+      for ( Population::IndividualConstIterator i =
+	      population.getIndividualBegin ();
+	    i != population.getIndividualEnd (); ++i )
+      {
+	const RingIndividual::Chromosome& chromosome =
+	  dynamic_cast<const RingIndividual*> (*i)->getChromosome ();
+
+	EdgeSet edge_set;
+	for (unsigned int j=0; j < chromosome.size (); ++j)
+	{
+	  RingIndividual::Gene a = chromosome[j];
+	  RingIndividual::Gene b = chromosome[(j + 1) % chromosome.size ()];
+	  edge_set.insert (std::make_pair (std::min (a, b), std::max (a, b)));
+	}
+
+	edges.push_back (edge_set);
+      }
+
+      double distance = 0.0;
+      unsigned int pairs = 0;
+
+      for (unsigned int i=0; i < edges.size (); ++i)
+	for (unsigned int j=i + 1; j < edges.size (); ++j, ++pairs)
+	{
+	  unsigned int shared = 0;
+	  for (EdgeSet::const_iterator k = edges[i].begin ();
+	       k != edges[i].end (); ++k)
+	    shared += edges[j].count (*k);
+
+	  distance += 1.0 - static_cast<double> (shared) / CHROMOSOME_SIZE;
+	}
+
+      return pairs > 0 ? distance / pairs : 0.0;
+    }
+
+    /*
+     * Test the change log and the hash update of segment mutations
+     *
+     * Restoring the former genes of the logged changes in reverse order must
+     * yield the chromosome the parent objective belongs to.
+     */
+    static void testChangeLog () throw (InternalException)
+    {
+      DV ("* Testing change log");
+
+      const MutationOperator* operators[] = {
+	new RingInversionMutationOperator (1.0),
+	new RingDisplacementMutationOperator (1.0, 3),
+	new RingScrambleMutationOperator (1.0, 5)
+      };
+
+      Random random;
+
+      for (unsigned int run=0; run < 1000; ++run)
+	{
+	  TestIndividual parent;
+	  setRandomChromosome (&parent);
+	  parent.setObjective (1.0);
+
+	  std::auto_ptr<Individual> current (parent.clone ());
+	  unsigned int steps = random.getInt (1, 3);
+
+	  for (unsigned int i=0; i < steps; ++i)
+	    {
+	      unsigned int choice = random.getInt (0, 3);
+
+	      if (choice < 3)
+		{
+		  current.reset (operators[choice]->mutate (current.get ()));
+		  continue;
+		}
+
+	      //
+	      // Swapping two genes via a new chromosome is logged, too
+	      //
+	      RingIndividual* swapped =
+		dynamic_cast<RingIndividual*> (current.get ());
+	      RingIndividual::Chromosome chromosome = swapped->getChromosome ();
+
+	      std::swap (chromosome[random.getInt (0, CHROMOSOME_SIZE - 1)],
+			 chromosome[random.getInt (0, CHROMOSOME_SIZE - 1)]);
+	      swapped->setChromosome (chromosome);
+	    }
+
+	  const RingIndividual* ring =
+	    dynamic_cast<const RingIndividual*> (current.get ());
+
+	  if (ring->getHash () != RingIndividual::computeHash
+	      (ring->getChromosome ()))
+	    throw InternalException ("Hash not updated correctly");
+
+	  if (ring->getChromosome () == parent.getChromosome ())
+	    continue;
+
+	  if (!ring->hasChangeLog () || ring->hasObjective () ||
+	      ring->getParentObjective () != 1.0)
+	    throw InternalException ("Change log not started");
+
+	  RingIndividual::Chromosome chromosome = ring->getChromosome ();
+	  const RingIndividual::ChangeLog& log = ring->getChangeLog ();
+
+	  for (unsigned int i=log.size (); i > 0; --i)
+	    {
+	      const RingIndividual::Change& change = log[i - 1];
+
+	      for (unsigned int j=0; j < change.length; ++j)
+		chromosome[(change.position + j) % CHROMOSOME_SIZE] =
+		  ring->getFormerGenes ()[change.offset + j];
+	    }
+
+	  if (chromosome != parent.getChromosome ())
+	    throw InternalException ("Change log incomplete");
+	}
+
+      for (unsigned int i=0; i < 3; ++i)
+	delete operators[i];
+    }
+
+    /*
+     * Compute the cost of a round trip or an open path
+     */
+    static double computeCost (const Neighbourhood& neighbourhood,
+			       const RingIndividual::Chromosome& chromosome,
+			       bool round_trip)
+    {
+      double cost = round_trip ?
+	neighbourhood.getCost (chromosome.back (), chromosome.front ()) : 0.0;
+
+      for (unsigned int i=1; i < chromosome.size (); ++i)
+	cost += neighbourhood.getCost (chromosome[i - 1], chromosome[i]);
+
+      return cost;
+    }
+
+    /*
+     * Test local search operator
+     */
+    static void testLocalSearch () throw (InternalException)
+    {
+      DV ("* Testing local search");
+
+      TestNeighbourhood neighbourhood;
+      double optimum = 0.0;
+      for (unsigned int i=0; i < CHROMOSOME_SIZE; ++i)
+	optimum += neighbourhood.getCost (i, (i + 1) % CHROMOSOME_SIZE);
+
+      for (unsigned int round_trip=0; round_trip < 2; ++round_trip)
+	{
+	  RingLocalSearchMutationOperator search
+	    (&neighbourhood, 1.0, 1000, round_trip == 1);
+	  RingLocalSearchMutationOperator single_move
+	    (&neighbourhood, 1.0, 1, round_trip == 1);
+
+	  for (unsigned int run=0; run < 100; ++run)
+	    {
+	      TestIndividual ring;
+	      setRandomChromosome (&ring);
+
+	      double cost = computeCost (neighbourhood, ring.getChromosome (),
+					 round_trip == 1);
+
+	      //
+	      // A single move must improve the chromosome, if at all
+	      //
+	      std::auto_ptr<Individual> moved (single_move.mutate (&ring));
+	      const RingIndividual* moved_ring =
+		dynamic_cast<const RingIndividual*> (moved.get ());
+
+	      checkChromosome (*moved_ring);
+	      if (moved_ring->getChromosome () != ring.getChromosome () &&
+		  computeCost (neighbourhood, moved_ring->getChromosome (),
+			       round_trip == 1) > cost - 1e-9)
+		throw InternalException ("Local search move not improving");
+
+	      //
+	      // Without any improving move left, a round trip on the circle
+	      // must be optimal
+	      //
+	      for (unsigned int i=0; i < 100; ++i)
+		{
+		  std::auto_ptr<Individual> result (search.mutate (&ring));
+		  const RingIndividual* result_ring =
+		    dynamic_cast<const RingIndividual*> (result.get ());
+
+		  checkChromosome (*result_ring);
+		  if (result_ring->getChromosome () == ring.getChromosome ())
+		    break;
+
+		  ring.setChromosome (result_ring->getChromosome ());
+		}
+
+	      double result_cost = computeCost
+		(neighbourhood, ring.getChromosome (), round_trip == 1);
+
+	      if (result_cost > cost + 1e-9)
+		throw InternalException ("Local search increased cost");
+
+	      if (round_trip == 1 && fabs (result_cost - optimum) > 1e-9)
+		throw InternalException ("Local search missed optimum");
+	    }
+	}
+    }
+
+    /*
+     * Test incremental diversity metrics
+     */
+    static void testDiversity () throw (InternalException)
+    {
+      DV ("* Testing diversity metrics");
+
+      TestPopulation population;
+      population.setDiversityMetrics (new RingDiversityMetrics ());
+      const DiversityMetrics* metrics = population.getDiversityMetrics ();
+
+      //
+      // Identical individuals form a single genotype without diversity
+      //
+      TestIndividual ring;
+      setRandomChromosome (&ring);
+
+      for (unsigned int i=0; i < 10; ++i)
+	population.addIndividual (ring.clone ());
+
+      if (metrics->getNumberOfGenotypes () != 1)
+	throw InternalException ("Identical individuals not detected");
+
+      if (fabs (metrics->getAverageDistance ()) > 1e-9 ||
+	  fabs (metrics->getEntropy ()) > 1e-9)
+	throw InternalException ("Identical individuals must not be diverse");
+
+      //
+      // Random additions and removals must match the direct computation
+      //
+      Random random;
+
+      for (unsigned int i=0; i < 200; ++i)
+      {
+	if (population.size () > 2 && random.getInt (0, 2) == 0)
+	  delete population.takeIndividual
+	    (random.getInt (0, population.size () - 1));
+	else
+	{
+	  TestIndividual* individual = new TestIndividual ();
+	  setRandomChromosome (individual);
+	  population.addIndividual (individual);
+	}
+
+	double expected = computeAverageDistance (population);
+	if (fabs (metrics->getAverageDistance () - expected) > 1e-9)
+	  throw InternalException ("Average distance mismatch");
+
+	if (metrics->size () != population.size ())
+	  throw InternalException ("Metrics size mismatch");
+
+	double entropy = metrics->getEntropy ();
+	if (entropy < -1e-9 || entropy > 1.0 + 1e-9)
+	  throw InternalException ("Entropy out of range");
+      }
+    }
+
+
+    /*
+     * Test genotype hashing, evaluation cache and duplicate rejection
+     */
+    static void testHashing () throw (InternalException)
+    {
+      DV ("* Testing genotype hashing");
+
+      TestIndividual ring;
+      setRandomChromosome (&ring);
+
+      //
+      // Rotated and reversed rings describe the same tour
+      //
+      RingIndividual::Chromosome chromosome = ring.getChromosome ();
+      std::rotate (chromosome.begin (), chromosome.begin () + 3,
+		   chromosome.end ());
+      std::reverse (chromosome.begin (), chromosome.end ());
+
+      TestIndividual equivalent;
+      equivalent.setChromosome (chromosome);
+
+      if (equivalent.getHash () != ring.getHash () || ring.getHash () == 0)
+	throw InternalException ("Equivalent rings have different hashes");
+
+      std::swap (chromosome[0], chromosome[4]);
+      equivalent.setChromosome (chromosome);
+
+      if (equivalent.getHash () == ring.getHash ())
+	throw InternalException ("Different rings have the same hash");
+
+      //
+      // Changing the chromosome invalidates the objective
+      //
+      ring.setObjective (1.0);
+      equivalent = ring;
+      equivalent.setChromosome (chromosome);
+
+      if (!ring.hasObjective () || equivalent.hasObjective ())
+	throw InternalException ("Objective not invalidated");
+
+      //
+      // Duplicate rejection
+      //
+      TestPopulation population;
+      population.setRejectDuplicates (true);
+
+      if (!population.addIndividual (ring.clone ()) ||
+	  !population.addIndividual (equivalent.clone ()))
+	throw InternalException ("Unique individual rejected");
+
+      if (population.addIndividual (ring.clone ()))
+	throw InternalException ("Duplicate individual accepted");
+
+      delete population.takeIndividual (0);
+      delete population.takeIndividual (0);
+
+      if (!population.addIndividual (ring.clone ()))
+	throw InternalException ("Removed individual still accounted for");
+
+      //
+      // Bounded evaluation cache
+      //
+      MemoryEvaluationCache cache (64, 4);
+
+      for (unsigned int i=1; i <= 1000; ++i)
+	cache.insert (i * 0x9e3779b97f4a7c15ULL, i);
+
+      double objective = 0.0;
+      if (cache.size () > 64)
+	throw InternalException ("Evaluation cache exceeds its size");
+
+      if (!cache.lookup (1000 * 0x9e3779b97f4a7c15ULL, &objective) ||
+	  objective != 1000.0)
+	throw InternalException ("Recent cache entry not found");
+
+      if (cache.lookup (1 * 0x9e3779b97f4a7c15ULL, &objective))
+	throw InternalException ("Oldest cache entry not evicted");
+
+      if (cache.getNumberOfHits () != 1 || cache.getNumberOfMisses () != 1)
+	throw InternalException ("Cache statistics mismatch");
+    }
+
+
+    /*
+     * Test the edge based surrogate model on an additive objective
+     */
+    static void testSurrogate () throw (InternalException)
+    {
+      DV ("* Testing surrogate model");
+
+      Random random;
+
+      std::vector<double> edge_costs (CHROMOSOME_SIZE * CHROMOSOME_SIZE);
+      for (unsigned int i=0; i < CHROMOSOME_SIZE; ++i)
+	for (unsigned int j=i; j < CHROMOSOME_SIZE; ++j)
+	  edge_costs[i * CHROMOSOME_SIZE + j] =
+	    edge_costs[j * CHROMOSOME_SIZE + i] = random.getDouble (0.0, 10.0);
+
+      RingEdgeSurrogateModel model (100, 0.5, 4096);
+      double initial_error = 0.0;
+      double final_error = 0.0;
+
+      for (unsigned int i=0; i < 5000; ++i)
+	{
+	  TestIndividual ring;
+	  setRandomChromosome (&ring);
+
+	  const RingIndividual::Chromosome& chromosome = ring.getChromosome ();
+	  double objective = 0.0;
+	  for (unsigned int j=0; j < CHROMOSOME_SIZE; ++j)
+	    objective += edge_costs[chromosome[j] * CHROMOSOME_SIZE +
+				    chromosome[(j + 1) % CHROMOSOME_SIZE]];
+
+	  double error = fabs (model.predict (&ring) - objective);
+	  if (i < 100)
+	    initial_error += error;
+	  else if (i >= 4900)
+	    final_error += error;
+
+	  model.train (&ring, objective);
+	}
+
+      DV ("  initial error=" << initial_error / 100 <<
+	  ", final error=" << final_error / 100);
+
+      if (!model.isTrained ())
+	throw InternalException ("Surrogate model not trained");
+
+      if (final_error > 0.1 * initial_error)
+	throw InternalException ("Surrogate model did not learn objective");
+    }
     
   } // namespace Core
 } // namespace GEP
@@ -268,6 +980,12 @@ int main (int /*argc*/, char** /*argv*/)
   {
     GEP::Core::testCrossover ();
     GEP::Core::testMutation ();
+    GEP::Core::testSuccessRule ();
+    GEP::Core::testChangeLog ();
+    GEP::Core::testLocalSearch ();
+    GEP::Core::testDiversity ();
+    GEP::Core::testHashing ();
+    GEP::Core::testSurrogate ();
   }
   catch (const GEP::InternalException& exception)
   {
@@ -7,6 +7,7 @@
 #define _DEBUG
 
 #include "GEPCoreIndividual.hpp"
+#include "GEPCoreParetoRanking.hpp"
 #include "GEPCorePopulation.hpp"
 #include "GEPCoreSelection.hpp"
 
@@ -15,6 +16,8 @@
 #include <GEPRandom.hpp>
 
 #include <iostream>
+#include <limits>
+#include <math.h>
 #include <set>
 
 //
@@ -145,6 +148,19 @@ namespace GEP {
       std::cout << std::endl;
     }
 
+    /*
+     * Copy the individuals chosen by a selection operator
+     */
+    static void copySelected (const SelectionOperator& selection,
+			      const Population& source, Population* target)
+    {
+      std::vector<unsigned int> selected;
+      selection.select (&source, &selected);
+
+      for (unsigned int i=0; i < selected.size (); ++i)
+	target->addIndividual (source[selected[i]]->clone ());
+    }
+
     /*
      * Test selection operators
      */
@@ -164,7 +180,7 @@ namespace GEP {
 	TestPopulation target (0);
 	
 	BestSelectionOperator best;
-	best.select (&source, &target);
+	copySelected (best, source, &target);
 	
 	printPopulation ("Source", source);
 	printPopulation ("Target", target);
@@ -181,12 +197,409 @@ namespace GEP {
 	TestPopulation target (0);
 	
 	RouletteSelectionOperator roulette;
-	roulette.select (&source, &target);
+	copySelected (roulette, source, &target);
 	
 	printPopulation ("Source", source);
 	printPopulation ("Target", target);
       }
     }
+
+    /*
+     * Count how often each individual of a population with the given
+     * fitness values is selected
+     */
+    static std::vector<unsigned int> countSelections
+    (const SelectionOperator& selection, const std::vector<double>& fitness,
+     unsigned int number_of_runs)
+    {
+      TestPopulation source (0);
+      for (unsigned int i=0; i < fitness.size (); ++i)
+	source.addIndividual (new TestIndividual (i, fitness[i]));
+
+      std::vector<unsigned int> counts (fitness.size (), 0);
+
+      for (unsigned int run=0; run < number_of_runs; ++run)
+	{
+	  std::vector<unsigned int> selected;
+	  selection.select (&source, &selected);
+
+	  if (selected.size () != source.size ())
+	    throw InternalException ("Wrong number of selected individuals");
+
+	  for (unsigned int i=0; i < selected.size (); ++i)
+	    ++counts[selected[i]];
+	}
+
+      return counts;
+    }
+
+    /*
+     * Test fitness proportionate selection operators
+     */
+    static void testFitnessProportionate () throw (InternalException)
+    {
+      std::cout << "*** Testing fitness proportionate selection" << std::endl;
+      std::cout << std::endl;
+
+      const unsigned int number_of_runs = 2000;
+
+      std::vector<double> fitness;
+      for (unsigned int i=0; i < 10; ++i)
+	fitness.push_back (i % 4 == 3 ? 0.0 : (i + 1) / 10.0);
+
+      double sum = 0.0;
+      for (unsigned int i=0; i < fitness.size (); ++i)
+	sum += fitness[i];
+
+      //
+      // Roulette selection must match the probabilities on average
+      //
+      {
+	RouletteSelectionOperator roulette;
+	std::vector<unsigned int> counts =
+	  countSelections (roulette, fitness, number_of_runs);
+
+	for (unsigned int i=0; i < fitness.size (); ++i)
+	  {
+	    double expected =
+	      fitness[i] / sum * fitness.size () * number_of_runs;
+
+	    if (fabs (counts[i] - expected) > 5.0 * sqrt (expected) + 1)
+	      throw InternalException (QString ("Roulette selected %1 %2 times, "
+						"expected %3")
+				       .arg (i).arg (counts[i]).arg (expected));
+	  }
+      }
+
+      //
+      // Stochastic universal sampling must round the expected count in
+      // every single run
+      //
+      {
+	StochasticUniversalSamplingOperator sus;
+
+	for (unsigned int run=0; run < number_of_runs; ++run)
+	  {
+	    std::vector<unsigned int> counts = countSelections (sus, fitness, 1);
+
+	    for (unsigned int i=0; i < fitness.size (); ++i)
+	      {
+		double expected = fitness[i] / sum * fitness.size ();
+
+		if (counts[i] < floor (expected) || counts[i] > ceil (expected))
+		  throw InternalException (QString ("Sampling selected %1 "
+						    "%2 times, expected %3")
+					   .arg (i).arg (counts[i])
+					   .arg (expected));
+	      }
+	  }
+      }
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+    /*
+     * Test tournament selection against the analytic probabilities of
+     * binary tournaments
+     */
+    static void testTournament () throw (InternalException)
+    {
+      std::cout << "*** Testing tournament selection" << std::endl;
+      std::cout << std::endl;
+
+      const unsigned int number_of_runs = 2000;
+      const double winner_probabilities[] = { 1.0, 0.75 };
+
+      //
+      // Individual i has rank n - 1 - i
+      //
+      std::vector<double> fitness;
+      for (unsigned int i=0; i < 10; ++i)
+	fitness.push_back ((i + 1) / 10.0);
+
+      double n = fitness.size ();
+
+      for (unsigned int t=0; t < 2; ++t)
+	{
+	  double p = winner_probabilities[t];
+
+	  TournamentSelectionOperator tournament (2, p);
+	  std::vector<unsigned int> counts =
+	    countSelections (tournament, fitness, number_of_runs);
+
+	  for (unsigned int i=0; i < fitness.size (); ++i)
+	    {
+	      double better = (i + 1) * (i + 1) - i * i;
+	      double worse = (n - i) * (n - i) - (n - i - 1) * (n - i - 1);
+	      double expected = (p * better + (1.0 - p) * worse) / (n * n) *
+		n * number_of_runs;
+
+	      if (fabs (counts[i] - expected) > 5.0 * sqrt (expected) + 1)
+		throw InternalException (QString ("Tournament selected %1 %2 "
+						  "times, expected %3")
+					 .arg (i).arg (counts[i])
+					 .arg (expected));
+	    }
+	}
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+    /*
+     * Test rank based selection against the expected rank probabilities
+     */
+    static void testRank () throw (InternalException)
+    {
+      std::cout << "*** Testing rank selection" << std::endl;
+      std::cout << std::endl;
+
+      const unsigned int number_of_runs = 2000;
+
+      //
+      // Individual i has rank n - 1 - i. The fitness values are far from
+      // linear to make sure only the order counts.
+      //
+      std::vector<double> fitness;
+      for (unsigned int i=0; i < 10; ++i)
+	fitness.push_back (pow (0.5, 10.0 - i));
+
+      double n = fitness.size ();
+
+      LinearRankSelectionOperator linear (1.8);
+      ExponentialRankSelectionOperator exponential (0.7);
+
+      std::vector<unsigned int> linear_counts =
+	countSelections (linear, fitness, number_of_runs);
+      std::vector<unsigned int> exponential_counts =
+	countSelections (exponential, fitness, number_of_runs);
+
+      double exponential_sum = (1.0 - pow (0.7, n)) / (1.0 - 0.7);
+
+      for (unsigned int i=0; i < fitness.size (); ++i)
+	{
+	  double rank = n - 1 - i;
+
+	  double expected[2];
+	  expected[0] = (2.0 - 1.8 + 2.0 * 0.8 * (n - 1 - rank) / (n - 1)) / n;
+	  expected[1] = pow (0.7, rank) / exponential_sum;
+
+	  unsigned int counts[2] = { linear_counts[i], exponential_counts[i] };
+
+	  for (unsigned int j=0; j < 2; ++j)
+	    {
+	      double mean = expected[j] * n * number_of_runs;
+	      if (fabs (counts[j] - mean) > 5.0 * sqrt (mean) + 1)
+		throw InternalException (QString ("Rank selection selected %1 "
+						  "%2 times, expected %3")
+					 .arg (i).arg (counts[j]).arg (mean));
+	    }
+	}
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+    /*
+     * Test truncation selection on a large population
+     */
+    static void testTruncation () throw (InternalException)
+    {
+      std::cout << "*** Testing truncation selection" << std::endl;
+      std::cout << std::endl;
+
+      const unsigned int n = 10007;
+
+      //
+      // Individual i has the i-th lowest fitness
+      //
+      std::vector<double> fitness;
+      for (unsigned int i=0; i < n; ++i)
+	fitness.push_back (static_cast<double> (i) / n);
+
+      BestSelectionOperator best;
+      TruncationSelectionOperator truncation (0.3);
+      ParallelTruncationSelectionOperator parallel (0.3, 4);
+
+      const SelectionOperator* operators[] = { &best, &truncation, &parallel };
+      const unsigned int minimum_ids[] = { n - n / 2 - 1, n - 3003, n - 3003 };
+
+      for (unsigned int i=0; i < 3; ++i)
+	{
+	  std::vector<unsigned int> counts =
+	    countSelections (*operators[i], fitness, 1);
+
+	  for (unsigned int id=0; id < minimum_ids[i]; ++id)
+	    if (counts[id] > 0)
+	      throw InternalException (QString ("%1 selected individual %2")
+				       .arg (operators[i]->getDescription ())
+				       .arg (id));
+	}
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+    /*
+     * Test lexicase selection
+     *
+     * Each specialist has the lowest error on exactly one case, so every
+     * specialist must be selected sometimes, while the generalist is
+     * dominated on all cases and must never be selected.
+     */
+    static void testLexicase () throw (InternalException)
+    {
+      std::cout << "*** Testing lexicase selection" << std::endl;
+      std::cout << std::endl;
+
+      const unsigned int cases = 4;
+      const unsigned int runs = 200;
+
+      TestPopulation population (0);
+
+      for (unsigned int i=0; i < 2 * cases + 1; ++i)
+	{
+	  std::vector<double> errors (cases, 10.0 + (i % cases));
+	  if (i < cases)
+	    errors[i] = 1.0 + 0.01 * i;
+	  else if (i == 2 * cases)
+	    errors = std::vector<double> (cases, 12.0);
+
+	  TestIndividual* individual = new TestIndividual (i, 0.5);
+	  individual->setObjectives (errors);
+	  population.addIndividual (individual);
+	}
+
+      LexicaseSelectionOperator lexicase (2);
+      EpsilonLexicaseSelectionOperator epsilon_lexicase (2);
+
+      const SelectionOperator* operators[] = { &lexicase, &epsilon_lexicase };
+
+      for (unsigned int o=0; o < 2; ++o)
+	{
+	  std::vector<unsigned int> counts (population.size (), 0);
+
+	  for (unsigned int run=0; run < runs; ++run)
+	    {
+	      std::vector<unsigned int> selected;
+	      operators[o]->select (&population, &selected);
+
+	      if (selected.size () != population.size ())
+		throw InternalException ("Wrong number of selected individuals");
+
+	      for (unsigned int i=0; i < selected.size (); ++i)
+		++counts[selected[i]];
+	    }
+
+	  for (unsigned int i=0; i < cases; ++i)
+	    if (counts[i] == 0)
+	      throw InternalException ("Specialist never selected");
+
+	  if (counts[2 * cases] != 0)
+	    throw InternalException ("Dominated individual selected");
+	}
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
+
+    /*
+     * Compute Pareto front ranks by repeatedly peeling off the
+     * non-dominated individuals
+     */
+    static std::vector<unsigned int> computeNaiveRanks
+    (const Population& population)
+    {
+      std::vector<unsigned int> ranks (population.size (),
+				       std::numeric_limits<unsigned int>::max ());
+      unsigned int remaining = population.size ();
+
+      for (unsigned int rank=0; remaining > 0; ++rank)
+	{
+	  std::vector<unsigned int> front;
+
+	  for (unsigned int i=0; i < population.size (); ++i)
+	    {
+	      if (ranks[i] < rank)
+		continue;
+
+	      bool dominated = false;
+	      for (unsigned int j=0; j < population.size () && !dominated; ++j)
+		dominated = ranks[j] >= rank &&
+		  ParetoRanking::dominates (population[j], population[i]);
+
+	      if (!dominated)
+		front.push_back (i);
+	    }
+
+	  for (unsigned int i=0; i < front.size (); ++i)
+	    ranks[front[i]] = rank;
+
+	  remaining -= front.size ();
+	}
+
+      return ranks;
+    }
+
+    /*
+     * Test non-dominated sorting and NSGA-II selection
+     */
+    static void testParetoRanking () throw (InternalException)
+    {
+      std::cout << "*** Testing Pareto ranking" << std::endl;
+      std::cout << std::endl;
+
+      Random random;
+
+      for (unsigned int objectives=2; objectives <= 3; ++objectives)
+	for (unsigned int run=0; run < 20; ++run)
+	  {
+	    //
+	    // Small integer objective values produce many ties
+	    //
+	    TestPopulation population (0);
+	    unsigned int size = random.getInt (1, 200);
+
+	    for (unsigned int i=0; i < size; ++i)
+	      {
+		std::vector<double> values;
+		for (unsigned int j=0; j < objectives; ++j)
+		  values.push_back (random.getInt (0, 20));
+
+		TestIndividual* individual = new TestIndividual (i, 0.5);
+		individual->setObjectives (values);
+		population.addIndividual (individual);
+	      }
+
+	    ParetoRanking ranking;
+	    ranking.compute (&population);
+
+	    std::vector<unsigned int> ranks = computeNaiveRanks (population);
+
+	    for (unsigned int i=0; i < size; ++i)
+	      {
+		if (ranking.getRank (i) != ranks[i])
+		  throw InternalException ("Pareto rank mismatch");
+
+		if (ranking.getCrowdingDistance (i) < 0.0)
+		  throw InternalException ("Negative crowding distance");
+	      }
+
+	    //
+	    // Selection must prefer the better fronts
+	    //
+	    std::vector<unsigned int> selected;
+	    NonDominatedSortingSelectionOperator nsga;
+	    nsga.select (&population, &selected);
+
+	    if (selected.size () != population.size ())
+	      throw InternalException ("Wrong number of selected individuals");
+	  }
+
+      std::cout << "Ok" << std::endl;
+      std::cout << std::endl;
+    }
     
   } // namespace Core
 } // namespace GEP
@@ -199,6 +612,12 @@ int main (int /*argc*/, char** /*argv*/)
   try
   {
     GEP::Core::testSelection ();
+    GEP::Core::testFitnessProportionate ();
+    GEP::Core::testTournament ();
+    GEP::Core::testRank ();
+    GEP::Core::testTruncation ();
+    GEP::Core::testLexicase ();
+    GEP::Core::testParetoRanking ();
   }
   catch (const GEP::InternalException& exception)
   {
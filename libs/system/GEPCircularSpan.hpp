@@ -0,0 +1,193 @@
+/*
+ * GEPCircularSpan.hpp - View onto a wrapped sequence of a cyclic array
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPCircularSpan_hpp__
+#define __GEPCircularSpan_hpp__
+
+#include "GEPException.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace GEP {
+
+  /*
+   * View onto a sequence of an array treated as a ring
+   *
+   * A sequence starting at some position may wrap around the array end. The
+   * span splits it into at most two contiguous runs, so the elements can be
+   * processed by plain loops or block copies instead of modulo indexing.
+   * The span does not own or copy the elements. Use 'const T' as element
+   * type for read only access.
+   */
+  template <class T>
+  class CircularSpan
+  {
+  public:
+    CircularSpan (T* data, unsigned int size,
+		  unsigned int position, unsigned int length);
+
+    inline unsigned int size () const;
+    inline T& operator[] (unsigned int index) const;
+
+    inline T* getFirst () const;
+    inline unsigned int getFirstLength () const;
+    inline T* getSecond () const;
+    inline unsigned int getSecondLength () const;
+
+    template <class U>
+    void copyTo (U* target) const;
+
+    template <class U>
+    void copyTo (const CircularSpan<U>& target) const;
+
+  private:
+    T* _first;
+    unsigned int _first_length;
+    T* _second;
+    unsigned int _second_length;
+  };
+
+  /*
+   * Constructor
+   *
+   * \param data     First array element
+   * \param size     Array size
+   * \param position Start position of the sequence, may exceed the array
+   *                 size and is taken modulo the size then
+   * \param length   Sequence length, not larger than the array size
+   */
+  template <class T>
+  CircularSpan<T>::CircularSpan (T* data, unsigned int size,
+				 unsigned int position, unsigned int length)
+  {
+    if (length > size)
+      throw InternalException ("Sequence exceeds ring size");
+
+    if (size > 0)
+      position %= size;
+
+    _first = data + position;
+    _first_length = std::min (length, size - position);
+    _second = data;
+    _second_length = length - _first_length;
+  }
+
+  /* Return the number of elements */
+  template <class T>
+  inline unsigned int CircularSpan<T>::size () const
+  {
+    return _first_length + _second_length;
+  }
+
+  /* Access element by its index within the sequence */
+  template <class T>
+  inline T& CircularSpan<T>::operator[] (unsigned int index) const
+  {
+    return index < _first_length ?
+      _first[index] : _second[index - _first_length];
+  }
+
+  /* Return the first run of elements up to the array end */
+  template <class T>
+  inline T* CircularSpan<T>::getFirst () const
+  {
+    return _first;
+  }
+
+  /* Return the length of the first run */
+  template <class T>
+  inline unsigned int CircularSpan<T>::getFirstLength () const
+  {
+    return _first_length;
+  }
+
+  /* Return the second run of elements wrapped to the array start */
+  template <class T>
+  inline T* CircularSpan<T>::getSecond () const
+  {
+    return _second;
+  }
+
+  /* Return the length of the second run, 0 if the sequence does not wrap */
+  template <class T>
+  inline unsigned int CircularSpan<T>::getSecondLength () const
+  {
+    return _second_length;
+  }
+
+  /*
+   * Copy the elements into a contiguous array
+   *
+   * The target must not overlap with the sequence.
+   */
+  template <class T>
+  template <class U>
+  void CircularSpan<T>::copyTo (U* target) const
+  {
+    std::copy (_first, _first + _first_length, target);
+    std::copy (_second, _second + _second_length, target + _first_length);
+  }
+
+  /*
+   * Copy the elements into another span of the same size
+   *
+   * The runs of both spans may be split at different indices, so the copy
+   * consists of up to three block copies.
+   */
+  template <class T>
+  template <class U>
+  void CircularSpan<T>::copyTo (const CircularSpan<U>& target) const
+  {
+    if (target.size () != size ())
+      throw InternalException ("Span sizes differ");
+
+    unsigned int split = target.getFirstLength ();
+
+    if (split <= _first_length)
+      {
+	std::copy (_first, _first + split, target.getFirst ());
+	std::copy (_first + split, _first + _first_length,
+		   target.getSecond ());
+	std::copy (_second, _second + _second_length,
+		   target.getSecond () + (_first_length - split));
+      }
+    else
+      {
+	std::copy (_first, _first + _first_length, target.getFirst ());
+	std::copy (_second, _second + (split - _first_length),
+		   target.getFirst () + _first_length);
+	std::copy (_second + (split - _first_length),
+		   _second + _second_length, target.getSecond ());
+      }
+  }
+
+  /*
+   * Create a span onto a vector
+   */
+  template <class T>
+  CircularSpan<T> makeCircularSpan (std::vector<T>& values,
+				    unsigned int position, unsigned int length)
+  {
+    return CircularSpan<T> (values.empty () ? 0 : &values[0], values.size (),
+			    position, length);
+  }
+
+  /*
+   * Create a read only span onto a vector
+   */
+  template <class T>
+  CircularSpan<const T> makeCircularSpan (const std::vector<T>& values,
+					  unsigned int position,
+					  unsigned int length)
+  {
+    return CircularSpan<const T> (values.empty () ? 0 : &values[0],
+				  values.size (), position, length);
+  }
+
+} // namespace GEP
+
+#endif
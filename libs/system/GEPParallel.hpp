@@ -0,0 +1,49 @@
+/*
+ * GEPParallel.hpp - Parallel execution of tasks over index ranges
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#ifndef __GEPParallel_hpp__
+#define __GEPParallel_hpp__
+
+namespace GEP {
+
+  /*
+   * Base class for tasks which can be split into independent index ranges
+   */
+  class ParallelTask
+  {
+  public:
+    ParallelTask ();
+    virtual ~ParallelTask ();
+
+    virtual void execute (unsigned int chunk, unsigned int begin,
+			  unsigned int end) = 0;
+  };
+
+  /*
+   * Executes tasks in parallel threads
+   *
+   * The index range is split into consecutive chunks of nearly equal size,
+   * each processed by its own thread. The first chunk is processed by the
+   * calling thread, the others by worker threads which are started once and
+   * reused by later calls, so per thread caches of the tasks are kept
+   * between calls. Exceptions thrown by a chunk are passed on to the
+   * caller after all threads finished.
+   */
+  class Parallel
+  {
+  public:
+    static unsigned int getNumberOfThreads ();
+
+    static void execute (ParallelTask* task, unsigned int size,
+			 unsigned int number_of_chunks=0);
+
+    static unsigned int getChunkBegin (unsigned int chunk, unsigned int size,
+				       unsigned int number_of_chunks);
+  };
+
+} // namespace GEP
+
+#endif
@@ -7,8 +7,8 @@
 #ifndef __GEPRandom_hpp__
 #define __GEPRandom_hpp__
 
+#include "GEPCircularSpan.hpp"
 #include "GEPException.hpp"
-#include "GEPRingBuffer.hpp"
 
 #include <vector>
 #include <boost/random/mersenne_twister.hpp>
@@ -21,9 +21,16 @@ namespace GEP {
   {
   public:
     Random ();
+    explicit Random (unsigned int seed);
 
     int getInt (int min, int max) const;
     double getDouble (double min, double max) const;
+    double getGaussian (double mean, double sigma) const;
+
+    void getInts (int min, int max, unsigned int count,
+		  std::vector<int>* values) const;
+    void getDoubles (double min, double max, unsigned int count,
+		     std::vector<double>* values) const;
 
     template <class T>
     T selectElement (const std::vector<T>& values);
@@ -61,8 +68,14 @@ namespace GEP {
     if (length == 0 || length > values.size ())
       length = values.size ();
 
-    RingBuffer<T> buffer (values);
-    return buffer.get (getInt (0, values.size () - 1), getInt (1, length));
+    CircularSpan<const T> span =
+      makeCircularSpan (values, getInt (0, values.size () - 1),
+			getInt (1, length));
+
+    std::vector<T> result (span.size ());
+    span.copyTo (&result[0]);
+
+    return result;
   }
   
 } // namespace GEP
@@ -7,6 +7,7 @@
 #ifndef __GEPRingBuffer_hpp__
 #define __GEPRingBuffer_hpp__
 
+#include "GEPCircularSpan.hpp"
 #include "GEPException.hpp"
 #include <vector>
 
@@ -23,6 +24,8 @@ namespace GEP {
     RingBuffer (const std::vector<T>& values);
 
     std::vector<T> get (unsigned int index, unsigned int length) const;
+    CircularSpan<const T> getSpan (unsigned int index,
+				   unsigned int length) const;
   };
 
   /* Constructor */
@@ -38,21 +41,29 @@ namespace GEP {
   {
   }
 
-  /* Get a sequence from the buffer */
+  /* Get a copy of a sequence from the buffer */
   template <class T>
   std::vector<T> RingBuffer<T>::get (unsigned int index, unsigned int length)
     const
+  {
+    CircularSpan<const T> span = getSpan (index, length);
+
+    std::vector<T> result (length);
+    span.copyTo (&result[0]);
+    
+    return result;
+  }
+
+  /* Get a view onto a sequence of the buffer */
+  template <class T>
+  CircularSpan<const T> RingBuffer<T>::getSpan (unsigned int index,
+						unsigned int length) const
   {
     if (length < 1)
       throw InternalException ("Null length not allowed in ringbuffer "
 			       "operation");
-    
-    std::vector<T> result (length);
 
-    for (unsigned int i=0; i < length; ++i)
-      result[i] = (*this)[(index + i) % this->size ()];
-    
-    return result;
+    return makeCircularSpan<T> (*this, index, length);
   }
 
 } // namespace GEP
@@ -0,0 +1,302 @@
+/*
+ * parallel.cpp - Parallel execution of tasks over index ranges
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPParallel.hpp"
+#include "GEPException.hpp"
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include <algorithm>
+#include <vector>
+
+namespace GEP {
+
+  namespace {
+
+    /*
+     * Single chunk of a task
+     */
+    class ParallelChunk
+    {
+    public:
+      ParallelChunk ()
+	: _task (0), _chunk (0), _begin (0), _end (0), _failed (false)
+      {
+      }
+
+      ParallelChunk (ParallelTask* task, unsigned int chunk,
+		     unsigned int begin, unsigned int end)
+	: _task (task), _chunk (chunk), _begin (begin), _end (end),
+	  _failed (false)
+      {
+      }
+
+      inline bool getFailed () const { return _failed; }
+      inline const QString& getMessage () const { return _message; }
+
+      /* Process the chunk in the current thread */
+      void process ()
+      {
+	try
+	  {
+	    _task->execute (_chunk, _begin, _end);
+	  }
+	catch (const Exception& exception)
+	  {
+	    _failed = true;
+	    _message = exception.getMessage ();
+	  }
+	catch (...)
+	  {
+	    _failed = true;
+	    _message = "Unknown exception in parallel task";
+	  }
+      }
+
+    private:
+      ParallelTask* _task;
+      unsigned int _chunk;
+      unsigned int _begin;
+      unsigned int _end;
+
+      bool _failed;
+      QString _message;
+    };
+
+    /*
+     * Long-lived thread processing one chunk after another
+     */
+    class ParallelWorker : public QThread
+    {
+    public:
+      ParallelWorker ()
+	: _busy (false), _stopped (false)
+      {
+      }
+
+      /* Start processing a chunk */
+      void assign (const ParallelChunk& chunk)
+      {
+	QMutexLocker locker (&_mutex);
+	_chunk = chunk;
+	_busy = true;
+	_condition.wakeAll ();
+      }
+
+      /* Wait until the assigned chunk has been processed */
+      const ParallelChunk& finish ()
+      {
+	QMutexLocker locker (&_mutex);
+	while (_busy)
+	  _condition.wait (&_mutex);
+
+	return _chunk;
+      }
+
+      /* Terminate the thread after the current chunk */
+      void stop ()
+      {
+	{
+	  QMutexLocker locker (&_mutex);
+	  _stopped = true;
+	  _condition.wakeAll ();
+	}
+
+	wait ();
+      }
+
+    protected:
+      virtual void run ()
+      {
+	_mutex.lock ();
+
+	for (;;)
+	  {
+	    while (!_busy && !_stopped)
+	      _condition.wait (&_mutex);
+
+	    if (!_busy)
+	      break;
+
+	    _mutex.unlock ();
+	    _chunk.process ();
+	    _mutex.lock ();
+
+	    _busy = false;
+	    _condition.wakeAll ();
+	  }
+
+	_mutex.unlock ();
+      }
+
+    private:
+      QMutex _mutex;
+      QWaitCondition _condition;
+
+      ParallelChunk _chunk;
+      bool _busy;
+      bool _stopped;
+    };
+
+    /*
+     * Worker threads shared by all parallel executions
+     *
+     * The pool grows to the largest number of chunks requested so far. It
+     * is locked during an execution, so concurrent or nested executions
+     * process their chunks in the calling thread instead.
+     */
+    class ParallelPool
+    {
+    public:
+      ParallelPool ()
+      {
+      }
+
+      ~ParallelPool ()
+      {
+	for (unsigned int i=0; i < _workers.size (); ++i)
+	  {
+	    _workers[i]->stop ();
+	    delete _workers[i];
+	  }
+      }
+
+      inline QMutex* getMutex () { return &_mutex; }
+
+      /* Return worker, which is started on first use */
+      ParallelWorker* getWorker (unsigned int index)
+      {
+	while (_workers.size () <= index)
+	  {
+	    _workers.push_back (new ParallelWorker ());
+	    _workers.back ()->start ();
+	  }
+
+	return _workers[index];
+      }
+
+    private:
+      QMutex _mutex;
+      std::vector<ParallelWorker*> _workers;
+    };
+
+    static ParallelPool pool;
+
+  }
+
+
+  //#*************************************************************************
+  // CLASS GEP::ParallelTask
+  //#*************************************************************************
+
+  /* Constructor */
+  ParallelTask::ParallelTask ()
+  {
+  }
+
+  /* Destructor */
+  ParallelTask::~ParallelTask ()
+  {
+  }
+
+
+  //#*************************************************************************
+  // CLASS GEP::Parallel
+  //#*************************************************************************
+
+  /* [STATIC] Return the number of threads the hardware runs in parallel */
+  unsigned int Parallel::getNumberOfThreads ()
+  {
+    return std::max (QThread::idealThreadCount (), 1);
+  }
+
+  /*
+   * [STATIC] Return the first index of a chunk
+   *
+   * The end of a chunk is the begin of the next one.
+   */
+  unsigned int Parallel::getChunkBegin (unsigned int chunk, unsigned int size,
+					unsigned int number_of_chunks)
+  {
+    return static_cast<unsigned int>
+      (static_cast<unsigned long long> (size) * chunk / number_of_chunks);
+  }
+
+  /*
+   * [STATIC] Execute a task over the index range [0, size)
+   *
+   * \param task             Task to execute
+   * \param size             Size of the index range
+   * \param number_of_chunks Number of chunks, which is the number of used
+   *                         threads, or 0 to use getNumberOfThreads ().
+   *                         Limited to the size of the range.
+   */
+  void Parallel::execute (ParallelTask* task, unsigned int size,
+			  unsigned int number_of_chunks)
+  {
+    if (number_of_chunks == 0)
+      number_of_chunks = getNumberOfThreads ();
+
+    number_of_chunks = std::min (number_of_chunks, size);
+    if (number_of_chunks == 0)
+      return;
+
+    QString message;
+    bool failed = false;
+
+    //
+    // Pool busy with another execution: process all chunks in this thread
+    //
+    if (!pool.getMutex ()->tryLock ())
+      {
+	for (unsigned int i=0; i < number_of_chunks && !failed; ++i)
+	  {
+	    ParallelChunk chunk
+	      (task, i, getChunkBegin (i, size, number_of_chunks),
+	       getChunkBegin (i + 1, size, number_of_chunks));
+	    chunk.process ();
+
+	    failed = chunk.getFailed ();
+	    message = chunk.getMessage ();
+	  }
+      }
+    else
+      {
+	for (unsigned int i=1; i < number_of_chunks; ++i)
+	  pool.getWorker (i - 1)->assign
+	    (ParallelChunk (task, i,
+			    getChunkBegin (i, size, number_of_chunks),
+			    getChunkBegin (i + 1, size, number_of_chunks)));
+
+	ParallelChunk first (task, 0, 0,
+			     getChunkBegin (1, size, number_of_chunks));
+	first.process ();
+
+	failed = first.getFailed ();
+	message = first.getMessage ();
+
+	for (unsigned int i=1; i < number_of_chunks; ++i)
+	  {
+	    const ParallelChunk& chunk = pool.getWorker (i - 1)->finish ();
+
+	    if (!failed && chunk.getFailed ())
+	      {
+		failed = true;
+		message = chunk.getMessage ();
+	      }
+	  }
+
+	pool.getMutex ()->unlock ();
+      }
+
+    if (failed)
+      throw InternalException (message);
+  }
+
+} // namespace GEP
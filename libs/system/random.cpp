@@ -10,6 +10,7 @@
 #include <sys/time.h>
 
 #include <boost/random/linear_congruential.hpp>
+#include <boost/random/normal_distribution.hpp>
 #include <boost/random/uniform_int.hpp>
 #include <boost/random/uniform_real.hpp>
 
@@ -28,6 +29,17 @@ namespace GEP {
     _generator.seed (static_cast<unsigned int> (tv.tv_usec));
   }
 
+  /*
+   * Constructor
+   *
+   * \param seed Fixed seed, for example to give each of several parallel
+   *             threads its own reproducible generator
+   */
+  Random::Random (unsigned int seed)
+  {
+    _generator.seed (seed);
+  }
+
   /* Get random integer value */
   int Random::getInt (int min, int max) const
   {
@@ -47,6 +59,53 @@ namespace GEP {
 
     return die ();
   }
+
+  /* Get normally distributed random double value */
+  double Random::getGaussian (double mean, double sigma) const
+  {
+    boost::normal_distribution<> distribution (mean, sigma);
+    boost::variate_generator<boost::mt19937&, boost::normal_distribution<> >
+      die (_generator, distribution);
+
+    return die ();
+  }
+
+  /*
+   * Get a batch of random integer values
+   *
+   * Cheaper than single calls to getInt (), since the distribution is set up
+   * only once.
+   *
+   * \param values Resized to 'count' and filled with values in [min, max]
+   */
+  void Random::getInts (int min, int max, unsigned int count,
+			std::vector<int>* values) const
+  {
+    boost::uniform_int<> range (min, max);
+    boost::variate_generator<boost::mt19937&, boost::uniform_int<> >
+      die (_generator, range);
+
+    values->resize (count);
+    for (unsigned int i=0; i < count; ++i)
+      (*values)[i] = die ();
+  }
+
+  /*
+   * Get a batch of random double values
+   *
+   * \param values Resized to 'count' and filled with values in [min, max)
+   */
+  void Random::getDoubles (double min, double max, unsigned int count,
+			   std::vector<double>* values) const
+  {
+    boost::uniform_real<> range (min, max);
+    boost::variate_generator<boost::mt19937&, boost::uniform_real<> >
+      die (_generator, range);
+
+    values->resize (count);
+    for (unsigned int i=0; i < count; ++i)
+      (*values)[i] = die ();
+  }
   
 } // namespace GEP
 
@@ -0,0 +1,119 @@
+/*
+ * test_circular_span.cpp - Test for the circular span view
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPCircularSpan.hpp"
+#include "GEPRandom.hpp"
+#include "GEPRingBuffer.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace GEP {
+
+  //
+  // Size of the test array
+  //
+  static const unsigned int SIZE = 17;
+
+  /*
+   * Check all spans against modulo indexing
+   */
+  static void testCircularSpan () throw (InternalException)
+  {
+    std::cout << "*** Testing circular span" << std::endl;
+    std::cout << std::endl;
+
+    RingBuffer<int> buffer;
+    for (unsigned int i=0; i < SIZE; ++i)
+      buffer.push_back (i);
+
+    const std::vector<int>& values = buffer;
+
+    for (unsigned int position=0; position < 2 * SIZE; ++position)
+      for (unsigned int length=0; length <= SIZE; ++length)
+	{
+	  CircularSpan<const int> span =
+	    makeCircularSpan (values, position, length);
+
+	  if (span.size () != length ||
+	      span.getFirstLength () + span.getSecondLength () != length)
+	    throw InternalException ("Wrong span size");
+
+	  for (unsigned int i=0; i < length; ++i)
+	    if (span[i] != buffer[(position + i) % SIZE])
+	      throw InternalException ("Wrong span element");
+
+	  if (length == 0)
+	    continue;
+
+	  std::vector<int> sequence = buffer.get (position, length);
+
+	  for (unsigned int i=0; i < length; ++i)
+	    if (sequence.size () != length || sequence[i] != span[i])
+	      throw InternalException ("Wrong ring buffer sequence");
+
+	  //
+	  // Copy between spans with different split points
+	  //
+	  for (unsigned int target_position=0; target_position < SIZE;
+	       ++target_position)
+	    {
+	      std::vector<int> target (SIZE, -1);
+	      span.copyTo (makeCircularSpan (target, target_position, length));
+
+	      for (unsigned int i=0; i < SIZE; ++i)
+		{
+		  unsigned int offset = (i + SIZE - target_position) % SIZE;
+		  int expected =
+		    offset < length ? buffer[(position + offset) % SIZE] : -1;
+
+		  if (target[i] != expected)
+		    throw InternalException ("Wrong span copy");
+		}
+	    }
+	}
+
+    //
+    // Random sequences are contiguous ring sequences
+    //
+    Random random;
+
+    for (unsigned int run=0; run < 1000; ++run)
+      {
+	std::vector<int> sequence = random.selectSequence<int> (buffer, 5);
+
+	if (sequence.empty () || sequence.size () > 5)
+	  throw InternalException ("Wrong random sequence length");
+
+	for (unsigned int i=1; i < sequence.size (); ++i)
+	  if (sequence[i] != static_cast<int> ((sequence[i - 1] + 1) % SIZE))
+	    throw InternalException ("Random sequence not contiguous");
+      }
+
+    std::cout << "Ok" << std::endl;
+    std::cout << std::endl;
+  }
+
+} // namespace GEP
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+  bool ok = true;
+
+  try
+  {
+    GEP::testCircularSpan ();
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+/*
+ * test_parallel.cpp - Test for the parallel task execution
+ *
+ * Frank Cieslok, 19.10.2026
+ */
+
+#include "GEPParallel.hpp"
+#include "GEPException.hpp"
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadStorage>
+
+#include <iostream>
+#include <vector>
+
+namespace GEP {
+
+  //
+  // Number of chunks the tasks are split into
+  //
+  static const unsigned int NUMBER_OF_CHUNKS = 4;
+
+  //
+  // Number of repeated executions
+  //
+  static const unsigned int NUMBER_OF_RUNS = 200;
+
+  //#*************************************************************************
+  // CLASS GEP::CountTask
+  //#*************************************************************************
+
+  /*
+   * Task counting the visits of each index and the threads it ran in
+   */
+  class CountTask : public ParallelTask
+  {
+  public:
+    CountTask (unsigned int size);
+    virtual ~CountTask ();
+
+    virtual void execute (unsigned int chunk, unsigned int begin,
+			  unsigned int end);
+
+    inline const std::vector<unsigned int>& getVisits () const
+    { return _visits; }
+
+    static unsigned int getNumberOfThreads ();
+
+  private:
+    std::vector<unsigned int> _visits;
+
+    static QThreadStorage<int*> _thread_marks;
+    static QMutex _mutex;
+    static unsigned int _number_of_threads;
+  };
+
+  QThreadStorage<int*> CountTask::_thread_marks;
+  QMutex CountTask::_mutex;
+  unsigned int CountTask::_number_of_threads = 0;
+
+  /* Constructor */
+  CountTask::CountTask (unsigned int size)
+    : _visits (size, 0)
+  {
+  }
+
+  /* Destructor */
+  CountTask::~CountTask ()
+  {
+  }
+
+  /* Visit the indices of a chunk */
+  void CountTask::execute (unsigned int /*chunk*/, unsigned int begin,
+			   unsigned int end)
+  {
+    if (!_thread_marks.hasLocalData ())
+      {
+	_thread_marks.setLocalData (new int (0));
+
+	QMutexLocker locker (&_mutex);
+	++_number_of_threads;
+      }
+
+    for (unsigned int i=begin; i < end; ++i)
+      ++_visits[i];
+  }
+
+  /* [STATIC] Return the number of threads the task ever ran in */
+  unsigned int CountTask::getNumberOfThreads ()
+  {
+    QMutexLocker locker (&_mutex);
+    return _number_of_threads;
+  }
+
+
+  //#*************************************************************************
+  // CLASS GEP::FailingTask
+  //#*************************************************************************
+
+  /*
+   * Task failing in a single chunk, optionally executing nested tasks
+   */
+  class FailingTask : public ParallelTask
+  {
+  public:
+    FailingTask (unsigned int failing_chunk, bool nested);
+    virtual ~FailingTask ();
+
+    virtual void execute (unsigned int chunk, unsigned int begin,
+			  unsigned int end);
+
+  private:
+    unsigned int _failing_chunk;
+    bool _nested;
+  };
+
+  /* Constructor */
+  FailingTask::FailingTask (unsigned int failing_chunk, bool nested)
+    : _failing_chunk (failing_chunk),
+      _nested        (nested)
+  {
+  }
+
+  /* Destructor */
+  FailingTask::~FailingTask ()
+  {
+  }
+
+  /* Fail in the configured chunk */
+  void FailingTask::execute (unsigned int chunk, unsigned int /*begin*/,
+			     unsigned int /*end*/)
+  {
+    if (_nested)
+      {
+	CountTask task (100);
+	Parallel::execute (&task, 100, NUMBER_OF_CHUNKS);
+
+	for (unsigned int i=0; i < task.getVisits ().size (); ++i)
+	  if (task.getVisits ()[i] != 1)
+	    throw InternalException ("Nested task index not visited once");
+      }
+
+    if (chunk == _failing_chunk)
+      throw InternalException ("Expected failure");
+  }
+
+
+  //#*************************************************************************
+  // Test functions
+  //#*************************************************************************
+
+  /*
+   * Check that each index is visited once and the threads are reused
+   */
+  static void testExecution () throw (InternalException)
+  {
+    std::cout << "*** Testing parallel execution" << std::endl;
+    std::cout << std::endl;
+
+    for (unsigned int run=0; run < NUMBER_OF_RUNS; ++run)
+      {
+	unsigned int size = run % 17;
+
+	CountTask task (size);
+	Parallel::execute (&task, size, NUMBER_OF_CHUNKS);
+
+	for (unsigned int i=0; i < size; ++i)
+	  if (task.getVisits ()[i] != 1)
+	    throw InternalException ("Index not visited once");
+      }
+
+    if (CountTask::getNumberOfThreads () > NUMBER_OF_CHUNKS)
+      throw InternalException ("Worker threads not reused");
+
+    std::cout << "Ok" << std::endl;
+    std::cout << std::endl;
+  }
+
+  /*
+   * Check that failures and nested executions are passed on
+   */
+  static void testFailures () throw (InternalException)
+  {
+    std::cout << "*** Testing parallel failures" << std::endl;
+    std::cout << std::endl;
+
+    for (unsigned int run=0; run < 2 * NUMBER_OF_CHUNKS; ++run)
+      {
+	FailingTask task (run % NUMBER_OF_CHUNKS, run >= NUMBER_OF_CHUNKS);
+	bool failed = false;
+
+	try
+	  {
+	    Parallel::execute (&task, 100, NUMBER_OF_CHUNKS);
+	  }
+	catch (const InternalException& exception)
+	  {
+	    if (exception.getMessage () != "Expected failure")
+	      throw;
+
+	    failed = true;
+	  }
+
+	if (!failed)
+	  throw InternalException ("Failure not passed on");
+      }
+
+    //
+    // The pool is still usable after the failures
+    //
+    CountTask task (100);
+    Parallel::execute (&task, 100, NUMBER_OF_CHUNKS);
+
+    for (unsigned int i=0; i < 100; ++i)
+      if (task.getVisits ()[i] != 1)
+	throw InternalException ("Index not visited once after failure");
+
+    std::cout << "Ok" << std::endl;
+    std::cout << std::endl;
+  }
+
+} // namespace GEP
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+  bool ok = true;
+
+  try
+  {
+    GEP::testExecution ();
+    GEP::testFailures ();
+  }
+  catch (const GEP::InternalException& exception)
+  {
+    std::cerr << "ERROR: " << qPrintable (exception.getMessage ())
+	      << std::endl;
+    ok = false;
+  }
+
+  return ok ? 0 : 1;
+}